@@ -1003,6 +1003,9 @@ bool CApplication::Initialize()
   // initialize (and update as needed) our databases
   CDatabaseManager &databaseManager = m_ServiceManager->GetDatabaseManager();
 
+  // pick the job manager backend before the first job is queued
+  CJobManager::GetInstance().SetWorkStealing(g_advancedSettings.m_jobManagerWorkStealing);
+
   CEvent event(true);
   CJobManager::GetInstance().Submit([&databaseManager, &event]() {
     databaseManager.Initialize();
@@ -19,6 +19,10 @@
  */
 
 #include "DatabaseManager.h"
+
+#include <algorithm>
+
+#include "dbwrappers/dataset.h"
 #include "utils/log.h"
 #include "addons/AddonDatabase.h"
 #include "view/ViewDatabase.h"
@@ -32,6 +36,31 @@
 
 using namespace PVR;
 
+// idle connections kept open per database, enough for the GUI, a scan and
+// a few JSON-RPC requests to each have one at hand
+static const size_t MAX_IDLE_CONNECTIONS = 4;
+
+void CDatabaseWriteLock::Lock()
+{
+  CSingleLock lock(m_section);
+  const std::thread::id self = std::this_thread::get_id();
+  while (m_count > 0 && m_owner != self)
+    m_released.wait(lock);
+
+  m_owner = self;
+  m_count++;
+}
+
+void CDatabaseWriteLock::Unlock()
+{
+  CSingleLock lock(m_section);
+  if (m_count == 0 || --m_count > 0)
+    return;
+
+  m_owner = std::thread::id();
+  m_released.notifyAll();
+}
+
 CDatabaseManager::CDatabaseManager() :
   m_bIsUpgrading(false)
 {
@@ -40,10 +69,16 @@ CDatabaseManager::CDatabaseManager() :
   UpdateDatabase(db);
 }
 
-CDatabaseManager::~CDatabaseManager() = default;
+CDatabaseManager::~CDatabaseManager()
+{
+  ClearConnections();
+}
 
 void CDatabaseManager::Initialize()
 {
+  // the databases may change underneath connections opened before
+  ClearConnections();
+
   CSingleLock lock(m_section);
 
   m_dbStatus.clear();
@@ -152,6 +187,82 @@ bool CDatabaseManager::Update(CDatabase &db, const DatabaseSettings &settings)
   return false;
 }
 
+std::unique_ptr<dbiplus::Database> CDatabaseManager::AcquireConnection(const std::string &key)
+{
+  CSingleLock lock(m_poolSection);
+  auto it = m_connections.find(key);
+  if (it == m_connections.end() || it->second.empty())
+    return nullptr;
+
+  std::unique_ptr<dbiplus::Database> connection = std::move(it->second.back());
+  it->second.pop_back();
+  return connection;
+}
+
+void CDatabaseManager::ReleaseConnection(const std::string &key, std::unique_ptr<dbiplus::Database> connection)
+{
+  {
+    CSingleLock lock(m_poolSection);
+    std::vector<std::unique_ptr<dbiplus::Database>> &idle = m_connections[key];
+    if (idle.size() < MAX_IDLE_CONNECTIONS)
+    {
+      idle.push_back(std::move(connection));
+      return;
+    }
+  }
+  // the pool is full, close it outside of the lock
+  connection->disconnect();
+}
+
+void CDatabaseManager::ClearConnections()
+{
+  std::map<std::string, std::vector<std::unique_ptr<dbiplus::Database>>> connections;
+  {
+    CSingleLock lock(m_poolSection);
+    connections.swap(m_connections);
+  }
+  for (auto &idle : connections)
+  {
+    for (auto &connection : idle.second)
+      connection->disconnect();
+  }
+}
+
+CDatabaseWriteLock& CDatabaseManager::GetWriteLock(const std::string &key)
+{
+  CSingleLock lock(m_poolSection);
+  return m_writeLocks[key];
+}
+
+void CDatabaseManager::OnTablesChanged(const std::string &key, const std::set<std::string> &tables)
+{
+  CSingleLock lock(m_versionSection);
+  uint64_t version = ++m_lastVersion;
+  std::map<std::string, uint64_t> &versions = m_tableVersions[key];
+  for (const auto &table : tables)
+    versions[table] = version;
+}
+
+uint64_t CDatabaseManager::GetChangeVersion(const std::string &key, const std::vector<std::string> &tables)
+{
+  CSingleLock lock(m_versionSection);
+  std::map<std::string, uint64_t> &versions = m_tableVersions[key];
+
+  // a database seen for the first time starts out at a version of its own
+  uint64_t &anyTable = versions["*"];
+  if (!anyTable)
+    anyTable = ++m_lastVersion;
+
+  uint64_t version = anyTable;
+  for (const auto &table : tables)
+  {
+    std::map<std::string, uint64_t>::const_iterator it = versions.find(table);
+    if (it != versions.end())
+      version = std::max(version, it->second);
+  }
+  return version;
+}
+
 bool CDatabaseManager::UpdateVersion(CDatabase &db, const std::string &dbName)
 {
   int version = db.GetDBVersion();
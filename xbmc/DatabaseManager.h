@@ -22,12 +22,48 @@
 
 #include <atomic>
 #include <map>
+#include <memory>
+#include <set>
+#include <stdint.h>
 #include <string>
+#include <thread>
+#include <vector>
+#include "threads/Condition.h"
 #include "threads/CriticalSection.h"
 
 class CDatabase;
 class DatabaseSettings;
 
+namespace dbiplus
+{
+  class Database;
+}
+
+/*!
+ \ingroup database
+ \brief Lock serializing the writes to a database.
+
+ Unlike a CCriticalSection it isn't owned by the thread that took it: a transaction
+ may be rolled back by another thread than the one that began it, e.g. when the
+ database is closed. The thread holding the lock may take it again.
+ */
+class CDatabaseWriteLock
+{
+public:
+  CDatabaseWriteLock() = default;
+  CDatabaseWriteLock(const CDatabaseWriteLock&) = delete;
+  CDatabaseWriteLock& operator=(const CDatabaseWriteLock&) = delete;
+
+  void Lock();
+  void Unlock();
+
+private:
+  CCriticalSection m_section;
+  XbmcThreads::ConditionVariable m_released;
+  std::thread::id m_owner; ///< thread that took the lock last
+  unsigned int m_count = 0; ///< number of times the lock is held
+};
+
 /*!
  \ingroup database
  \brief Database manager class for handling database updating
@@ -35,6 +71,13 @@ class DatabaseSettings;
  Ensures that databases used in XBMC are up to date, and if a database can't be
  opened, ensures we don't continuously try it.
 
+ Also keeps a pool of idle connections, so that opening a database reuses a
+ connection rather than setting up a new one, and serializes the transactions
+ writing to a database while reads carry on alongside them.
+
+ Writes committed through pooled connections are counted per table, so that
+ results read from a database can be kept until the tables they came from change.
+
  */
 class CDatabaseManager
 {
@@ -62,6 +105,42 @@ public:
 
   bool IsUpgrading() const { return m_bIsUpgrading; }
 
+  /*! \brief Take an idle connection to a database from the pool.
+   \param key identifies the database and the server it is on.
+   \return the connection, or nullptr if there is no idle one.
+   */
+  std::unique_ptr<dbiplus::Database> AcquireConnection(const std::string &key);
+
+  /*! \brief Hand a connection that is no longer used back to the pool.
+   The connection is closed if enough connections to the database are idle already.
+   \param key identifies the database and the server it is on.
+   \param connection the open connection, outside of any transaction.
+   */
+  void ReleaseConnection(const std::string &key, std::unique_ptr<dbiplus::Database> connection);
+
+  /*! \brief Close all idle connections.
+   */
+  void ClearConnections();
+
+  /*! \brief Get the lock held while writing to a database.
+   \param key identifies the database and the server it is on.
+   */
+  CDatabaseWriteLock& GetWriteLock(const std::string &key);
+
+  /*! \brief Note that tables of a database were written to.
+   \param key identifies the database and the server it is on.
+   \param tables lower case names of the tables, "*" for any table.
+   */
+  void OnTablesChanged(const std::string &key, const std::set<std::string> &tables);
+
+  /*! \brief Get a version of a database that changes whenever one of the given tables is written to.
+   Versions are never handed out twice, not even for different databases.
+   \param key identifies the database and the server it is on.
+   \param tables lower case names of the tables.
+   \return the version, which is never 0.
+   */
+  uint64_t GetChangeVersion(const std::string &key, const std::vector<std::string> &tables);
+
 private:
   std::atomic<bool> m_bIsUpgrading;
 
@@ -73,4 +152,12 @@ private:
 
   CCriticalSection            m_section;     ///< Critical section protecting m_dbStatus.
   std::map<std::string, DB_STATUS> m_dbStatus;    ///< Our database status map.
+
+  CCriticalSection m_poolSection; ///< Critical section protecting m_connections and m_writeLocks.
+  std::map<std::string, std::vector<std::unique_ptr<dbiplus::Database>>> m_connections; ///< Idle connections per database.
+  std::map<std::string, CDatabaseWriteLock> m_writeLocks; ///< Write lock per database.
+
+  CCriticalSection m_versionSection; ///< Critical section protecting m_tableVersions and m_lastVersion.
+  std::map<std::string, std::map<std::string, uint64_t>> m_tableVersions; ///< Version of the last write per table of each database.
+  uint64_t m_lastVersion = 0; ///< Last version handed out.
 };
@@ -6231,6 +6231,14 @@ int CGUIInfoManager::TranslateSingleString(const std::string &strCondition, bool
   return 0;
 }
 
+bool CGUIInfoManager::IsConstantCondition(int condition) const
+{
+  condition = std::abs(condition);
+  return condition == SYSTEM_ALWAYS_TRUE ||
+         condition == SYSTEM_ALWAYS_FALSE ||
+         (condition >= SYSTEM_PLATFORM_LINUX && condition <= SYSTEM_PLATFORM_WIN10);
+}
+
 int CGUIInfoManager::TranslateListItem(const Property& cat, const Property& prop, int id, bool container)
 {
   int ret = 0;
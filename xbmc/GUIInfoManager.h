@@ -104,6 +104,12 @@ public:
   int TranslateString(const std::string &strCondition);
   int TranslateSingleString(const std::string &strCondition, bool &listItemDependent);
 
+  /*! \brief Check whether the value of a condition is fixed for the lifetime of the application
+   \param condition the condition, as returned by TranslateSingleString
+   \return true for conditions like true/false and the platform checks
+   */
+  bool IsConstantCondition(int condition) const;
+
   std::string GetLabel(int info, int contextWindow = 0, std::string *fallback = nullptr) const;
   std::string GetImage(int info, int contextWindow, std::string *fallback = nullptr);
   bool GetInt(int &value, int info, int contextWindow = 0, const CGUIListItem *item = nullptr) const;
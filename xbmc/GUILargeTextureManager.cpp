@@ -59,6 +59,20 @@ bool CImageLoader::DoWork()
 
   if (!loadPath.empty())
   {
+    // already decoded - a plain read, ready for upload
+    std::string decodedPath = m_use_cache ? CTextureCache::GetInstance().GetDecodedImage(loadPath) : "";
+    if (!decodedPath.empty())
+    {
+      m_texture = CBaseTexture::LoadFromFile(decodedPath);
+      if (m_texture)
+      {
+        if (needsChecking)
+          CTextureCache::GetInstance().BackgroundCacheImage(texturePath);
+
+        return true;
+      }
+    }
+
     // direct route - load the image
     unsigned int start = XbmcThreads::SystemClockMillis();
     m_texture = CBaseTexture::LoadFromFile(loadPath, CServiceBroker::GetWinSystem()->GetGfxContext().GetWidth(), CServiceBroker::GetWinSystem()->GetGfxContext().GetHeight());
@@ -68,6 +82,8 @@ bool CImageLoader::DoWork()
 
     if (m_texture)
     {
+      if (m_use_cache)
+        CTextureCache::GetInstance().AddDecodedImage(loadPath, m_texture);
       if (needsChecking)
         CTextureCache::GetInstance().BackgroundCacheImage(texturePath);
 
@@ -193,8 +209,8 @@ void CGUILargeTextureManager::ReleaseImage(const std::string &path, bool immedia
   }
   for (queueIterator it = m_queued.begin(); it != m_queued.end(); ++it)
   {
-    unsigned int id = it->first;
-    CLargeTexture *image = it->second;
+    unsigned int id = it->jobID;
+    CLargeTexture *image = it->image;
     if (image->GetPath() == path && image->DecrRef(true))
     {
       // cancel this job
@@ -205,8 +221,43 @@ void CGUILargeTextureManager::ReleaseImage(const std::string &path, bool immedia
   }
 }
 
+void CGUILargeTextureManager::PrefetchImage(const std::string &path, bool useCache)
+{
+  CSingleLock lock(m_listSection);
+  for (listIterator it = m_allocated.begin(); it != m_allocated.end(); ++it)
+  {
+    CLargeTexture *image = *it;
+    if (image->GetPath() == path)
+    {
+      image->AddRef();
+      return;
+    }
+  }
+
+  m_prefetched++;
+  QueueImage(path, useCache, CJob::PRIORITY_LOW);
+}
+
+void CGUILargeTextureManager::RecordFrame(unsigned int missingTiles)
+{
+  CSingleLock lock(m_listSection);
+  m_frames++;
+  if (missingTiles)
+    m_missingFrames++;
+  m_missingTiles += missingTiles;
+}
+
+void CGUILargeTextureManager::GetPrefetchStats(uint64_t &frames, uint64_t &missingFrames, uint64_t &missingTiles, uint64_t &prefetched) const
+{
+  CSingleLock lock(m_listSection);
+  frames = m_frames;
+  missingFrames = m_missingFrames;
+  missingTiles = m_missingTiles;
+  prefetched = m_prefetched;
+}
+
 // queue the image, and start the background loader if necessary
-void CGUILargeTextureManager::QueueImage(const std::string &path, bool useCache)
+void CGUILargeTextureManager::QueueImage(const std::string &path, bool useCache, CJob::PRIORITY priority)
 {
   if (path.empty())
     return;
@@ -214,18 +265,24 @@ void CGUILargeTextureManager::QueueImage(const std::string &path, bool useCache)
   CSingleLock lock(m_listSection);
   for (queueIterator it = m_queued.begin(); it != m_queued.end(); ++it)
   {
-    CLargeTexture *image = it->second;
+    CLargeTexture *image = it->image;
     if (image->GetPath() == path)
     {
       image->AddRef();
+      if (priority > it->priority)
+      { // prefetched image that's now needed - requeue it so it isn't stuck behind other prefetches
+        CJobManager::GetInstance().CancelJob(it->jobID);
+        it->jobID = CJobManager::GetInstance().AddJob(new CImageLoader(path, useCache), this, priority);
+        it->priority = priority;
+      }
       return; // already queued
     }
   }
 
   // queue the item
   CLargeTexture *image = new CLargeTexture(path);
-  unsigned int jobID = CJobManager::GetInstance().AddJob(new CImageLoader(path, useCache), this, CJob::PRIORITY_NORMAL);
-  m_queued.push_back(std::make_pair(jobID, image));
+  unsigned int jobID = CJobManager::GetInstance().AddJob(new CImageLoader(path, useCache), this, priority);
+  m_queued.push_back({jobID, image, priority});
 }
 
 void CGUILargeTextureManager::OnJobComplete(unsigned int jobID, bool success, CJob *job)
@@ -234,10 +291,10 @@ void CGUILargeTextureManager::OnJobComplete(unsigned int jobID, bool success, CJ
   CSingleLock lock(m_listSection);
   for (queueIterator it = m_queued.begin(); it != m_queued.end(); ++it)
   {
-    if (it->first == jobID)
+    if (it->jobID == jobID)
     { // found our job
       CImageLoader *loader = static_cast<CImageLoader*>(job);
-      CLargeTexture *image = it->second;
+      CLargeTexture *image = it->image;
       image->SetTexture(loader->m_texture);
       loader->m_texture = NULL; // we want to keep the texture, and jobs are auto-deleted.
       m_queued.erase(it);
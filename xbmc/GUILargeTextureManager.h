@@ -20,6 +20,7 @@
 
 #pragma once
 
+#include <stdint.h>
 #include <utility>
 #include <vector>
 
@@ -104,6 +105,36 @@ public:
    */
   void ReleaseImage(const std::string &path, bool immediately = false);
 
+  /*!
+   \brief Request a texture that is likely to be shown soon to be loaded in the background.
+
+   Works like a first GetImage() request, except that the image is loaded at a lower priority than
+   images that are being shown. A later GetImage() for the same image raises it to normal priority.
+   Each call should be balanced with a call to ReleaseImage(), which cancels the load if it's still queued.
+
+   \param path path of the image to load.
+   \param useCache whether or not to use the texture cache.
+   \sa GetImage, ReleaseImage
+   */
+  void PrefetchImage(const std::string &path, bool useCache = true);
+
+  /*!
+   \brief Record a frame of a container for the prefetch statistics.
+   \param missingTiles number of items shown in the frame without all of their images loaded.
+   \sa GetPrefetchStats
+   */
+  void RecordFrame(unsigned int missingTiles);
+
+  /*!
+   \brief Get the prefetch statistics.
+   \param frames [out] number of container frames recorded.
+   \param missingFrames [out] number of those frames that showed at least one item without its images.
+   \param missingTiles [out] total number of items shown without their images.
+   \param prefetched [out] number of images requested ahead of being shown.
+   \sa RecordFrame, PrefetchImage
+   */
+  void GetPrefetchStats(uint64_t &frames, uint64_t &missingFrames, uint64_t &missingTiles, uint64_t &prefetched) const;
+
   /*!
    \brief Cleanup images that are no longer in use.
 
@@ -139,13 +170,25 @@ private:
     unsigned int m_timeToDelete;
   };
 
-  void QueueImage(const std::string &path, bool useCache = true);
+  struct CQueuedImage
+  {
+    unsigned int jobID;
+    CLargeTexture *image;
+    CJob::PRIORITY priority;
+  };
 
-  std::vector< std::pair<unsigned int, CLargeTexture *> > m_queued;
+  void QueueImage(const std::string &path, bool useCache = true, CJob::PRIORITY priority = CJob::PRIORITY_NORMAL);
+
+  std::vector<CQueuedImage> m_queued;
   std::vector<CLargeTexture *> m_allocated;
   typedef std::vector<CLargeTexture *>::iterator listIterator;
-  typedef std::vector< std::pair<unsigned int, CLargeTexture *> >::iterator queueIterator;
+  typedef std::vector<CQueuedImage>::iterator queueIterator;
+
+  mutable CCriticalSection m_listSection;
 
-  CCriticalSection m_listSection;
+  uint64_t m_frames = 0;
+  uint64_t m_missingFrames = 0;
+  uint64_t m_missingTiles = 0;
+  uint64_t m_prefetched = 0;
 };
 
@@ -366,6 +366,8 @@ void CLangInfo::OnSettingChanged(std::shared_ptr<const CSetting> setting)
     SetTemperatureUnit(std::static_pointer_cast<const CSettingString>(setting)->GetValue());
   else if (settingId == CSettings::SETTING_LOCALE_SPEEDUNIT)
     SetSpeedUnit(std::static_pointer_cast<const CSettingString>(setting)->GetValue());
+
+  ++m_version;
 }
 
 void CLangInfo::OnSettingsLoaded()
@@ -377,6 +379,8 @@ void CLangInfo::OnSettingsLoaded()
   SetTimeFormat(CServiceBroker::GetSettings().GetString(CSettings::SETTING_LOCALE_TIMEFORMAT));
   SetTemperatureUnit(CServiceBroker::GetSettings().GetString(CSettings::SETTING_LOCALE_TEMPERATUREUNIT));
   SetSpeedUnit(CServiceBroker::GetSettings().GetString(CSettings::SETTING_LOCALE_SPEEDUNIT));
+
+  ++m_version;
 }
 
 bool CLangInfo::Load(const std::string& strLanguage)
@@ -531,6 +535,7 @@ bool CLangInfo::Load(const std::string& strLanguage)
   }
   g_charsetConverter.reinitCharsetsFromSettings();
 
+  ++m_version;
   return true;
 }
 
@@ -599,6 +604,8 @@ void CLangInfo::SetDefaults()
   m_sortTokens.clear();
 
   m_languageCodeGeneral = "eng";
+
+  ++m_version;
 }
 
 std::string CLangInfo::GetGuiCharSet() const
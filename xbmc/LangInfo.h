@@ -20,6 +20,7 @@
 
 #pragma once
 
+#include <atomic>
 #include <locale>
 #include <map>
 #include <memory>
@@ -169,6 +170,12 @@ public:
 
   std::set<std::string> GetSortTokens() const;
 
+  /*!
+   \brief Get a number that changes whenever the language or a locale setting changes.
+   Cached strings formatted with the previous locale are outdated once this changed.
+   */
+  unsigned int GetVersion() const { return m_version; }
+
   static std::string GetLanguagePath() { return "resource://"; }
   static std::string GetLanguagePath(const std::string &language);
   static std::string GetLanguageInfoPath(const std::string &language);
@@ -275,6 +282,8 @@ protected:
   std::string m_subtitleLanguage;
   // this is the general (not win32-specific) three char language code
   std::string m_languageCodeGeneral;
+
+  std::atomic<unsigned int> m_version{0};
 };
 
 
@@ -18,9 +18,19 @@
  *
  */
 
+#include <algorithm>
+#include <cinttypes>
+#include <cstring>
+#include <iterator>
+
 #include "TextureCache.h"
 #include "TextureCacheJob.h"
+#include "FileItem.h"
+#include "Util.h"
+#include "filesystem/Directory.h"
 #include "filesystem/File.h"
+#include "guilib/DDSImage.h"
+#include "guilib/Texture.h"
 #include "profiles/ProfilesManager.h"
 #include "threads/SingleLock.h"
 #include "utils/Crc32.h"
@@ -33,6 +43,8 @@
 
 using namespace XFILE;
 
+#define DECODED_PENDING_MAX (64 * 1024 * 1024)
+
 CTextureCache &CTextureCache::GetInstance()
 {
   static CTextureCache s_cache;
@@ -47,9 +59,16 @@ CTextureCache::~CTextureCache() = default;
 
 void CTextureCache::Initialize()
 {
-  CSingleLock lock(m_databaseSection);
-  if (!m_database.IsOpen())
-    m_database.Open();
+  {
+    CSingleLock lock(m_databaseSection);
+    if (!m_database.IsOpen())
+      m_database.Open();
+  }
+
+  CSingleLock lock(m_decodedSection);
+  m_decodedBudget = static_cast<uint64_t>(g_advancedSettings.m_decodedImageCacheMB) * 1024 * 1024;
+  if (m_decodedBudget && !m_decodedIndexed)
+    CJobManager::GetInstance().Submit([this]() { IndexDecodedImages(); }, CJob::PRIORITY_LOW_PAUSABLE);
 }
 
 void CTextureCache::Deinitialize()
@@ -193,6 +212,7 @@ void CTextureCache::ClearCachedImage(const std::string &url, bool deleteSource /
     path = GetCachedPath(cachedFile);
   if (CFile::Exists(path))
     CFile::Delete(path);
+  RemoveDecodedImage(path);
   path = URIUtils::ReplaceExtension(path, ".dds");
   if (CFile::Exists(path))
     CFile::Delete(path);
@@ -206,6 +226,7 @@ bool CTextureCache::ClearCachedImage(int id)
     cachedFile = GetCachedPath(cachedFile);
     if (CFile::Exists(cachedFile))
       CFile::Delete(cachedFile);
+    RemoveDecodedImage(cachedFile);
     cachedFile = URIUtils::ReplaceExtension(cachedFile, ".dds");
     if (CFile::Exists(cachedFile))
       CFile::Delete(cachedFile);
@@ -279,7 +300,12 @@ void CTextureCache::OnCachingComplete(bool success, CTextureCacheJob *job)
     if (job->m_oldHash == job->m_details.hash)
       SetCachedTextureValid(job->m_url, job->m_details.updateable);
     else
+    {
       AddCachedTexture(job->m_url, job->m_details);
+      // the image changed, so its decoded copy is stale
+      if (!job->m_oldHash.empty())
+        RemoveDecodedImage(GetCachedPath(job->m_details.file));
+    }
   }
 
   { // remove from our processing list
@@ -292,6 +318,183 @@ void CTextureCache::OnCachingComplete(bool success, CTextureCacheJob *job)
   m_completeEvent.Set();
 }
 
+bool CTextureCache::IsDecodedImagePath(const std::string &cachedImage) const
+{
+  return !cachedImage.empty() && !URIUtils::HasExtension(cachedImage, ".dds") &&
+         URIUtils::PathHasParent(cachedImage, CServiceBroker::GetProfileManager().GetThumbnailsFolder(), true) &&
+         !URIUtils::PathHasParent(cachedImage, GetDecodedFolder(), true);
+}
+
+std::string CTextureCache::GetDecodedFolder() const
+{
+  // apart from the cached images, so the .dds files of older versions next to them are left alone
+  return URIUtils::AddFileToFolder(CServiceBroker::GetProfileManager().GetThumbnailsFolder(), "decoded/");
+}
+
+std::string CTextureCache::GetDecodedPath(const std::string &cachedImage) const
+{
+  std::string thumbnails = CServiceBroker::GetProfileManager().GetThumbnailsFolder();
+  URIUtils::AddSlashAtEnd(thumbnails);
+  return URIUtils::ReplaceExtension(URIUtils::AddFileToFolder(GetDecodedFolder(), cachedImage.substr(thumbnails.size())), ".dds");
+}
+
+std::string CTextureCache::GetDecodedImage(const std::string &cachedImage)
+{
+  CSingleLock lock(m_decodedSection);
+  if (!m_decodedIndexed || !IsDecodedImagePath(cachedImage))
+    return "";
+
+  m_decodedRequests++;
+  std::string decodedImage = GetDecodedPath(cachedImage);
+  auto it = m_decodedLookup.find(decodedImage);
+  if (it == m_decodedLookup.end())
+    return "";
+
+  m_decoded.splice(m_decoded.begin(), m_decoded, it->second);
+  m_decodedHits++;
+  return decodedImage;
+}
+
+void CTextureCache::AddDecodedImage(const std::string &cachedImage, const CBaseTexture *texture)
+{
+  // only keep what can be handed to the GPU as is: the pixels of a full size, upright 32bit image
+  if (!texture || !texture->GetPixels() || texture->GetFormat() != XB_FMT_A8R8G8B8 ||
+      texture->GetOrientation() != 0 ||
+      texture->GetWidth() != texture->GetOriginalWidth() ||
+      texture->GetHeight() != texture->GetOriginalHeight())
+    return;
+
+  const uint64_t size = static_cast<uint64_t>(texture->GetWidth()) * texture->GetHeight() * 4;
+  {
+    CSingleLock lock(m_decodedSection);
+    if (!m_decodedIndexed || !IsDecodedImagePath(cachedImage))
+      return;
+    // the copies wait in memory until they are written, drop them rather than pile them up
+    if (m_decodedPending + size > DECODED_PENDING_MAX)
+      return;
+    m_decodedPending += size;
+  }
+
+  std::shared_ptr<CDDSImage> image = std::make_shared<CDDSImage>(texture->GetWidth(), texture->GetHeight(), XB_FMT_A8R8G8B8);
+  const unsigned int rowSize = texture->GetWidth() * 4;
+  const unsigned char *src = texture->GetPixels();
+  unsigned char *dst = image->GetData();
+  for (unsigned int y = 0; y < texture->GetHeight(); y++)
+  {
+    memcpy(dst, src, rowSize);
+    src += texture->GetPitch();
+    dst += rowSize;
+  }
+
+  // written in the background, so the texture isn't held up by the disk
+  CJobManager::GetInstance().Submit([this, image, cachedImage, size]() {
+    WriteDecodedImage(*image, cachedImage);
+
+    CSingleLock lock(m_decodedSection);
+    m_decodedPending -= size;
+  }, CJob::PRIORITY_LOW);
+}
+
+void CTextureCache::WriteDecodedImage(CDDSImage &image, const std::string &cachedImage)
+{
+  const std::string decodedImage = GetDecodedPath(cachedImage);
+  CUtil::CreateDirectoryEx(URIUtils::GetDirectory(decodedImage));
+  if (!image.WriteFile(decodedImage))
+  {
+    CLog::Log(LOGWARNING, "%s - unable to write %s", __FUNCTION__, decodedImage.c_str());
+    CFile::Delete(decodedImage);
+    return;
+  }
+
+  // the cached image may have been cleared while this was waiting to be written
+  if (!CFile::Exists(cachedImage))
+  {
+    CFile::Delete(decodedImage);
+    return;
+  }
+
+  CSingleLock lock(m_decodedSection);
+  uint64_t size = image.GetSize(); // the header is small enough to ignore
+  auto it = m_decodedLookup.find(decodedImage);
+  if (it != m_decodedLookup.end())
+  {
+    m_decodedSize -= it->second->second;
+    m_decoded.erase(it->second);
+    m_decodedLookup.erase(it);
+  }
+  m_decoded.emplace_front(decodedImage, size);
+  m_decodedLookup.insert(std::make_pair(decodedImage, m_decoded.begin()));
+  m_decodedSize += size;
+  TrimDecodedImages();
+}
+
+void CTextureCache::RemoveDecodedImage(const std::string &cachedImage)
+{
+  if (!IsDecodedImagePath(cachedImage))
+    return;
+
+  std::string decodedImage = GetDecodedPath(cachedImage);
+  {
+    CSingleLock lock(m_decodedSection);
+    auto it = m_decodedLookup.find(decodedImage);
+    if (it != m_decodedLookup.end())
+    {
+      m_decodedSize -= it->second->second;
+      m_decoded.erase(it->second);
+      m_decodedLookup.erase(it);
+    }
+  }
+  if (CFile::Exists(decodedImage))
+    CFile::Delete(decodedImage);
+}
+
+void CTextureCache::TrimDecodedImages()
+{
+  while (m_decodedSize > m_decodedBudget && !m_decoded.empty())
+  {
+    const DecodedList::value_type &oldest = m_decoded.back();
+    CFile::Delete(oldest.first);
+    m_decodedSize -= oldest.second;
+    m_decodedLookup.erase(oldest.first);
+    m_decoded.pop_back();
+  }
+}
+
+void CTextureCache::IndexDecodedImages()
+{
+  CFileItemList items;
+  CUtil::GetRecursiveListing(GetDecodedFolder(), items, ".dds", DIR_FLAG_NO_FILE_DIRS);
+
+  // oldest last, so they are the first to go
+  std::vector<CFileItemPtr> files(items.begin(), items.end());
+  std::sort(files.begin(), files.end(), [](const CFileItemPtr &a, const CFileItemPtr &b) {
+    return a->m_dateTime > b->m_dateTime;
+  });
+
+  CSingleLock lock(m_decodedSection);
+  for (const auto &file : files)
+  {
+    if (m_decodedLookup.find(file->GetPath()) != m_decodedLookup.end())
+      continue;
+    m_decoded.emplace_back(file->GetPath(), static_cast<uint64_t>(file->m_dwSize));
+    m_decodedLookup.insert(std::make_pair(file->GetPath(), std::prev(m_decoded.end())));
+    m_decodedSize += file->m_dwSize;
+  }
+  TrimDecodedImages();
+  m_decodedIndexed = true;
+
+  CLog::Log(LOGDEBUG, "%s - %u decoded images using %" PRIu64" bytes", __FUNCTION__,
+            static_cast<unsigned int>(m_decoded.size()), m_decodedSize);
+}
+
+void CTextureCache::GetDecodedStats(uint64_t &hits, uint64_t &requests, uint64_t &size) const
+{
+  CSingleLock lock(m_decodedSection);
+  hits = m_decodedHits;
+  requests = m_decodedRequests;
+  size = m_decodedSize;
+}
+
 void CTextureCache::OnJobComplete(unsigned int jobID, bool success, CJob *job)
 {
   if (strcmp(job->GetType(), kJobTypeCacheImage) == 0)
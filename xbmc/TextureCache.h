@@ -20,7 +20,10 @@
 
 #pragma once
 
+#include <list>
+#include <map>
 #include <set>
+#include <stdint.h>
 #include <string>
 #include <vector>
 #include "utils/JobManager.h"
@@ -29,6 +32,7 @@
 
 class CURL;
 class CBaseTexture;
+class CDDSImage;
 
 /*!
  \ingroup textures
@@ -39,6 +43,11 @@ class CBaseTexture;
  may be periodically checked for updates and may be purged from the cache if
  unused for a set period of time.
 
+ If advancedsettings.xml sets a <decodedimagecachemb> budget, the decoded pixels of
+ cached images are additionally kept as uncompressed .dds files next to the cached
+ image, so that reloading them skips the decoder. These are removed least recently
+ used first to stay within the budget.
+
  */
 class CTextureCache : public CJobQueue
 {
@@ -155,6 +164,24 @@ public:
    */
   bool Export(const std::string &image, const std::string &destination, bool overwrite);
   bool Export(const std::string &image, const std::string &destination); //! @todo BACKWARD COMPATIBILITY FOR MUSIC THUMBS
+
+  /*! \brief Find the decoded copy of a cached image
+   \param cachedImage path of the cached image, as returned by CheckCachedImage
+   \return path of the decoded copy, empty if there is none
+   \sa AddDecodedImage
+   */
+  std::string GetDecodedImage(const std::string &cachedImage);
+
+  /*! \brief Keep the decoded pixels of a cached image so it can be reloaded without decoding
+   Only unscaled 32bit textures are kept. Does nothing if the decoded tier is disabled.
+   The pixels are copied and written out by a background job, so the texture may be released right away.
+   \param cachedImage path of the cached image the texture was loaded from
+   \param texture the decoded texture, which must still hold its pixels
+   \sa GetDecodedImage
+   */
+  void AddDecodedImage(const std::string &cachedImage, const CBaseTexture *texture);
+
+  void GetDecodedStats(uint64_t &hits, uint64_t &requests, uint64_t &size) const;
 private:
   // private construction, and no assignments; use the provided singleton methods
   CTextureCache();
@@ -219,6 +246,21 @@ private:
    */
   void OnCachingComplete(bool success, CTextureCacheJob *job);
 
+  /*! \brief Delete the decoded copy of a cached image, if any
+   \param cachedImage path of the cached image
+   */
+  void RemoveDecodedImage(const std::string &cachedImage);
+
+  /*! \brief Build the index of decoded images from the thumbnails folder.
+   Run once in the background on Initialize. The decoded tier isn't used until it has finished.
+   */
+  void IndexDecodedImages();
+  void TrimDecodedImages();
+  void WriteDecodedImage(CDDSImage &image, const std::string &cachedImage);
+  bool IsDecodedImagePath(const std::string &cachedImage) const;
+  std::string GetDecodedFolder() const;
+  std::string GetDecodedPath(const std::string &cachedImage) const;
+
   CCriticalSection m_databaseSection;
   CTextureDatabase m_database;
   std::set<std::string> m_processinglist; ///< currently processing list to avoid 2 jobs being processed at once
@@ -226,5 +268,16 @@ private:
   CEvent               m_completeEvent; ///< Set whenever a job has finished
   std::vector<CTextureDetails> m_useCounts; ///< Use count tracking
   CCriticalSection             m_useCountSection;
+
+  typedef std::list<std::pair<std::string, uint64_t> > DecodedList;
+  mutable CCriticalSection m_decodedSection;
+  DecodedList m_decoded;                                ///< decoded images and their sizes, most recently used first
+  std::map<std::string, DecodedList::iterator> m_decodedLookup;
+  uint64_t m_decodedSize = 0;
+  uint64_t m_decodedBudget = 0;
+  uint64_t m_decodedPending = 0;                        ///< size of the decoded images waiting to be written
+  bool m_decodedIndexed = false;
+  uint64_t m_decodedHits = 0;
+  uint64_t m_decodedRequests = 0;
 };
 
@@ -163,6 +163,10 @@ public:
 
   void ResolveIncludes(TiXmlElement *node, std::map<INFO::InfoPtr, bool>* xmlIncludeConditions = NULL);
 
+  /*! \brief The include files the skin has loaded so far
+   */
+  const std::vector<std::string>& GetIncludeFiles() const { return m_includes.GetFiles(); }
+
   float GetEffectsSlowdown() const { return m_effectsSlowDown; };
 
   const std::vector<CStartupWindow> &GetStartupWindows() const { return m_startupWindows; };
@@ -2053,38 +2053,18 @@ bool CActiveAE::RunStages()
               nb_loops = out->pkt->nb_samples;
             }
 
-            for(int i=0; i<nb_loops; i++)
+            if (nb_loops > 1)
+            {
+              GetFrameGains(*it, out->pkt, nb_loops, fadingStep);
+              for(int j=0; j<out->pkt->planes; j++)
+                CAEUtil::MulArrayRamp((float*)out->pkt->data[j], m_frameGains.data(), nb_loops, nb_floats);
+            }
+            else
             {
-              if ((*it)->m_fadingSamples > 0)
-              {
-                (*it)->m_volume += fadingStep;
-                (*it)->m_fadingSamples--;
-
-                if ((*it)->m_fadingSamples == 0)
-                {
-                  // set variables being polled via stream interface
-                  CSingleLock lock((*it)->m_streamLock);
-                  (*it)->m_streamFading = false;
-                }
-              }
-
               // volume for stream
               float volume = (*it)->m_volume * (*it)->m_rgain;
-              if(nb_loops > 1)
-                volume *= (*it)->m_limiter.Run((float**)out->pkt->data, out->pkt->config.channels, i*nb_floats, out->pkt->planes > 1);
-
               for(int j=0; j<out->pkt->planes; j++)
-              {
-#if defined(HAVE_SSE) && defined(__SSE__)
-                CAEUtil::SSEMulArray((float*)out->pkt->data[j]+i*nb_floats, volume, nb_floats);
-#else
-                float* fbuffer = (float*) out->pkt->data[j]+i*nb_floats;
-                for (int k = 0; k < nb_floats; ++k)
-                {
-                  fbuffer[k] *= volume;
-                }
-#endif
-              }
+                CAEUtil::MulArray((float*)out->pkt->data[j], volume, nb_floats);
             }
           }
           else
@@ -2120,48 +2100,24 @@ bool CActiveAE::RunStages()
               nb_loops = out->pkt->nb_samples;
             }
 
-            for(int i=0; i<nb_loops; i++)
-            {
-              if ((*it)->m_fadingSamples > 0)
-              {
-                (*it)->m_volume += fadingStep;
-                (*it)->m_fadingSamples--;
-
-                if ((*it)->m_fadingSamples == 0)
-                {
-                  // set variables being polled via stream interface
-                  CSingleLock lock((*it)->m_streamLock);
-                  (*it)->m_streamFading = false;
-                }
-              }
+            if (nb_loops > 1)
+              GetFrameGains(*it, mix->pkt, nb_loops, fadingStep);
 
-              // volume for stream
-              float volume = (*it)->m_volume * (*it)->m_rgain;
-              if(nb_loops > 1)
-                volume *= (*it)->m_limiter.Run((float**)mix->pkt->data, mix->pkt->config.channels, i*nb_floats, mix->pkt->planes > 1);
+            // volume for stream
+            float volume = (*it)->m_volume * (*it)->m_rgain;
+            for(int j=0; j<out->pkt->planes && j<mix->pkt->planes; j++)
+            {
+              float *dst = (float*)out->pkt->data[j];
+              float *src = (float*)mix->pkt->data[j];
+              if (nb_loops > 1)
+                CAEUtil::MulAddArrayRamp(dst, src, m_frameGains.data(), nb_loops, nb_floats);
+              else
+                CAEUtil::MulAddArray(dst, src, volume, nb_floats);
 
-              for(int j=0; j<out->pkt->planes && j<mix->pkt->planes; j++)
+              for (int k = 0; k < nb_loops * nb_floats && !needClamp; ++k)
               {
-                float *dst = (float*)out->pkt->data[j]+i*nb_floats;
-                float *src = (float*)mix->pkt->data[j]+i*nb_floats;
-#if defined(HAVE_SSE) && defined(__SSE__)
-                CAEUtil::SSEMulAddArray(dst, src, volume, nb_floats);
-                for (int k = 0; k < nb_floats; ++k)
-                {
-                  if (fabs(dst[k]) > 1.0f)
-                  {
-                    needClamp = true;
-                    break;
-                  }
-                }
-#else
-                for (int k = 0; k < nb_floats; ++k)
-                {
-                  dst[k] += src[k] * volume;
-                  if (fabs(dst[k]) > 1.0f)
-                    needClamp = true;
-                }
-#endif
+                if (fabs(dst[k]) > 1.0f)
+                  needClamp = true;
               }
             }
             mix->Return();
@@ -2516,6 +2472,34 @@ CSampleBuffer* CActiveAE::SyncStream(CActiveAEStream *stream)
   return ret;
 }
 
+void CActiveAE::GetFrameGains(CActiveAEStream *stream, CSoundPacket *pkt, int frames, float fadingStep)
+{
+  m_framePeaks.resize(frames);
+  m_frameGains.resize(frames);
+
+  CAEUtil::FramePeaks(reinterpret_cast<float**>(pkt->data), pkt->config.channels, frames, pkt->planes > 1, m_framePeaks.data());
+
+  for (int i = 0; i < frames; i++)
+  {
+    if (stream->m_fadingSamples > 0)
+    {
+      stream->m_volume += fadingStep;
+      stream->m_fadingSamples--;
+
+      if (stream->m_fadingSamples == 0)
+      {
+        // set variables being polled via stream interface
+        CSingleLock lock(stream->m_streamLock);
+        stream->m_streamFading = false;
+      }
+    }
+
+    // volume for stream
+    float volume = stream->m_volume * stream->m_rgain;
+    m_frameGains[i] = volume * stream->m_limiter.RunPeak(m_framePeaks[i]);
+  }
+}
+
 void CActiveAE::MixSounds(CSoundPacket &dstSample)
 {
   if (m_sounds_playing.empty())
@@ -2544,12 +2528,7 @@ void CActiveAE::MixSounds(CSoundPacket &dstSample)
       out = (float*)dstSample.data[j];
       sample_buffer = (float*)(it->sound->GetSound(false)->data[j]+start);
       int nb_floats = mix_samples * dstSample.config.channels / dstSample.planes;
-#if defined(HAVE_SSE) && defined(__SSE__)
-      CAEUtil::SSEMulAddArray(out, sample_buffer, volume, nb_floats);
-#else
-      for (int k = 0; k < nb_floats; ++k)
-        *out++ += *sample_buffer++ * volume;
-#endif
+      CAEUtil::MulAddArray(out, sample_buffer, volume, nb_floats);
     }
 
     it->samples_played += mix_samples;
@@ -2574,13 +2553,7 @@ void CActiveAE::Deamplify(CSoundPacket &dstSample)
     for(int j=0; j<dstSample.planes; j++)
     {
       float* buffer = reinterpret_cast<float*>(dstSample.data[j]);
-#if defined(HAVE_SSE) && defined(__SSE__)
-      CAEUtil::SSEMulArray(buffer, volume, nb_floats);
-#else
-      float *fbuffer = buffer;
-      for (int i = 0; i < nb_floats; i++)
-        *fbuffer++ *= volume;
-#endif
+      CAEUtil::MulArray(buffer, volume, nb_floats);
     }
   }
 }
@@ -323,6 +323,7 @@ protected:
 
   void ResampleSounds();
   bool ResampleSound(CActiveAESound *sound);
+  void GetFrameGains(CActiveAEStream *stream, CSoundPacket *pkt, int frames, float fadingStep);
   void MixSounds(CSoundPacket &dstSample);
   void Deamplify(CSoundPacket &dstSample);
 
@@ -373,6 +374,8 @@ protected:
   std::list<CActiveAEStream*> m_streams;
   std::list<CActiveAEBufferPool*> m_discardBufferPools;
   unsigned int m_streamIdGen;
+  std::vector<float> m_framePeaks; // scratch for per frame volume, see GetFrameGains
+  std::vector<float> m_frameGains;
 
   // gui sounds
   struct SoundState
@@ -51,4 +51,10 @@ class CAELimiter
     }
 
     float Run(float* frame[AE_CH_MAX], int channels, int offset = 0, bool planar = false);
+
+    /*! \brief advance the limiter by one frame
+     \param highest the highest absolute sample of the frame, see CAEUtil::FramePeaks
+     \return the gain to apply to the frame
+     */
+    float RunPeak(float highest);
 };
@@ -22,11 +22,17 @@
 #endif
 
 #include "AEUtil.h"
+#include "utils/CPUInfo.h"
 #include "utils/log.h"
 #include "utils/TimeUtils.h"
 
+#include <algorithm>
 #include <cassert>
 
+#if defined(HAS_NEON)
+#include <arm_neon.h>
+#endif
+
 extern "C" {
 #include "libavutil/channel_layout.h"
 }
@@ -231,219 +237,410 @@ const char* CAEUtil::DataFormatToStr(const enum AEDataFormat dataFormat)
   return formats[dataFormat];
 }
 
-#if defined(HAVE_SSE) && defined(__SSE__)
-void CAEUtil::SSEMulArray(float *data, const float mul, uint32_t count)
+namespace
 {
-  const __m128 m = _mm_set_ps1(mul);
 
-  /* work around invalid alignment */
-  while (((uintptr_t)data & 0xF) && count > 0)
+/*
+   This is a rational function to approximate a tanh-like soft clipper.
+   It is based on the pade-approximation of the tanh function with tweaked coefficients.
+   See: http://www.musicdsp.org/showone.php?id=238
+   The SIMD versions clamp the input to -3.0 .. 3.0 instead of branching, the function
+   is exactly -1.0/1.0 there.
+*/
+inline float SoftClamp(const float x)
+{
+  if (x < -3.0f)
+    return -1.0f;
+  else if (x >  3.0f)
+    return 1.0f;
+  float y = x * x;
+  return x * (27.0f + y) / (27.0f + 9.0f * y);
+}
+
+void MulArrayC(float *data, const float mul, uint32_t count)
+{
+  for (uint32_t i = 0; i < count; ++i)
+    data[i] *= mul;
+}
+
+void MulAddArrayC(float *data, const float *add, const float mul, uint32_t count)
+{
+  for (uint32_t i = 0; i < count; ++i)
+    data[i] += add[i] * mul;
+}
+
+void MulArrayRampC(float *data, const float *gains, uint32_t frames, uint32_t channels)
+{
+  for (uint32_t i = 0; i < frames; ++i, data += channels)
   {
-    data[0] *= mul;
-    ++data;
-    --count;
+    for (uint32_t c = 0; c < channels; ++c)
+      data[c] *= gains[i];
   }
+}
 
-  uint32_t even = count & ~0x3;
-  for (uint32_t i = 0; i < even; i+=4, data+=4)
+void MulAddArrayRampC(float *data, const float *add, const float *gains, uint32_t frames, uint32_t channels)
+{
+  for (uint32_t i = 0; i < frames; ++i, data += channels, add += channels)
   {
-    __m128 to      = _mm_load_ps(data);
-    *(__m128*)data = _mm_mul_ps (to, m);
+    for (uint32_t c = 0; c < channels; ++c)
+      data[c] += add[c] * gains[i];
   }
+}
 
-  if (even != count)
+void ClampArrayC(float *data, uint32_t count)
+{
+  for (uint32_t i = 0; i < count; ++i)
+    data[i] = SoftClamp(data[i]);
+}
+
+void FramePeaksC(float * const *data, uint32_t channels, uint32_t frames, bool planar, float *peaks)
+{
+  if (planar)
   {
-    uint32_t odd = count - even;
-    if (odd == 1)
-      data[0] *= mul;
-    else
+    for (uint32_t i = 0; i < frames; ++i)
     {
-      __m128 to;
-      if (odd == 2)
-      {
-        to = _mm_setr_ps(data[0], data[1], 0, 0);
-        __m128 ou = _mm_mul_ps(to, m);
-        data[0] = ((float*)&ou)[0];
-        data[1] = ((float*)&ou)[1];
-      }
-      else
-      {
-        to = _mm_setr_ps(data[0], data[1], data[2], 0);
-        __m128 ou = _mm_mul_ps(to, m);
-        data[0] = ((float*)&ou)[0];
-        data[1] = ((float*)&ou)[1];
-        data[2] = ((float*)&ou)[2];
-      }
+      float highest = 0.0f;
+      for (uint32_t c = 0; c < channels; ++c)
+        highest = std::max(highest, fabsf(data[c][i]));
+      peaks[i] = highest;
     }
   }
+  else
+  {
+    const float *frame = data[0];
+    for (uint32_t i = 0; i < frames; ++i, frame += channels)
+    {
+      float highest = 0.0f;
+      for (uint32_t c = 0; c < channels; ++c)
+        highest = std::max(highest, fabsf(frame[c]));
+      peaks[i] = highest;
+    }
+  }
+}
+
+const AESampleKernels kernelsC =
+{
+  "C",
+  MulArrayC,
+  MulAddArrayC,
+  MulArrayRampC,
+  MulAddArrayRampC,
+  ClampArrayC,
+  FramePeaksC
+};
+
+#if defined(HAVE_SSE) && defined(__SSE__)
+void MulArraySSE(float *data, const float mul, uint32_t count)
+{
+  const __m128 m = _mm_set_ps1(mul);
+
+  uint32_t i = 0;
+  for (; i + 4 <= count; i += 4)
+    _mm_storeu_ps(data + i, _mm_mul_ps(_mm_loadu_ps(data + i), m));
+
+  MulArrayC(data + i, mul, count - i);
 }
 
-void CAEUtil::SSEMulAddArray(float *data, float *add, const float mul, uint32_t count)
+void MulAddArraySSE(float *data, const float *add, const float mul, uint32_t count)
 {
   const __m128 m = _mm_set_ps1(mul);
 
-  /* work around invalid alignment */
-  while ((((uintptr_t)data & 0xF) || ((uintptr_t)add & 0xF)) && count > 0)
+  uint32_t i = 0;
+  for (; i + 4 <= count; i += 4)
   {
-    data[0] += add[0] * mul;
-    ++add;
-    ++data;
-    --count;
+    __m128 ad = _mm_mul_ps(_mm_loadu_ps(add + i), m);
+    _mm_storeu_ps(data + i, _mm_add_ps(_mm_loadu_ps(data + i), ad));
   }
 
-  uint32_t even = count & ~0x3;
-  for (uint32_t i = 0; i < even; i+=4, data+=4, add+=4)
+  MulAddArrayC(data + i, add + i, mul, count - i);
+}
+
+void MulArrayRampSSE(float *data, const float *gains, uint32_t frames, uint32_t channels)
+{
+  uint32_t i = 0;
+  if (channels == 1)
   {
-    __m128 ad      = _mm_load_ps(add );
-    __m128 to      = _mm_load_ps(data);
-    *(__m128*)data = _mm_add_ps (to, _mm_mul_ps(ad, m));
+    for (; i + 4 <= frames; i += 4)
+      _mm_storeu_ps(data + i, _mm_mul_ps(_mm_loadu_ps(data + i), _mm_loadu_ps(gains + i)));
+  }
+  else if (channels == 2)
+  {
+    for (; i + 4 <= frames; i += 4)
+    {
+      __m128 g = _mm_loadu_ps(gains + i);
+      float *dt = data + i * 2;
+      _mm_storeu_ps(dt,     _mm_mul_ps(_mm_loadu_ps(dt),     _mm_unpacklo_ps(g, g)));
+      _mm_storeu_ps(dt + 4, _mm_mul_ps(_mm_loadu_ps(dt + 4), _mm_unpackhi_ps(g, g)));
+    }
   }
 
-  if (even != count)
+  MulArrayRampC(data + i * channels, gains + i, frames - i, channels);
+}
+
+void MulAddArrayRampSSE(float *data, const float *add, const float *gains, uint32_t frames, uint32_t channels)
+{
+  uint32_t i = 0;
+  if (channels == 1)
   {
-    uint32_t odd = count - even;
-    if (odd == 1)
-      data[0] += add[0] * mul;
-    else
+    for (; i + 4 <= frames; i += 4)
     {
-      __m128 ad;
-      __m128 to;
-      if (odd == 2)
-      {
-        ad = _mm_setr_ps(add [0], add [1], 0, 0);
-        to = _mm_setr_ps(data[0], data[1], 0, 0);
-        __m128 ou = _mm_add_ps(to, _mm_mul_ps(ad, m));
-        data[0] = ((float*)&ou)[0];
-        data[1] = ((float*)&ou)[1];
-      }
-      else
-      {
-        ad = _mm_setr_ps(add [0], add [1], add [2], 0);
-        to = _mm_setr_ps(data[0], data[1], data[2], 0);
-        __m128 ou = _mm_add_ps(to, _mm_mul_ps(ad, m));
-        data[0] = ((float*)&ou)[0];
-        data[1] = ((float*)&ou)[1];
-        data[2] = ((float*)&ou)[2];
-      }
+      __m128 ad = _mm_mul_ps(_mm_loadu_ps(add + i), _mm_loadu_ps(gains + i));
+      _mm_storeu_ps(data + i, _mm_add_ps(_mm_loadu_ps(data + i), ad));
     }
   }
+  else if (channels == 2)
+  {
+    for (; i + 4 <= frames; i += 4)
+    {
+      __m128 g = _mm_loadu_ps(gains + i);
+      float *dt = data + i * 2;
+      const float *ad = add + i * 2;
+      __m128 lo = _mm_mul_ps(_mm_loadu_ps(ad),     _mm_unpacklo_ps(g, g));
+      __m128 hi = _mm_mul_ps(_mm_loadu_ps(ad + 4), _mm_unpackhi_ps(g, g));
+      _mm_storeu_ps(dt,     _mm_add_ps(_mm_loadu_ps(dt),     lo));
+      _mm_storeu_ps(dt + 4, _mm_add_ps(_mm_loadu_ps(dt + 4), hi));
+    }
+  }
+
+  MulAddArrayRampC(data + i * channels, add + i * channels, gains + i, frames - i, channels);
 }
-#endif
 
-inline float CAEUtil::SoftClamp(const float x)
-{
-#if 1
-    /*
-       This is a rational function to approximate a tanh-like soft clipper.
-       It is based on the pade-approximation of the tanh function with tweaked coefficients.
-       See: http://www.musicdsp.org/showone.php?id=238
-    */
-    if (x < -3.0f)
-      return -1.0f;
-    else if (x >  3.0f)
-      return 1.0f;
-    float y = x * x;
-    return x * (27.0f + y) / (27.0f + 9.0f * y);
-#else
-    /* slower method using tanh, but more accurate */
-
-    static const double k = 0.9f;
-    /* perform a soft clamp */
-    if (x >  k)
-      x = (float) (tanh((x - k) / (1 - k)) * (1 - k) + k);
-    else if (x < -k)
-      x = (float) (tanh((x + k) / (1 - k)) * (1 - k) - k);
-
-    /* hard clamp anything still outside the bounds */
-    if (x >  1.0f)
-      return  1.0f;
-    if (x < -1.0f)
-      return -1.0f;
-
-    /* return the final sample */
-    return x;
+void ClampArraySSE(float *data, uint32_t count)
+{
+  const __m128 lower = _mm_set_ps1(-3.0f);
+  const __m128 upper = _mm_set_ps1(3.0f);
+  const __m128 c27 = _mm_set_ps1(27.0f);
+  const __m128 c9 = _mm_set_ps1(9.0f);
+
+  uint32_t i = 0;
+  for (; i + 4 <= count; i += 4)
+  {
+    /* operand order keeps NaN like the C version */
+    __m128 dt  = _mm_min_ps(upper, _mm_max_ps(lower, _mm_loadu_ps(data + i)));
+    __m128 tmp = _mm_mul_ps(dt, dt);
+    __m128 out = _mm_div_ps(_mm_mul_ps(dt, _mm_add_ps(c27, tmp)),
+                            _mm_add_ps(c27, _mm_mul_ps(c9, tmp)));
+    _mm_storeu_ps(data + i, out);
+  }
+
+  ClampArrayC(data + i, count - i);
+}
+
+void FramePeaksSSE(float * const *data, uint32_t channels, uint32_t frames, bool planar, float *peaks)
+{
+  if (!planar)
+  {
+    FramePeaksC(data, channels, frames, planar, peaks);
+    return;
+  }
+
+  const __m128 signMask = _mm_set_ps1(-0.0f);
+
+  uint32_t i = 0;
+  for (; i + 4 <= frames; i += 4)
+  {
+    __m128 highest = _mm_setzero_ps();
+    for (uint32_t c = 0; c < channels; ++c)
+      highest = _mm_max_ps(_mm_andnot_ps(signMask, _mm_loadu_ps(data[c] + i)), highest);
+    _mm_storeu_ps(peaks + i, highest);
+  }
+
+  for (; i < frames; ++i)
+  {
+    float highest = 0.0f;
+    for (uint32_t c = 0; c < channels; ++c)
+      highest = std::max(highest, fabsf(data[c][i]));
+    peaks[i] = highest;
+  }
+}
+
+const AESampleKernels kernelsSSE =
+{
+  "SSE",
+  MulArraySSE,
+  MulAddArraySSE,
+  MulArrayRampSSE,
+  MulAddArrayRampSSE,
+  ClampArraySSE,
+  FramePeaksSSE
+};
 #endif
+
+#if defined(HAS_NEON)
+void MulArrayNEON(float *data, const float mul, uint32_t count)
+{
+  const float32x4_t m = vdupq_n_f32(mul);
+
+  uint32_t i = 0;
+  for (; i + 4 <= count; i += 4)
+    vst1q_f32(data + i, vmulq_f32(vld1q_f32(data + i), m));
+
+  MulArrayC(data + i, mul, count - i);
 }
 
-void CAEUtil::ClampArray(float *data, uint32_t count)
+void MulAddArrayNEON(float *data, const float *add, const float mul, uint32_t count)
 {
-#if !defined(HAVE_SSE) || !defined(__SSE__)
-  for (uint32_t i = 0; i < count; ++i)
-    data[i] = SoftClamp(data[i]);
+  const float32x4_t m = vdupq_n_f32(mul);
 
-#else
-  const __m128 c1 = _mm_set_ps1(27.0f);
-  const __m128 c2 = _mm_set_ps1(27.0f + 9.0f);
+  uint32_t i = 0;
+  for (; i + 4 <= count; i += 4)
+  {
+    /* no vmla, a fused multiply-add would not match the C version */
+    float32x4_t ad = vmulq_f32(vld1q_f32(add + i), m);
+    vst1q_f32(data + i, vaddq_f32(vld1q_f32(data + i), ad));
+  }
 
-  /* work around invalid alignment */
-  while (((uintptr_t)data & 0xF) && count > 0)
+  MulAddArrayC(data + i, add + i, mul, count - i);
+}
+
+void MulArrayRampNEON(float *data, const float *gains, uint32_t frames, uint32_t channels)
+{
+  uint32_t i = 0;
+  if (channels == 1)
   {
-    data[0] = SoftClamp(data[0]);
-    ++data;
-    --count;
+    for (; i + 4 <= frames; i += 4)
+      vst1q_f32(data + i, vmulq_f32(vld1q_f32(data + i), vld1q_f32(gains + i)));
   }
+  else if (channels == 2)
+  {
+    for (; i + 4 <= frames; i += 4)
+    {
+      float32x4_t g = vld1q_f32(gains + i);
+      float32x4x2_t gg = vzipq_f32(g, g);
+      float *dt = data + i * 2;
+      vst1q_f32(dt,     vmulq_f32(vld1q_f32(dt),     gg.val[0]));
+      vst1q_f32(dt + 4, vmulq_f32(vld1q_f32(dt + 4), gg.val[1]));
+    }
+  }
+
+  MulArrayRampC(data + i * channels, gains + i, frames - i, channels);
+}
 
-  uint32_t even = count & ~0x3;
-  for (uint32_t i = 0; i < even; i+=4, data+=4)
+void MulAddArrayRampNEON(float *data, const float *add, const float *gains, uint32_t frames, uint32_t channels)
+{
+  uint32_t i = 0;
+  if (channels == 1)
+  {
+    for (; i + 4 <= frames; i += 4)
+    {
+      float32x4_t ad = vmulq_f32(vld1q_f32(add + i), vld1q_f32(gains + i));
+      vst1q_f32(data + i, vaddq_f32(vld1q_f32(data + i), ad));
+    }
+  }
+  else if (channels == 2)
   {
-    /* tanh approx clamp */
-    __m128 dt = _mm_load_ps(data);
-    __m128 tmp     = _mm_mul_ps(dt, dt);
-    *(__m128*)data = _mm_div_ps(
-      _mm_mul_ps(
-        dt,
-        _mm_add_ps(c1, tmp)
-      ),
-      _mm_add_ps(c2, tmp)
-    );
+    for (; i + 4 <= frames; i += 4)
+    {
+      float32x4_t g = vld1q_f32(gains + i);
+      float32x4x2_t gg = vzipq_f32(g, g);
+      float *dt = data + i * 2;
+      const float *ad = add + i * 2;
+      float32x4_t lo = vmulq_f32(vld1q_f32(ad),     gg.val[0]);
+      float32x4_t hi = vmulq_f32(vld1q_f32(ad + 4), gg.val[1]);
+      vst1q_f32(dt,     vaddq_f32(vld1q_f32(dt),     lo));
+      vst1q_f32(dt + 4, vaddq_f32(vld1q_f32(dt + 4), hi));
+    }
   }
 
-  if (even != count)
+  MulAddArrayRampC(data + i * channels, add + i * channels, gains + i, frames - i, channels);
+}
+
+#if defined(__aarch64__)
+void ClampArrayNEON(float *data, uint32_t count)
+{
+  const float32x4_t lower = vdupq_n_f32(-3.0f);
+  const float32x4_t upper = vdupq_n_f32(3.0f);
+  const float32x4_t c27 = vdupq_n_f32(27.0f);
+  const float32x4_t c9 = vdupq_n_f32(9.0f);
+
+  uint32_t i = 0;
+  for (; i + 4 <= count; i += 4)
   {
-    uint32_t odd = count - even;
-    if (odd == 1)
-      data[0] = SoftClamp(data[0]);
-    else
+    /* select instead of vmin/vmax, those don't keep NaN like the C version */
+    float32x4_t dt  = vld1q_f32(data + i);
+    dt = vbslq_f32(vcltq_f32(dt, lower), lower, dt);
+    dt = vbslq_f32(vcgtq_f32(dt, upper), upper, dt);
+    float32x4_t tmp = vmulq_f32(dt, dt);
+    float32x4_t out = vdivq_f32(vmulq_f32(dt, vaddq_f32(c27, tmp)),
+                                vaddq_f32(c27, vmulq_f32(c9, tmp)));
+    vst1q_f32(data + i, out);
+  }
+
+  ClampArrayC(data + i, count - i);
+}
+#else
+/* armv7 NEON has no exact division */
+#define ClampArrayNEON ClampArrayC
+#endif
+
+void FramePeaksNEON(float * const *data, uint32_t channels, uint32_t frames, bool planar, float *peaks)
+{
+  if (!planar)
+  {
+    FramePeaksC(data, channels, frames, planar, peaks);
+    return;
+  }
+
+  uint32_t i = 0;
+  for (; i + 4 <= frames; i += 4)
+  {
+    float32x4_t highest = vdupq_n_f32(0.0f);
+    for (uint32_t c = 0; c < channels; ++c)
     {
-      __m128 dt;
-      __m128 tmp;
-      __m128 out;
-      if (odd == 2)
-      {
-        /* tanh approx clamp */
-        dt  = _mm_setr_ps(data[0], data[1], 0, 0);
-        tmp = _mm_mul_ps(dt, dt);
-        out = _mm_div_ps(
-          _mm_mul_ps(
-            dt,
-            _mm_add_ps(c1, tmp)
-          ),
-          _mm_add_ps(c2, tmp)
-        );
-
-        data[0] = ((float*)&out)[0];
-        data[1] = ((float*)&out)[1];
-      }
-      else
-      {
-        /* tanh approx clamp */
-        dt  = _mm_setr_ps(data[0], data[1], data[2], 0);
-        tmp = _mm_mul_ps(dt, dt);
-        out = _mm_div_ps(
-          _mm_mul_ps(
-            dt,
-            _mm_add_ps(c1, tmp)
-          ),
-          _mm_add_ps(c2, tmp)
-        );
-
-        data[0] = ((float*)&out)[0];
-        data[1] = ((float*)&out)[1];
-        data[2] = ((float*)&out)[2];
-      }
+      float32x4_t sample = vabsq_f32(vld1q_f32(data[c] + i));
+      highest = vbslq_f32(vcgtq_f32(sample, highest), sample, highest);
     }
+    vst1q_f32(peaks + i, highest);
+  }
+
+  for (; i < frames; ++i)
+  {
+    float highest = 0.0f;
+    for (uint32_t c = 0; c < channels; ++c)
+      highest = std::max(highest, fabsf(data[c][i]));
+    peaks[i] = highest;
   }
+}
+
+const AESampleKernels kernelsNEON =
+{
+  "NEON",
+  MulArrayNEON,
+  MulAddArrayNEON,
+  MulArrayRampNEON,
+  MulAddArrayRampNEON,
+  ClampArrayNEON,
+  FramePeaksNEON
+};
+#endif
+
+const AESampleKernels& SelectKernels()
+{
+  const AESampleKernels *kernels = &kernelsC;
+#if defined(HAVE_SSE) && defined(__SSE__)
+  if (g_cpuInfo.GetCPUFeatures() & CPU_FEATURE_SSE)
+    kernels = &kernelsSSE;
+#endif
+#if defined(HAS_NEON)
+  if (g_cpuInfo.GetCPUFeatures() & CPU_FEATURE_NEON)
+    kernels = &kernelsNEON;
 #endif
+
+  CLog::Log(LOGDEBUG, "CAEUtil: using %s sample kernels", kernels->name);
+  return *kernels;
+}
+
+} // namespace
+
+const AESampleKernels& CAEUtil::GetKernels()
+{
+  static const AESampleKernels &kernels = SelectKernels();
+  return kernels;
+}
+
+const AESampleKernels& CAEUtil::GetScalarKernels()
+{
+  return kernelsC;
 }
 
 bool CAEUtil::S16NeedsByteSwap(AEDataFormat in, AEDataFormat out)
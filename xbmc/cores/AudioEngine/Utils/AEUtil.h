@@ -115,6 +115,30 @@ private:
   unsigned int    m_begin;
 };
 
+/**
+ * @brief table of the sample processing kernels used by CAEUtil
+ *
+ * All implementations of a kernel produce bit identical output, they only
+ * differ in the instruction set used. See CAEUtil::GetKernels.
+ */
+struct AESampleKernels
+{
+  const char *name;
+
+  /* data[i] *= mul */
+  void (*MulArray)(float *data, const float mul, uint32_t count);
+  /* data[i] += add[i] * mul */
+  void (*MulAddArray)(float *data, const float *add, const float mul, uint32_t count);
+  /* data[i * channels + c] *= gains[i] */
+  void (*MulArrayRamp)(float *data, const float *gains, uint32_t frames, uint32_t channels);
+  /* data[i * channels + c] += add[i * channels + c] * gains[i] */
+  void (*MulAddArrayRamp)(float *data, const float *add, const float *gains, uint32_t frames, uint32_t channels);
+  /* soft clamp to -1.0 .. 1.0 */
+  void (*ClampArray)(float *data, uint32_t count);
+  /* peaks[i] = highest absolute sample of frame i, over all channels */
+  void (*FramePeaks)(float * const *data, uint32_t channels, uint32_t frames, bool planar, float *peaks);
+};
+
 class CAEUtil
 {
 private:
@@ -123,8 +147,6 @@ private:
     static __m128i m_sseSeed;
   #endif
 
-  static float SoftClamp(const float x);
-
 public:
   static CAEChannelInfo          GuessChLayout     (const unsigned int channels);
   static const char*             GetStdChLayoutName(const enum AEStdChLayout layout);
@@ -192,11 +214,25 @@ public:
     return 20*log10(scale);
   }
 
-  #if defined(HAVE_SSE) && defined(__SSE__)
-  static void SSEMulArray     (float *data, const float mul, uint32_t count);
-  static void SSEMulAddArray  (float *data, float *add, const float mul, uint32_t count);
-  #endif
-  static void ClampArray(float *data, uint32_t count);
+  /*! \brief get the sample kernels for the running cpu
+   The fastest implementation supported by both the build and the cpu
+   (SSE or NEON) is picked on first use, plain C++ otherwise.
+   \return the kernel table
+   */
+  static const AESampleKernels& GetKernels();
+
+  /*! \brief get the plain C++ sample kernels
+   The reference the SIMD kernels are tested against.
+   \return the kernel table
+   */
+  static const AESampleKernels& GetScalarKernels();
+
+  static void MulArray(float *data, const float mul, uint32_t count) { GetKernels().MulArray(data, mul, count); }
+  static void MulAddArray(float *data, const float *add, const float mul, uint32_t count) { GetKernels().MulAddArray(data, add, mul, count); }
+  static void MulArrayRamp(float *data, const float *gains, uint32_t frames, uint32_t channels) { GetKernels().MulArrayRamp(data, gains, frames, channels); }
+  static void MulAddArrayRamp(float *data, const float *add, const float *gains, uint32_t frames, uint32_t channels) { GetKernels().MulAddArrayRamp(data, add, gains, frames, channels); }
+  static void ClampArray(float *data, uint32_t count) { GetKernels().ClampArray(data, count); }
+  static void FramePeaks(float * const *data, uint32_t channels, uint32_t frames, bool planar, float *peaks) { GetKernels().FramePeaks(data, channels, frames, planar, peaks); }
 
   static bool S16NeedsByteSwap(AEDataFormat in, AEDataFormat out);
 
@@ -0,0 +1,170 @@
+/*
+ *      Copyright (C) 2018 Team Kodi
+ *      http://kodi.tv
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this Program; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+
+#include "cores/AudioEngine/Utils/AEUtil.h"
+
+#include <cstring>
+#include <random>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+namespace
+{
+  // sizes around the vector widths, so every kernel runs its tail loop as well
+  const uint32_t frameCounts[] = { 0, 1, 3, 4, 5, 7, 8, 31, 64, 1023 };
+  const uint32_t channelCounts[] = { 1, 2, 3, 6, 8 };
+
+  std::vector<float> RandomSamples(size_t count, float range)
+  {
+    std::mt19937 gen(static_cast<unsigned int>(count));
+    std::uniform_real_distribution<float> dist(-range, range);
+
+    std::vector<float> samples(count);
+    for (auto &sample : samples)
+      sample = dist(gen);
+
+    // the soft clamp boundaries and signed zero
+    if (count >= 4)
+    {
+      samples[0] = 3.0f;
+      samples[1] = -3.0f;
+      samples[2] = -0.0f;
+      samples[3] = 1.0f;
+    }
+    return samples;
+  }
+
+  ::testing::AssertionResult BitExact(const std::vector<float> &expected, const std::vector<float> &actual)
+  {
+    if (expected.size() != actual.size())
+      return ::testing::AssertionFailure() << "size " << actual.size() << " != " << expected.size();
+
+    for (size_t i = 0; i < expected.size(); ++i)
+    {
+      if (memcmp(&expected[i], &actual[i], sizeof(float)) != 0)
+        return ::testing::AssertionFailure() << "sample " << i << ": " << actual[i] << " != " << expected[i];
+    }
+    return ::testing::AssertionSuccess();
+  }
+}
+
+class TestAEUtil : public ::testing::Test
+{
+protected:
+  const AESampleKernels &ref = CAEUtil::GetScalarKernels();
+  const AESampleKernels &simd = CAEUtil::GetKernels();
+};
+
+TEST_F(TestAEUtil, MulArray)
+{
+  for (uint32_t frames : frameCounts)
+  {
+    std::vector<float> expected = RandomSamples(frames, 1.0f);
+    std::vector<float> actual = expected;
+    ref.MulArray(expected.data(), 0.7f, frames);
+    simd.MulArray(actual.data(), 0.7f, frames);
+    EXPECT_TRUE(BitExact(expected, actual)) << simd.name << " frames " << frames;
+  }
+}
+
+TEST_F(TestAEUtil, MulAddArray)
+{
+  for (uint32_t frames : frameCounts)
+  {
+    const std::vector<float> add = RandomSamples(frames + 1, 1.0f);
+    std::vector<float> expected = RandomSamples(frames, 1.0f);
+    std::vector<float> actual = expected;
+    ref.MulAddArray(expected.data(), add.data() + 1, 0.3f, frames);
+    simd.MulAddArray(actual.data(), add.data() + 1, 0.3f, frames);
+    EXPECT_TRUE(BitExact(expected, actual)) << simd.name << " frames " << frames;
+  }
+}
+
+TEST_F(TestAEUtil, MulArrayRamp)
+{
+  for (uint32_t channels : channelCounts)
+  {
+    for (uint32_t frames : frameCounts)
+    {
+      const std::vector<float> gains = RandomSamples(frames, 2.0f);
+      std::vector<float> expected = RandomSamples(frames * channels, 1.0f);
+      std::vector<float> actual = expected;
+      ref.MulArrayRamp(expected.data(), gains.data(), frames, channels);
+      simd.MulArrayRamp(actual.data(), gains.data(), frames, channels);
+      EXPECT_TRUE(BitExact(expected, actual)) << simd.name << " channels " << channels << " frames " << frames;
+    }
+  }
+}
+
+TEST_F(TestAEUtil, MulAddArrayRamp)
+{
+  for (uint32_t channels : channelCounts)
+  {
+    for (uint32_t frames : frameCounts)
+    {
+      const std::vector<float> gains = RandomSamples(frames, 2.0f);
+      const std::vector<float> add = RandomSamples(frames * channels + 1, 1.0f);
+      std::vector<float> expected = RandomSamples(frames * channels, 1.0f);
+      std::vector<float> actual = expected;
+      ref.MulAddArrayRamp(expected.data(), add.data(), gains.data(), frames, channels);
+      simd.MulAddArrayRamp(actual.data(), add.data(), gains.data(), frames, channels);
+      EXPECT_TRUE(BitExact(expected, actual)) << simd.name << " channels " << channels << " frames " << frames;
+    }
+  }
+}
+
+TEST_F(TestAEUtil, ClampArray)
+{
+  for (uint32_t frames : frameCounts)
+  {
+    std::vector<float> expected = RandomSamples(frames, 5.0f);
+    std::vector<float> actual = expected;
+    ref.ClampArray(expected.data(), frames);
+    simd.ClampArray(actual.data(), frames);
+    EXPECT_TRUE(BitExact(expected, actual)) << simd.name << " frames " << frames;
+  }
+}
+
+TEST_F(TestAEUtil, FramePeaks)
+{
+  for (uint32_t channels : channelCounts)
+  {
+    for (uint32_t frames : frameCounts)
+    {
+      std::vector<float> samples = RandomSamples(frames * channels, 2.0f);
+
+      std::vector<float*> planes;
+      for (uint32_t c = 0; c < channels; ++c)
+        planes.push_back(samples.data() + c * frames);
+
+      std::vector<float> expected(frames);
+      std::vector<float> actual(frames);
+      ref.FramePeaks(planes.data(), channels, frames, true, expected.data());
+      simd.FramePeaks(planes.data(), channels, frames, true, actual.data());
+      EXPECT_TRUE(BitExact(expected, actual)) << simd.name << " planar, channels " << channels << " frames " << frames;
+
+      ref.FramePeaks(planes.data(), channels, frames, false, expected.data());
+      simd.FramePeaks(planes.data(), channels, frames, false, actual.data());
+      EXPECT_TRUE(BitExact(expected, actual)) << simd.name << " interleaved, channels " << channels << " frames " << frames;
+    }
+  }
+}
@@ -0,0 +1,141 @@
+/*
+ *      Copyright (C) 2018 Team Kodi
+ *      http://kodi.tv
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this Program; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "DVDDemuxPacketPool.h"
+#include "cores/VideoPlayer/Interface/Addon/DemuxPacket.h"
+#include "threads/SingleLock.h"
+
+#ifdef TARGET_POSIX
+#include "platform/linux/XMemUtils.h"
+#endif
+
+namespace
+{
+// keeps the payload 16 byte aligned behind the size class prefix
+const size_t BUFFER_PREFIX = 16;
+}
+
+CDVDDemuxPacketPool& CDVDDemuxPacketPool::GetInstance()
+{
+  static CDVDDemuxPacketPool pool;
+  return pool;
+}
+
+CDVDDemuxPacketPool::~CDVDDemuxPacketPool()
+{
+  for (auto& buffers : m_buffers)
+  {
+    for (auto buffer : buffers)
+      _aligned_free(buffer);
+  }
+
+  for (auto packet : m_packets)
+    delete packet;
+}
+
+int CDVDDemuxPacketPool::GetSizeClass(size_t size)
+{
+  int sizeClass = 0;
+  while (sizeClass < CLASSES && (static_cast<size_t>(1) << (sizeClass + MIN_CLASS_SHIFT)) < size)
+    sizeClass++;
+
+  return sizeClass < CLASSES ? sizeClass : -1;
+}
+
+DemuxPacket* CDVDDemuxPacketPool::AllocatePacket()
+{
+  {
+    CSingleLock lock(m_section);
+    if (!m_packets.empty())
+    {
+      DemuxPacket* packet = m_packets.back();
+      m_packets.pop_back();
+      return packet;
+    }
+  }
+
+  return new DemuxPacket();
+}
+
+void CDVDDemuxPacketPool::FreePacket(DemuxPacket* packet)
+{
+  // drops crypto info and resets all fields for the next user
+  *packet = DemuxPacket();
+
+  {
+    CSingleLock lock(m_section);
+    if (m_packets.size() < MAX_POOLED_PACKETS)
+    {
+      m_packets.push_back(packet);
+      return;
+    }
+  }
+
+  delete packet;
+}
+
+uint8_t* CDVDDemuxPacketPool::AllocateBuffer(size_t size, size_t padding)
+{
+  int sizeClass = GetSizeClass(size + padding);
+  if (sizeClass >= 0)
+  {
+    CSingleLock lock(m_section);
+    std::vector<uint8_t*>& buffers = m_buffers[sizeClass];
+    if (!buffers.empty())
+    {
+      uint8_t* base = buffers.back();
+      buffers.pop_back();
+      m_pooledBytes -= static_cast<size_t>(1) << (sizeClass + MIN_CLASS_SHIFT);
+      m_hits++;
+      return base + BUFFER_PREFIX;
+    }
+  }
+
+  m_misses++;
+
+  size_t capacity = sizeClass >= 0 ? static_cast<size_t>(1) << (sizeClass + MIN_CLASS_SHIFT) : size + padding;
+  uint8_t* base = static_cast<uint8_t*>(_aligned_malloc(capacity + BUFFER_PREFIX, 16));
+  if (!base)
+    return nullptr;
+
+  *reinterpret_cast<int*>(base) = sizeClass;
+  return base + BUFFER_PREFIX;
+}
+
+void CDVDDemuxPacketPool::FreeBuffer(uint8_t* buffer)
+{
+  uint8_t* base = buffer - BUFFER_PREFIX;
+  int sizeClass = *reinterpret_cast<int*>(base);
+
+  if (sizeClass >= 0)
+  {
+    size_t capacity = static_cast<size_t>(1) << (sizeClass + MIN_CLASS_SHIFT);
+
+    CSingleLock lock(m_section);
+    if (m_pooledBytes + capacity <= MAX_POOLED_BYTES)
+    {
+      m_buffers[sizeClass].push_back(base);
+      m_pooledBytes += capacity;
+      return;
+    }
+  }
+
+  _aligned_free(base);
+}
@@ -0,0 +1,76 @@
+/*
+ *      Copyright (C) 2018 Team Kodi
+ *      http://kodi.tv
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this Program; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#pragma once
+
+#include "threads/CriticalSection.h"
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+struct DemuxPacket;
+
+/**
+ * Recycles DemuxPacket headers and padded payload buffers in power of two
+ * size classes, so the demux -> codec path does not hit malloc per packet.
+ * Payloads carry a small prefix recording their size class, buffers beyond
+ * the largest class bypass the pool.
+ */
+class CDVDDemuxPacketPool
+{
+public:
+  static CDVDDemuxPacketPool& GetInstance();
+
+  DemuxPacket* AllocatePacket();
+  void FreePacket(DemuxPacket* packet);
+
+  /**
+   * Returns a 16 byte aligned buffer of at least size + padding bytes
+   */
+  uint8_t* AllocateBuffer(size_t size, size_t padding);
+  void FreeBuffer(uint8_t* buffer);
+
+  uint64_t GetHits() const { return m_hits; }
+  uint64_t GetMisses() const { return m_misses; }
+
+private:
+  CDVDDemuxPacketPool() = default;
+  ~CDVDDemuxPacketPool();
+  CDVDDemuxPacketPool(const CDVDDemuxPacketPool&) = delete;
+  CDVDDemuxPacketPool& operator=(const CDVDDemuxPacketPool&) = delete;
+
+  static int GetSizeClass(size_t size);
+
+  static const int MIN_CLASS_SHIFT = 8;   // 256 bytes
+  static const int MAX_CLASS_SHIFT = 22;  // 4 MiB
+  static const int CLASSES = MAX_CLASS_SHIFT - MIN_CLASS_SHIFT + 1;
+  static const size_t MAX_POOLED_BYTES = 16 * 1024 * 1024;
+  static const size_t MAX_POOLED_PACKETS = 1024;
+
+  CCriticalSection m_section;
+  std::vector<uint8_t*> m_buffers[CLASSES];
+  std::vector<DemuxPacket*> m_packets;
+  size_t m_pooledBytes = 0;
+
+  std::atomic<uint64_t> m_hits{0};
+  std::atomic<uint64_t> m_misses{0};
+};
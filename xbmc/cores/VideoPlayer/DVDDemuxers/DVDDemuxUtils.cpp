@@ -19,14 +19,11 @@
  */
 
 #include "DVDDemuxUtils.h"
+#include "DVDDemuxPacketPool.h"
 #include "cores/VideoPlayer/Interface/Addon/TimingConstants.h"
 #include "cores/VideoPlayer/Interface/Addon/DemuxCrypto.h"
 #include "utils/log.h"
 
-#ifdef TARGET_POSIX
-#include "platform/linux/XMemUtils.h"
-#endif
-
 extern "C" {
 #include "libavcodec/avcodec.h"
 }
@@ -35,8 +32,10 @@ void CDVDDemuxUtils::FreeDemuxPacket(DemuxPacket* pPacket)
 {
   if (pPacket)
   {
+    CDVDDemuxPacketPool& pool = CDVDDemuxPacketPool::GetInstance();
+
     if (pPacket->pData)
-      _aligned_free(pPacket->pData);
+      pool.FreeBuffer(pPacket->pData);
     if (pPacket->iSideDataElems)
     {
       AVPacket avPkt;
@@ -45,13 +44,14 @@ void CDVDDemuxUtils::FreeDemuxPacket(DemuxPacket* pPacket)
       avPkt.side_data_elems = pPacket->iSideDataElems;
       av_packet_free_side_data(&avPkt);
     }
-    delete pPacket;
+    pool.FreePacket(pPacket);
   }
 }
 
 DemuxPacket* CDVDDemuxUtils::AllocateDemuxPacket(int iDataSize)
 {
-  DemuxPacket* pPacket = new DemuxPacket();
+  CDVDDemuxPacketPool& pool = CDVDDemuxPacketPool::GetInstance();
+  DemuxPacket* pPacket = pool.AllocatePacket();
 
   if (iDataSize > 0)
   {
@@ -64,7 +64,7 @@ DemuxPacket* CDVDDemuxUtils::AllocateDemuxPacket(int iDataSize)
      * Note, if the first 23 bits of the additional bytes are not 0 then damaged
      * MPEG bitstreams could cause overread and segfault
      */
-    pPacket->pData =(uint8_t*)_aligned_malloc(iDataSize + AV_INPUT_BUFFER_PADDING_SIZE, 16);
+    pPacket->pData = pool.AllocateBuffer(iDataSize, AV_INPUT_BUFFER_PADDING_SIZE);
     if (!pPacket->pData)
     {
       FreeDemuxPacket(pPacket);
@@ -86,6 +86,13 @@ DemuxPacket* CDVDDemuxUtils::AllocateDemuxPacket(unsigned int iDataSize, unsigne
   return ret;
 }
 
+void CDVDDemuxUtils::GetPoolStats(uint64_t &hits, uint64_t &misses)
+{
+  CDVDDemuxPacketPool& pool = CDVDDemuxPacketPool::GetInstance();
+  hits = pool.GetHits();
+  misses = pool.GetMisses();
+}
+
 void CDVDDemuxUtils::StoreSideData(DemuxPacket *pkt, AVPacket *src)
 {
   AVPacket avPkt;
@@ -32,5 +32,6 @@ public:
   static DemuxPacket* AllocateDemuxPacket(int iDataSize = 0);
   static DemuxPacket* AllocateDemuxPacket(unsigned int iDataSize, unsigned int encryptedSubsampleCount);
   static void StoreSideData(DemuxPacket *pkt, AVPacket *src);
+  static void GetPoolStats(uint64_t &hits, uint64_t &misses);
 };
 
@@ -25,16 +25,38 @@
 #include "cores/VideoPlayer/Interface/Addon/TimingConstants.h"
 #include "math.h"
 
+#include <thread>
+
+static_assert(CDVDMsg::SUBTITLE_ADDFILE - CDVDMsg::NONE < 64, "message types exceed ring counters");
+
 CDVDMessageQueue::CDVDMessageQueue(const std::string &owner) : m_hEvent(true), m_owner(owner)
 {
   m_iDataSize     = 0;
   m_bAbortRequest = false;
   m_bInitialized = false;
+  m_drain = false;
 
   m_TimeBack = DVD_NOPTS_VALUE;
   m_TimeFront = DVD_NOPTS_VALUE;
   m_TimeSize = 1.0 / 4.0; /* 4 seconds */
   m_iMaxDataSize = 0;
+
+  m_ringHead = 0;
+  m_ringTail = 0;
+  m_consumerWaiting = false;
+  m_prioCount = 0;
+  m_overflowCount = 0;
+  m_putBackCount = 0;
+  for (int i = 0; i < MSG_TYPES; i++)
+  {
+    m_ringPushed[i] = 0;
+    m_ringPopped[i] = 0;
+    m_ringFlushed[i] = 0;
+    m_ringFlushPos[i] = 0;
+  }
+  m_ringBytesPushed = 0;
+  m_ringBytesPopped = 0;
+  m_ringBytesFlushed = 0;
 }
 
 CDVDMessageQueue::~CDVDMessageQueue()
@@ -43,6 +65,32 @@ CDVDMessageQueue::~CDVDMessageQueue()
   Flush(CDVDMsg::NONE);
 }
 
+void CDVDMessageQueue::SetRingMode(unsigned int slots)
+{
+  CSingleLock lock(m_section);
+
+  if (m_bInitialized)
+  {
+    CLog::Log(LOGWARNING, "CDVDMessageQueue(%s)::SetRingMode - queue already initialized", m_owner.c_str());
+    return;
+  }
+
+  Flush(CDVDMsg::NONE);
+
+  unsigned int size = 0;
+  if (slots > 0)
+  {
+    size = 1;
+    while (size < slots)
+      size <<= 1;
+  }
+
+  m_ring.reset(size > 0 ? new std::atomic<CDVDMsg*>[size] : nullptr);
+  for (unsigned int i = 0; i < size; i++)
+    m_ring[i] = nullptr;
+  m_ringMask = size > 0 ? size - 1 : 0;
+}
+
 void CDVDMessageQueue::Init()
 {
   m_iDataSize = 0;
@@ -65,6 +113,46 @@ void CDVDMessageQueue::Flush(CDVDMsg::Message type)
     return type == CDVDMsg::NONE || item.message->IsType(type);
   });
 
+  if (IsRingMode())
+  {
+    m_putBack.remove_if([type](const DVDMessageListItem &item){
+      return type == CDVDMsg::NONE || item.message->IsType(type);
+    });
+
+    m_prioCount = m_prioMessages.size();
+    m_overflowCount = m_messages.size();
+    m_putBackCount = m_putBack.size();
+
+    if (type == CDVDMsg::NONE)
+    {
+      // no consumer is running, release everything right away
+      uint64_t head = m_ringHead.load(std::memory_order_acquire);
+      uint64_t tail = m_ringTail.load(std::memory_order_relaxed);
+      for (; tail != head; tail++)
+      {
+        // a put claimed the slot but may not have filled it yet
+        CDVDMsg* msg;
+        while (!(msg = m_ring[tail & m_ringMask].exchange(nullptr, std::memory_order_acquire)))
+          std::this_thread::yield();
+        msg->Release();
+      }
+      m_ringTail.store(tail, std::memory_order_release);
+      for (int i = 0; i < MSG_TYPES; i++)
+        m_ringPopped[i] = m_ringFlushed[i] = m_ringPushed[i].load();
+      m_ringBytesPopped = m_ringBytesFlushed = m_ringBytesPushed.load();
+    }
+    else
+    {
+      // the consumer owns the ring tail, mark everything queued so far as
+      // flushed and let it drop those messages when it reaches them. the
+      // counts are off by the puts racing with this until those are popped
+      m_ringFlushPos[type - CDVDMsg::NONE].store(m_ringHead.load(), std::memory_order_release);
+      m_ringFlushed[type - CDVDMsg::NONE].store(m_ringPushed[type - CDVDMsg::NONE].load(), std::memory_order_release);
+      if (type == CDVDMsg::DEMUXER_PACKET)
+        m_ringBytesFlushed.store(m_ringBytesPushed.load(), std::memory_order_release);
+    }
+  }
+
   if (type == CDVDMsg::DEMUXER_PACKET ||  type == CDVDMsg::NONE)
   {
     m_iDataSize = 0;
@@ -96,6 +184,9 @@ void CDVDMessageQueue::End()
 
 MsgQueueReturnCode CDVDMessageQueue::Put(CDVDMsg* pMsg, int priority)
 {
+  if (IsRingMode() && priority == 0 && pMsg && m_bInitialized)
+    return PutRing(pMsg);
+
   return Put(pMsg, priority, true);
 }
 
@@ -131,6 +222,22 @@ MsgQueueReturnCode CDVDMessageQueue::Put(CDVDMsg* pMsg, int priority, bool front
                              return prio <= item.priority;
                            });
     m_prioMessages.emplace(it, pMsg, priority);
+    if (IsRingMode())
+      m_prioCount++;
+  }
+  else if (IsRingMode())
+  {
+    if (front)
+    {
+      // ring is full, keep order by queueing behind it until it drained
+      m_messages.emplace_front(pMsg, priority);
+      m_overflowCount++;
+    }
+    else
+    {
+      m_putBack.emplace_back(pMsg, priority);
+      m_putBackCount++;
+    }
   }
   else
   {
@@ -153,7 +260,14 @@ MsgQueueReturnCode CDVDMessageQueue::Put(CDVDMsg* pMsg, int priority, bool front
     if (packet)
     {
       m_iDataSize += packet->iSize;
-      if (front)
+      if (IsRingMode())
+      {
+        if (front)
+          UpdateTimeFront(pMsg);
+        else
+          UpdateTimeBack(pMsg);
+      }
+      else if (front)
         UpdateTimeFront();
       else
         UpdateTimeBack();
@@ -168,8 +282,43 @@ MsgQueueReturnCode CDVDMessageQueue::Put(CDVDMsg* pMsg, int priority, bool front
   return MSGQ_OK;
 }
 
+MsgQueueReturnCode CDVDMessageQueue::PutRing(CDVDMsg* pMsg)
+{
+  // claim a slot, producers only contend on the head
+  uint64_t head = m_ringHead.load(std::memory_order_relaxed);
+  do
+  {
+    if (m_overflowCount > 0 || head - m_ringTail.load(std::memory_order_acquire) > m_ringMask)
+    {
+      if (m_overflowCount == 0)
+        CLog::Log(LOGDEBUG, "CDVDMessageQueue(%s)::Put - ring full, using overflow list", m_owner.c_str());
+      return Put(pMsg, 0, true);
+    }
+  } while (!m_ringHead.compare_exchange_weak(head, head + 1, std::memory_order_acq_rel, std::memory_order_relaxed));
+
+  // counted before the slot is filled, so the consumer never pops more than was pushed
+  m_ringPushed[GetTypeIndex(pMsg)]++;
+  int size = GetPacketSize(pMsg);
+  if (size >= 0)
+  {
+    m_ringBytesPushed += size;
+    UpdateTimeFront(pMsg);
+  }
+
+  m_ring[head & m_ringMask].store(pMsg, std::memory_order_seq_cst);
+
+  // only pay for the event if the consumer is actually sleeping
+  if (m_consumerWaiting.load(std::memory_order_seq_cst))
+    m_hEvent.Set();
+
+  return MSGQ_OK;
+}
+
 MsgQueueReturnCode CDVDMessageQueue::Get(CDVDMsg** pMsg, unsigned int iTimeoutInMilliSeconds, int &priority)
 {
+  if (IsRingMode())
+    return GetRing(pMsg, iTimeoutInMilliSeconds, priority);
+
   CSingleLock lock(m_section);
 
   *pMsg = NULL;
@@ -230,6 +379,210 @@ MsgQueueReturnCode CDVDMessageQueue::Get(CDVDMsg** pMsg, unsigned int iTimeoutIn
   return (MsgQueueReturnCode)ret;
 }
 
+MsgQueueReturnCode CDVDMessageQueue::GetRing(CDVDMsg** pMsg, unsigned int iTimeoutInMilliSeconds, int &priority)
+{
+  *pMsg = NULL;
+
+  if (!m_bInitialized)
+  {
+    CLog::Log(LOGFATAL, "CDVDMessageQueue(%s)::Get MSGQ_NOT_INITIALIZED", m_owner.c_str());
+    return MSGQ_NOT_INITIALIZED;
+  }
+
+  while (!m_bAbortRequest)
+  {
+    if (priority > 0 || m_prioCount > 0)
+    {
+      CSingleLock lock(m_section);
+      if (PopList(m_prioMessages, m_prioCount, pMsg, priority))
+        return MSGQ_OK;
+    }
+    else
+    {
+      if (m_putBackCount > 0)
+      {
+        CSingleLock lock(m_section);
+        if (PopList(m_putBack, m_putBackCount, pMsg, priority))
+          return MSGQ_OK;
+      }
+
+      if (PopRing(pMsg))
+      {
+        priority = 0;
+        return MSGQ_OK;
+      }
+
+      if (m_overflowCount > 0)
+      {
+        CSingleLock lock(m_section);
+        if (PopList(m_messages, m_overflowCount, pMsg, priority))
+        {
+          UpdateTimeBack();
+          return MSGQ_OK;
+        }
+      }
+    }
+
+    if (!iTimeoutInMilliSeconds)
+      return MSGQ_TIMEOUT;
+
+    m_consumerWaiting.store(true, std::memory_order_seq_cst);
+    m_hEvent.Reset();
+
+    // re-check after announcing the wait, a producer may have missed it
+    if (!HasRingData(priority) && !m_bAbortRequest)
+    {
+      bool signaled = m_hEvent.WaitMSec(iTimeoutInMilliSeconds);
+      m_consumerWaiting = false;
+      if (!signaled)
+        return MSGQ_TIMEOUT;
+    }
+    else
+      m_consumerWaiting = false;
+  }
+
+  return MSGQ_ABORT;
+}
+
+bool CDVDMessageQueue::PopRing(CDVDMsg** pMsg)
+{
+  uint64_t tail = m_ringTail.load(std::memory_order_relaxed);
+
+  while (tail != m_ringHead.load(std::memory_order_acquire))
+  {
+    // the put that claimed the slot may not have filled it yet
+    CDVDMsg* msg = m_ring[tail & m_ringMask].load(std::memory_order_acquire);
+    if (!msg)
+      return false;
+
+    m_ring[tail & m_ringMask].store(nullptr, std::memory_order_relaxed);
+    int type = GetTypeIndex(msg);
+    bool flushed = IsRingFlushed(type, tail);
+    m_ringPopped[type]++;
+    int size = GetPacketSize(msg);
+    if (size >= 0)
+      m_ringBytesPopped += size;
+    m_ringTail.store(++tail, std::memory_order_release);
+
+    if (flushed)
+    {
+      msg->Release();
+      continue;
+    }
+
+    // the next message may be one a flush is about to drop
+    CDVDMsg* next = m_ring[tail & m_ringMask].load(std::memory_order_acquire);
+    if (next && !IsRingFlushed(GetTypeIndex(next), tail))
+      UpdateTimeBack(next);
+
+    *pMsg = msg;
+    return true;
+  }
+
+  return false;
+}
+
+bool CDVDMessageQueue::PopList(std::list<DVDMessageListItem> &msgs, std::atomic<int> &count, CDVDMsg** pMsg, int &priority)
+{
+  if (msgs.empty() || (msgs.back().priority < priority && !m_drain))
+    return false;
+
+  DVDMessageListItem& item(msgs.back());
+  priority = item.priority;
+
+  if (item.message->IsType(CDVDMsg::DEMUXER_PACKET) && item.priority == 0)
+  {
+    DemuxPacket* packet = static_cast<CDVDMsgDemuxerPacket*>(item.message)->GetPacket();
+    if (packet)
+      m_iDataSize -= packet->iSize;
+  }
+
+  *pMsg = item.message->Acquire();
+  msgs.pop_back();
+  count--;
+  return true;
+}
+
+bool CDVDMessageQueue::HasRingData(int priority)
+{
+  if (priority > 0 || m_prioCount > 0)
+  {
+    CSingleLock lock(m_section);
+    return !m_prioMessages.empty() && (m_prioMessages.back().priority >= priority || m_drain);
+  }
+
+  // a slot that is claimed but not filled yet doesn't count, its put wakes the consumer once filled
+  return m_putBackCount > 0 || m_overflowCount > 0 ||
+         m_ring[m_ringTail.load(std::memory_order_relaxed) & m_ringMask].load(std::memory_order_seq_cst) != nullptr;
+}
+
+int CDVDMessageQueue::GetTypeIndex(CDVDMsg* pMsg)
+{
+  return pMsg->GetMessageType() - CDVDMsg::NONE;
+}
+
+int CDVDMessageQueue::GetPacketSize(CDVDMsg* pMsg)
+{
+  if (pMsg->IsType(CDVDMsg::DEMUXER_PACKET))
+  {
+    DemuxPacket* packet = static_cast<CDVDMsgDemuxerPacket*>(pMsg)->GetPacket();
+    if (packet)
+      return packet->iSize;
+  }
+  return -1;
+}
+
+bool CDVDMessageQueue::IsRingFlushed(int type, uint64_t position) const
+{
+  return position < m_ringFlushPos[type].load(std::memory_order_acquire);
+}
+
+int CDVDMessageQueue::GetDataSize() const
+{
+  if (!IsRingMode())
+    return m_iDataSize;
+
+  // read the counters the producer moves last
+  uint64_t popped = std::max(m_ringBytesPopped.load(), m_ringBytesFlushed.load());
+  return m_iDataSize + static_cast<int>(m_ringBytesPushed.load() - popped);
+}
+
+void CDVDMessageQueue::UpdateTimeFront(CDVDMsg* pMsg)
+{
+  if (pMsg->IsType(CDVDMsg::DEMUXER_PACKET))
+  {
+    DemuxPacket* packet = static_cast<CDVDMsgDemuxerPacket*>(pMsg)->GetPacket();
+    if (packet)
+    {
+      if (packet->dts != DVD_NOPTS_VALUE)
+        m_TimeFront = packet->dts;
+      else if (packet->pts != DVD_NOPTS_VALUE)
+        m_TimeFront = packet->pts;
+
+      if (m_TimeBack == DVD_NOPTS_VALUE)
+        m_TimeBack = m_TimeFront.load();
+    }
+  }
+}
+
+void CDVDMessageQueue::UpdateTimeBack(CDVDMsg* pMsg)
+{
+  if (pMsg && pMsg->IsType(CDVDMsg::DEMUXER_PACKET))
+  {
+    DemuxPacket* packet = static_cast<CDVDMsgDemuxerPacket*>(pMsg)->GetPacket();
+    if (packet)
+    {
+      if (packet->dts != DVD_NOPTS_VALUE)
+        m_TimeBack = packet->dts;
+      else if (packet->pts != DVD_NOPTS_VALUE)
+        m_TimeBack = packet->pts;
+
+      if (m_TimeFront == DVD_NOPTS_VALUE)
+        m_TimeFront = m_TimeBack.load();
+    }
+  }
+}
+
 void CDVDMessageQueue::UpdateTimeFront()
 {
   if (!m_messages.empty())
@@ -246,7 +599,7 @@ void CDVDMessageQueue::UpdateTimeFront()
           m_TimeFront = packet->pts;
 
         if (m_TimeBack == DVD_NOPTS_VALUE)
-          m_TimeBack = m_TimeFront;
+          m_TimeBack = m_TimeFront.load();
       }
     }
   }
@@ -268,7 +621,7 @@ void CDVDMessageQueue::UpdateTimeBack()
           m_TimeBack = packet->pts;
 
         if (m_TimeFront == DVD_NOPTS_VALUE)
-          m_TimeFront = m_TimeBack;
+          m_TimeFront = m_TimeBack.load();
       }
     }
   }
@@ -293,6 +646,18 @@ unsigned CDVDMessageQueue::GetPacketCount(CDVDMsg::Message type)
       count++;
   }
 
+  if (IsRingMode())
+  {
+    for (const auto &item : m_putBack)
+    {
+      if(item.message->IsType(type))
+        count++;
+    }
+    int index = type - CDVDMsg::NONE;
+    uint64_t popped = std::max(m_ringPopped[index].load(), m_ringFlushed[index].load());
+    count += static_cast<unsigned>(m_ringPushed[index].load() - popped);
+  }
+
   return count;
 }
 
@@ -317,22 +682,31 @@ void CDVDMessageQueue::WaitUntilEmpty()
 
 int CDVDMessageQueue::GetLevel() const
 {
+  // ring mode accounting is atomic, no need to stall producer or consumer
+  if (IsRingMode())
+    return CalcLevel();
+
   CSingleLock lock(m_section);
+  return CalcLevel();
+}
 
-  if (m_iDataSize > m_iMaxDataSize)
+int CDVDMessageQueue::CalcLevel() const
+{
+  int dataSize = GetDataSize();
+  if (dataSize > m_iMaxDataSize)
     return 100;
-  if (m_iDataSize == 0)
+  if (dataSize == 0)
     return 0;
 
   if (IsDataBased())
   {
-    return std::min(100, 100 * m_iDataSize / m_iMaxDataSize);
+    return std::min(100, 100 * dataSize / m_iMaxDataSize);
   }
 
   int level = std::min(100.0, ceil(100.0 * m_TimeSize * (m_TimeFront - m_TimeBack) / DVD_TIME_BASE ));
 
   // if we added lots of packets with NOPTS, make sure that the queue is not signalled empty
-  if (level == 0 && m_iDataSize != 0)
+  if (level == 0 && dataSize != 0)
   {
     CLog::Log(LOGDEBUG, "CDVDMessageQueue::GetLevel() - can't determine level");
     return 1;
@@ -343,8 +717,15 @@ int CDVDMessageQueue::GetLevel() const
 
 int CDVDMessageQueue::GetTimeSize() const
 {
+  if (IsRingMode())
+    return CalcTimeSize();
+
   CSingleLock lock(m_section);
+  return CalcTimeSize();
+}
 
+int CDVDMessageQueue::CalcTimeSize() const
+{
   if (IsDataBased())
     return 0;
   else
@@ -24,7 +24,9 @@
 #include <atomic>
 #include <string>
 #include <list>
+#include <vector>
 #include <algorithm>
+#include <memory>
 #include "threads/CriticalSection.h"
 #include "threads/Event.h"
 
@@ -71,6 +73,17 @@ public:
   explicit CDVDMessageQueue(const std::string &owner);
   virtual ~CDVDMessageQueue();
 
+  /**
+   * Switch normal (priority 0) messages from the locked list to a bounded
+   * ring buffer. The fast path of Put/Get then neither allocates nor locks,
+   * producers claim a slot with a compare and swap. Must be called before
+   * Init(). Gets must come from a single consumer thread,
+   * Flush(CDVDMsg::NONE) only when that consumer is not running.
+   * slots,     ring capacity, rounded up to a power of two, 0 disables
+   */
+  void SetRingMode(unsigned int slots);
+  bool IsRingMode() const { return m_ring != nullptr; }
+
   void Init();
   void Flush(CDVDMsg::Message message = CDVDMsg::DEMUXER_PACKET);
   void Abort();
@@ -91,7 +104,7 @@ public:
     return Get(pMsg, iTimeoutInMilliSeconds, priority);
   }
 
-  int GetDataSize() const { return m_iDataSize; }
+  int GetDataSize() const;
   int GetTimeSize() const;
   unsigned GetPacketCount(CDVDMsg::Message type);
   bool ReceivedAbortRequest() { return m_bAbortRequest; }
@@ -113,17 +126,31 @@ private:
   MsgQueueReturnCode Put(CDVDMsg* pMsg, int priority, bool front);
   void UpdateTimeFront();
   void UpdateTimeBack();
+  int CalcLevel() const;
+  int CalcTimeSize() const;
+
+  // ring mode helpers
+  MsgQueueReturnCode PutRing(CDVDMsg* pMsg);
+  MsgQueueReturnCode GetRing(CDVDMsg** pMsg, unsigned int iTimeoutInMilliSeconds, int &priority);
+  bool PopRing(CDVDMsg** pMsg);
+  bool PopList(std::list<DVDMessageListItem> &msgs, std::atomic<int> &count, CDVDMsg** pMsg, int &priority);
+  bool HasRingData(int priority);
+  void UpdateTimeFront(CDVDMsg* pMsg);
+  void UpdateTimeBack(CDVDMsg* pMsg);
+  static int GetTypeIndex(CDVDMsg* pMsg);
+  static int GetPacketSize(CDVDMsg* pMsg);
+  bool IsRingFlushed(int type, uint64_t position) const;
 
   CEvent m_hEvent;
   mutable CCriticalSection m_section;
 
   std::atomic<bool> m_bAbortRequest;
-  bool m_bInitialized;
-  bool m_drain = false;
+  std::atomic<bool> m_bInitialized;
+  std::atomic<bool> m_drain;
 
-  int m_iDataSize;
-  double m_TimeFront;
-  double m_TimeBack;
+  std::atomic<int> m_iDataSize;
+  std::atomic<double> m_TimeFront;
+  std::atomic<double> m_TimeBack;
   double m_TimeSize;
 
   int m_iMaxDataSize;
@@ -131,5 +158,30 @@ private:
 
   std::list<DVDMessageListItem> m_messages;
   std::list<DVDMessageListItem> m_prioMessages;
+
+  // ring mode, m_messages takes the overflow of a full ring and m_putBack
+  // holds messages pushed back by the consumer
+  static const int MSG_TYPES = 64;
+
+  std::unique_ptr<std::atomic<CDVDMsg*>[]> m_ring; ///< a claimed slot is null until its put filled it
+  uint64_t m_ringMask = 0;
+  alignas(64) std::atomic<uint64_t> m_ringHead;
+  alignas(64) std::atomic<uint64_t> m_ringTail;
+  std::atomic<bool> m_consumerWaiting;
+  std::atomic<int> m_prioCount;
+  std::atomic<int> m_overflowCount;
+  std::atomic<int> m_putBackCount;
+  std::list<DVDMessageListItem> m_putBack;
+
+  // counting the messages per type tells how many are queued, a flush drops
+  // the messages of its type in the slots claimed before it
+  std::atomic<uint64_t> m_ringPushed[MSG_TYPES];
+  std::atomic<uint64_t> m_ringPopped[MSG_TYPES];
+  std::atomic<uint64_t> m_ringFlushed[MSG_TYPES];
+  std::atomic<uint64_t> m_ringFlushPos[MSG_TYPES];
+  // same for the size of demuxer packets, m_iDataSize only counts the lists in ring mode
+  std::atomic<uint64_t> m_ringBytesPushed;
+  std::atomic<uint64_t> m_ringBytesPopped;
+  std::atomic<uint64_t> m_ringBytesFlushed;
 };
 
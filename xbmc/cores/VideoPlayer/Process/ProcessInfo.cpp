@@ -20,6 +20,7 @@
 
 #include "ProcessInfo.h"
 #include "cores/DataCacheCore.h"
+#include "cores/VideoPlayer/DVDDemuxers/DVDDemuxUtils.h"
 #include "settings/AdvancedSettings.h"
 #include "threads/SingleLock.h"
 
@@ -588,6 +589,11 @@ int CProcessInfo::GetLevelVQ()
   return m_levelVQ;
 }
 
+void CProcessInfo::GetDemuxPacketPoolStats(uint64_t &hits, uint64_t &misses)
+{
+  CDVDDemuxUtils::GetPoolStats(hits, misses);
+}
+
 void CProcessInfo::SetGuiRender(bool gui)
 {
   CSingleLock lock(m_stateSection);
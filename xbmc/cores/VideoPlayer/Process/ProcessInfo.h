@@ -108,6 +108,7 @@ public:
   virtual float MaxTempoPlatform();
   void SetLevelVQ(int level);
   int GetLevelVQ();
+  void GetDemuxPacketPoolStats(uint64_t &hits, uint64_t &misses);
   void SetGuiRender(bool gui);
   bool GetGuiRender();
   void SetVideoRender(bool video);
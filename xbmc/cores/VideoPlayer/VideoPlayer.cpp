@@ -1860,7 +1860,7 @@ bool CVideoPlayer::GetCachingTimes(double& level, double& delay, double& offset)
    */
   if (cache_level > 0.8 && cache_level < 0.9 && currate < maxrate)
   {
-    CLog::Log(LOGDEBUG, "Readrate %u is too low with %u required", currate, maxrate);
+    CLog::Log(LOGDEBUG, "Readrate %u is too low with %u required (source delivered %u)", currate, maxrate, status.readrate);
     level = -1.0;                          /* buffer is full & our read rate is too low  */
   }
   else
@@ -80,6 +80,7 @@ CVideoPlayerVideo::CVideoPlayerVideo(CDVDClock* pClock
   m_fForcedAspectRatio = 0;
   m_messageQueue.SetMaxDataSize(40 * 1024 * 1024);
   m_messageQueue.SetMaxTimeSize(8.0);
+  m_messageQueue.SetRingMode(4096);
 
   m_iDroppedFrames = 0;
   m_fFrameRate = 25;
@@ -945,6 +946,11 @@ std::string CVideoPlayerVideo::GetPlayerInfo()
   else
     s << ", pc:none";
 
+  uint64_t hits, misses;
+  m_processInfo.GetDemuxPacketPoolStats(hits, misses);
+  if (hits + misses > 0)
+    s << ", pool:" << 100 * hits / (hits + misses) << "%";
+
   return s.str();
 }
 
@@ -0,0 +1,215 @@
+/*
+ *      Copyright (C) 2018 Team Kodi
+ *      http://kodi.tv
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "cores/VideoPlayer/DVDMessageQueue.h"
+#include "cores/VideoPlayer/DVDDemuxers/DVDDemuxUtils.h"
+#include "cores/VideoPlayer/Interface/Addon/DemuxPacket.h"
+#include "threads/IRunnable.h"
+#include "threads/Thread.h"
+#include "utils/TimeUtils.h"
+
+#include "gtest/gtest.h"
+
+#include <iostream>
+
+namespace
+{
+
+CDVDMsg* CreatePacket(int size, double dts)
+{
+  DemuxPacket* packet = CDVDDemuxUtils::AllocateDemuxPacket(size);
+  packet->dts = dts;
+  return new CDVDMsgDemuxerPacket(packet);
+}
+
+double PacketDts(CDVDMsg* msg)
+{
+  return static_cast<CDVDMsgDemuxerPacket*>(msg)->GetPacket()->dts;
+}
+
+class CQueueProducer : public IRunnable
+{
+public:
+  CQueueProducer(CDVDMessageQueue& queue, int count) : m_queue(queue), m_count(count) {}
+
+  void Run() override
+  {
+    for (int i = 0; i < m_count; i++)
+    {
+      while (m_queue.IsFull())
+        XbmcThreads::ThreadSleep(0);
+      m_queue.Put(CreatePacket(188, i * 1000.0));
+    }
+  }
+
+private:
+  CDVDMessageQueue& m_queue;
+  int m_count;
+};
+
+// producer and consumer on separate threads, returns elapsed time in ms
+double RunThroughput(CDVDMessageQueue& queue, int count, bool& ordered)
+{
+  queue.SetMaxDataSize(4 * 1024 * 1024);
+  queue.Init();
+
+  int64_t start = CurrentHostCounter();
+
+  CQueueProducer producer(queue, count);
+  CThread thread(&producer, "QueueProducer");
+  thread.Create();
+
+  ordered = true;
+  for (int i = 0; i < count; i++)
+  {
+    CDVDMsg* msg = nullptr;
+    if (queue.Get(&msg, 1000) != MSGQ_OK)
+    {
+      ordered = false;
+      break;
+    }
+    if (PacketDts(msg) != i * 1000.0)
+      ordered = false;
+    msg->Release();
+  }
+
+  thread.StopThread(true);
+
+  int64_t elapsed = CurrentHostCounter() - start;
+  queue.End();
+
+  return 1000.0 * elapsed / CurrentHostFrequency();
+}
+
+}
+
+TEST(TestDVDMessageQueue, RingOrder)
+{
+  CDVDMessageQueue queue("test");
+  queue.SetRingMode(8);
+  EXPECT_TRUE(queue.IsRingMode());
+  queue.Init();
+
+  for (int i = 0; i < 4; i++)
+    EXPECT_EQ(MSGQ_OK, queue.Put(CreatePacket(100, i * 1000.0)));
+
+  EXPECT_EQ(400, queue.GetDataSize());
+  EXPECT_EQ(4u, queue.GetPacketCount(CDVDMsg::DEMUXER_PACKET));
+
+  // priority messages and messages pushed back by the consumer come first
+  queue.Put(new CDVDMsg(CDVDMsg::GENERAL_RESYNC), 1);
+  queue.PutBack(CreatePacket(100, -1000.0));
+
+  CDVDMsg* msg = nullptr;
+  int priority = 0;
+  ASSERT_EQ(MSGQ_OK, queue.Get(&msg, 0, priority));
+  EXPECT_TRUE(msg->IsType(CDVDMsg::GENERAL_RESYNC));
+  EXPECT_EQ(1, priority);
+  msg->Release();
+
+  priority = 0;
+  ASSERT_EQ(MSGQ_OK, queue.Get(&msg, 0, priority));
+  EXPECT_EQ(-1000.0, PacketDts(msg));
+  msg->Release();
+
+  for (int i = 0; i < 4; i++)
+  {
+    ASSERT_EQ(MSGQ_OK, queue.Get(&msg, 0));
+    EXPECT_EQ(i * 1000.0, PacketDts(msg));
+    msg->Release();
+  }
+
+  EXPECT_EQ(0, queue.GetDataSize());
+  EXPECT_EQ(MSGQ_TIMEOUT, queue.Get(&msg, 0));
+  queue.End();
+}
+
+TEST(TestDVDMessageQueue, RingOverflow)
+{
+  CDVDMessageQueue queue("test");
+  queue.SetRingMode(4);
+  queue.Init();
+
+  for (int i = 0; i < 10; i++)
+    EXPECT_EQ(MSGQ_OK, queue.Put(CreatePacket(10, i * 1000.0)));
+
+  EXPECT_EQ(100, queue.GetDataSize());
+  EXPECT_EQ(10u, queue.GetPacketCount(CDVDMsg::DEMUXER_PACKET));
+
+  for (int i = 0; i < 10; i++)
+  {
+    CDVDMsg* msg = nullptr;
+    ASSERT_EQ(MSGQ_OK, queue.Get(&msg, 0));
+    EXPECT_EQ(i * 1000.0, PacketDts(msg));
+    msg->Release();
+  }
+  queue.End();
+}
+
+TEST(TestDVDMessageQueue, RingFlush)
+{
+  CDVDMessageQueue queue("test");
+  queue.SetRingMode(16);
+  queue.Init();
+
+  queue.Put(CreatePacket(100, 0.0));
+  queue.Put(new CDVDMsg(CDVDMsg::GENERAL_EOF));
+  queue.Put(CreatePacket(100, 1000.0));
+  queue.Flush();
+
+  EXPECT_EQ(0, queue.GetDataSize());
+  EXPECT_EQ(0u, queue.GetPacketCount(CDVDMsg::DEMUXER_PACKET));
+  EXPECT_EQ(1u, queue.GetPacketCount(CDVDMsg::GENERAL_EOF));
+
+  queue.Put(CreatePacket(100, 2000.0));
+
+  CDVDMsg* msg = nullptr;
+  ASSERT_EQ(MSGQ_OK, queue.Get(&msg, 0));
+  EXPECT_TRUE(msg->IsType(CDVDMsg::GENERAL_EOF));
+  msg->Release();
+
+  ASSERT_EQ(MSGQ_OK, queue.Get(&msg, 0));
+  EXPECT_EQ(2000.0, PacketDts(msg));
+  msg->Release();
+
+  EXPECT_EQ(0, queue.GetDataSize());
+  queue.End();
+}
+
+/* Time taken to pass packets through a list and a ring mode queue.
+ * Run with --gtest_also_run_disabled_tests.
+ */
+TEST(TestDVDMessageQueue, DISABLED_Throughput)
+{
+  const int count = 200000;
+  bool ordered;
+
+  CDVDMessageQueue listQueue("list");
+  double listTime = RunThroughput(listQueue, count, ordered);
+  EXPECT_TRUE(ordered);
+
+  CDVDMessageQueue ringQueue("ring");
+  ringQueue.SetRingMode(4096);
+  double ringTime = RunThroughput(ringQueue, count, ordered);
+  EXPECT_TRUE(ordered);
+
+  std::cout << "DVDMessageQueue " << count << " packets: list " << listTime
+            << " ms, ring " << ringTime << " ms" << std::endl;
+}
@@ -23,6 +23,7 @@
 #include "filesystem/SpecialProtocol.h"
 #include "filesystem/File.h"
 #include "profiles/ProfilesManager.h"
+#include "threads/CriticalSection.h"
 #include "utils/log.h"
 #include "utils/SortUtils.h"
 #include "utils/StringUtils.h"
@@ -39,10 +40,87 @@
 #include "platform/linux/ConvUtils.h"
 #endif
 
+#if defined(TARGET_LINUX) || defined(TARGET_ANDROID)
+#include <sys/statfs.h>
+#elif defined(TARGET_DARWIN) || defined(TARGET_FREEBSD)
+#include <sys/param.h>
+#include <sys/mount.h>
+#endif
+
 using namespace dbiplus;
 
 #define MAX_COMPRESS_COUNT 20
 
+namespace
+{
+/*!
+ Holds the write lock of a pooled database for a write outside of a transaction,
+ so that it waits for the transactions writing to the database to end.
+ */
+class CAutoCommitLock
+{
+public:
+  CAutoCommitLock(const std::string &poolKey, bool inTransaction)
+  {
+    if (!poolKey.empty() && !inTransaction && CServiceBroker::IsServiceManagerUp())
+    {
+      m_writeLock = &CServiceBroker::GetDatabaseManager().GetWriteLock(poolKey);
+      m_writeLock->Lock();
+    }
+  }
+  ~CAutoCommitLock()
+  {
+    if (m_writeLock)
+      m_writeLock->Unlock();
+  }
+  CAutoCommitLock(const CAutoCommitLock&) = delete;
+  CAutoCommitLock& operator=(const CAutoCommitLock&) = delete;
+
+private:
+  CDatabaseWriteLock *m_writeLock = nullptr;
+};
+
+/*!
+ The write ahead log of sqlite relies on shared memory next to the database,
+ which doesn't work for a database on a network share.
+ */
+bool IsLocalFolder(const std::string &folder)
+{
+#if defined(TARGET_LINUX) || defined(TARGET_ANDROID)
+  struct statfs fs;
+  if (statfs(folder.c_str(), &fs) != 0)
+    return false;
+
+  switch (static_cast<unsigned long>(fs.f_type))
+  {
+    case 0x6969: // nfs
+    case 0x517B: // smb
+    case 0xFF534D42: // cifs
+    case 0xFE534D42: // smb2
+    case 0x65735546: // fuse
+    case 0x01021997: // v9fs
+    case 0x00C36400: // ceph
+    case 0x73757245: // coda
+    case 0x5346414F: // afs
+    case 0x564C: // ncp
+    case 0x47504653: // gpfs
+      return false;
+    default:
+      return true;
+  }
+#elif defined(TARGET_DARWIN) || defined(TARGET_FREEBSD)
+  struct statfs fs;
+  if (statfs(folder.c_str(), &fs) != 0)
+    return false;
+
+  return (fs.f_flags & MNT_LOCAL) != 0;
+#else
+  // UNC paths on windows
+  return folder.compare(0, 2, "\\\\") != 0;
+#endif
+}
+}
+
 void CDatabase::Filter::AppendField(const std::string &strField)
 {
   if (strField.empty())
@@ -233,6 +311,7 @@ CDatabase::CDatabase() :
   m_sqlite = true;
   m_bMultiWrite = false;
   m_multipleExecute = false;
+  m_writeLock = nullptr;
 }
 
 CDatabase::~CDatabase(void)
@@ -350,6 +429,7 @@ bool CDatabase::ExecuteQuery(const std::string &strQuery)
   {
     if (NULL == m_pDB.get()) return bReturn;
     if (NULL == m_pDS.get()) return bReturn;
+    CAutoCommitLock writeLock(m_poolKey, m_writeLock != nullptr);
     m_pDS->exec(strQuery);
     bReturn = true;
   }
@@ -412,6 +492,7 @@ bool CDatabase::CommitInsertQueries()
     try
     {
       m_bMultiWrite = false;
+      CAutoCommitLock writeLock(m_poolKey, m_writeLock != nullptr);
       m_pDS2->post();
       m_pDS2->clear_insert_sql();
     }
@@ -449,7 +530,34 @@ bool CDatabase::Open(const DatabaseSettings &settings)
 
   std::string dbName = dbSettings.name;
   dbName += StringUtils::Format("%d", GetSchemaVersion());
-  return Connect(dbName, dbSettings, false);
+
+  // reuse an idle connection to the same database if there is one
+  std::string poolKey = StringUtils::Format("%s://%s@%s:%s/%s", dbSettings.type.c_str(), dbSettings.user.c_str(),
+                                            dbSettings.host.c_str(), dbSettings.port.c_str(), dbName.c_str());
+  std::unique_ptr<Database> connection = CServiceBroker::GetDatabaseManager().AcquireConnection(poolKey);
+  if (connection)
+  {
+    m_pDB = std::move(connection);
+    m_pDS.reset(m_pDB->CreateDataset());
+    m_pDS2.reset(m_pDB->CreateDataset());
+    m_poolKey = poolKey;
+    m_openCount = 1;
+    return true;
+  }
+
+  if (!Connect(dbName, dbSettings, false))
+    return false;
+
+  // count the writes to the database, so that results read from it can be
+  // kept until the tables they came from change
+  m_pDB->setChangeHandler([poolKey](const std::set<std::string> &tables)
+  {
+    if (CServiceBroker::IsServiceManagerUp())
+      CServiceBroker::GetDatabaseManager().OnTablesChanged(poolKey, tables);
+  });
+
+  m_poolKey = poolKey;
+  return true;
 }
 
 void CDatabase::InitSettings(DatabaseSettings &dbSettings)
@@ -564,6 +672,12 @@ bool CDatabase::Connect(const std::string &dbName, const DatabaseSettings &dbSet
     // sqlite3 post connection operations
     if (dbSettings.type == "sqlite3")
     {
+      // write ahead logging lets readers carry on while a transaction writes,
+      // a database on a network share keeps to the rollback journal
+      if (g_advancedSettings.m_databaseWAL && IsLocalFolder(dbSettings.host))
+        m_pDS->exec("PRAGMA journal_mode=WAL\n");
+      else
+        m_pDS->exec("PRAGMA journal_mode=DELETE\n");
       m_pDS->exec("PRAGMA cache_size=4096\n");
       m_pDS->exec("PRAGMA synchronous='NORMAL'\n");
       m_pDS->exec("PRAGMA count_changes='OFF'\n");
@@ -589,6 +703,15 @@ int CDatabase::GetDBVersion()
   return 0;
 }
 
+uint64_t CDatabase::GetChangeVersion(const std::vector<std::string> &tables)
+{
+  // writes by other clients of a database server go unnoticed
+  if (m_poolKey.empty() || !m_sqlite || !CServiceBroker::IsServiceManagerUp())
+    return 0;
+
+  return CServiceBroker::GetDatabaseManager().GetChangeVersion(m_poolKey, tables);
+}
+
 bool CDatabase::IsOpen()
 {
   return m_openCount > 0;
@@ -610,10 +733,22 @@ void CDatabase::Close()
 
   if (NULL == m_pDB.get() ) return ;
   if (NULL != m_pDS.get()) m_pDS->close();
-  m_pDB->disconnect();
-  m_pDB.reset();
   m_pDS.reset();
   m_pDS2.reset();
+
+  if (m_pDB->in_transaction())
+  {
+    CLog::Log(LOGWARNING, "%s - %s closed during a transaction, rolling it back", __FUNCTION__, GetBaseDBName());
+    RollbackTransaction();
+  }
+
+  // hand the connection back to the pool while it is up, otherwise close it
+  if (!m_poolKey.empty() && m_pDB->isActive() && CServiceBroker::IsServiceManagerUp())
+    CServiceBroker::GetDatabaseManager().ReleaseConnection(m_poolKey, std::move(m_pDB));
+  else
+    m_pDB->disconnect();
+  m_pDB.reset();
+  m_poolKey.clear();
 }
 
 bool CDatabase::Compress(bool bForce /* =true */)
@@ -662,11 +797,21 @@ void CDatabase::BeginTransaction()
   try
   {
     if (NULL != m_pDB.get())
+    {
+      // writes to a database go through one transaction at a time, so that
+      // writers queue up here rather than polling the database lock
+      if (!m_poolKey.empty() && !m_writeLock)
+      {
+        m_writeLock = &CServiceBroker::GetDatabaseManager().GetWriteLock(m_poolKey);
+        m_writeLock->Lock();
+      }
       m_pDB->start_transaction();
+    }
   }
   catch (...)
   {
     CLog::Log(LOGERROR, "database:begintransaction failed");
+    ReleaseWriteLock();
   }
 }
 
@@ -680,8 +825,10 @@ bool CDatabase::CommitTransaction()
   catch (...)
   {
     CLog::Log(LOGERROR, "database:committransaction failed");
+    ReleaseWriteLock();
     return false;
   }
+  ReleaseWriteLock();
   return true;
 }
 
@@ -696,6 +843,16 @@ void CDatabase::RollbackTransaction()
   {
     CLog::Log(LOGERROR, "database:rollbacktransaction failed");
   }
+  ReleaseWriteLock();
+}
+
+void CDatabase::ReleaseWriteLock()
+{
+  if (m_writeLock)
+  {
+    m_writeLock->Unlock();
+    m_writeLock = nullptr;
+  }
 }
 
 bool CDatabase::InTransaction()
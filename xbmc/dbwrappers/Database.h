@@ -26,10 +26,12 @@ namespace dbiplus {
 }
 
 #include <memory>
+#include <stdint.h>
 #include <string>
 #include <vector>
 
 class DatabaseSettings; // forward
+class CDatabaseWriteLock;
 class CDbUrl;
 class CProfilesManager;
 struct SortDescription;
@@ -120,6 +122,12 @@ public:
   void CopyDB(const std::string& latestDb);
   void DropAnalytics();
 
+  /*! \brief Get a version of the open database that changes whenever one of the given tables is written to.
+   \param tables lower case names of the tables.
+   \return the version, or 0 if the changes can't be followed, e.g. when other clients share the database on a server.
+   */
+  uint64_t GetChangeVersion(const std::vector<std::string> &tables);
+
   std::string PrepareSQL(std::string strStmt, ...) const;
 
   /*!
@@ -260,10 +268,14 @@ protected:
 private:
   void InitSettings(DatabaseSettings &dbSettings);
   void UpdateVersionNumber();
+  void ReleaseWriteLock();
 
   bool m_bMultiWrite; /*!< True if there are any queries in the queue, false otherwise */
   unsigned int m_openCount;
 
   bool m_multipleExecute;
   std::vector<std::string> m_multipleQueries;
+
+  std::string m_poolKey; ///< \brief the database in the connection pool, empty if the connection isn't pooled
+  CDatabaseWriteLock *m_writeLock; ///< \brief write lock held during a transaction, if any
 };
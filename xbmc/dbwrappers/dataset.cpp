@@ -28,6 +28,7 @@
 
 #include "dataset.h"
 #include "utils/log.h"
+#include <cctype>
 #include <cstring>
 #include <algorithm>
 
@@ -82,6 +83,89 @@ std::string Database::prepare(const char *format, ...)
   return result;
 }
 
+namespace {
+// the lower case word of sql starting at pos, after any blanks; pos is moved past it
+std::string next_word(const std::string &sql, size_t &pos) {
+  while (pos < sql.size() && isspace(static_cast<unsigned char>(sql[pos])))
+    pos++;
+  size_t start = pos;
+  while (pos < sql.size() && !isspace(static_cast<unsigned char>(sql[pos])) && sql[pos] != '(' && sql[pos] != ';')
+    pos++;
+  std::string word = sql.substr(start, pos - start);
+  std::transform(word.begin(), word.end(), word.begin(), ::tolower);
+  return word;
+}
+
+// the table a statement writes to: empty if it doesn't write to one, "*" if
+// it can't be told which
+std::string written_table(const std::string &sql) {
+  size_t pos = 0;
+  std::string word = next_word(sql, pos);
+  if (word == "insert" || word == "replace") {
+    // INSERT [OR REPLACE|IGNORE] INTO table ...
+    for (int i = 0; i < 3 && !word.empty(); i++) {
+      word = next_word(sql, pos);
+      if (word == "into")
+        return next_word(sql, pos);
+    }
+    return "*";
+  }
+  if (word == "update") {
+    // UPDATE [OR REPLACE|IGNORE] table SET ...
+    word = next_word(sql, pos);
+    if (word == "or") {
+      next_word(sql, pos);
+      word = next_word(sql, pos);
+    }
+    return word.empty() ? "*" : word;
+  }
+  if (word == "delete") {
+    word = next_word(sql, pos);
+    return word == "from" ? next_word(sql, pos) : "*";
+  }
+  if (word == "create" || word == "drop" || word == "alter") {
+    // CREATE [TEMP|TEMPORARY] TABLE [IF [NOT] EXISTS] table ...
+    word = next_word(sql, pos);
+    if (word == "temp" || word == "temporary")
+      word = next_word(sql, pos);
+    if (word != "table")
+      return ""; // indices, views and triggers hold no data of their own
+    word = next_word(sql, pos);
+    if (word == "if") {
+      word = next_word(sql, pos);
+      if (word == "not")
+        next_word(sql, pos);
+      word = next_word(sql, pos);
+    }
+    return word;
+  }
+  return "";
+}
+}
+
+void Database::note_change(const std::string &sql) {
+  if (!change_handler)
+    return;
+
+  std::string table = written_table(sql);
+  if (table.empty())
+    return;
+
+  changed_tables.insert(table);
+  if (!in_transaction())
+    flush_changes(true);
+}
+
+void Database::flush_changes(bool committed) {
+  if (changed_tables.empty())
+    return;
+
+  std::set<std::string> tables;
+  tables.swap(changed_tables);
+  if (committed && change_handler)
+    change_handler(tables);
+}
+
 //************* Dataset implementation ***************
 
 Dataset::Dataset():
@@ -29,8 +29,10 @@
 #pragma once
 
 #include <cstdio>
+#include <functional>
 #include <list>
 #include <map>
+#include <set>
 #include <string>
 #include <vector>
 #include "qry_dat.h"
@@ -56,6 +58,10 @@ class Dataset;		// forward declaration of class Dataset
 #define DB_UNEXPECTED		7	// This shouldn't ever happen
 #define DB_UNEXPECTED_RESULT   -1       //For integer functions
 
+/* callback receiving the (lower case) names of the tables written to by a
+   statement or transaction, once it is committed */
+typedef std::function<void(const std::set<std::string>&)> ChangeHandler;
+
 /******************* Class Database definition ********************
 
    represents  connection with database server;
@@ -70,6 +76,8 @@ protected:
     sequence_table, //Sequence table for nextid
     default_charset, //Default character set
     key, cert, ca, capath, ciphers; //SSL - Encryption info
+  ChangeHandler change_handler;
+  std::set<std::string> changed_tables; // tables written to by the open transaction
 
 public:
 /* constructor */
@@ -165,6 +173,17 @@ public:
 
   virtual bool in_transaction() {return false;};
 
+/* methods for tracking changes */
+
+/* sets the callback told about committed changes, or clears it */
+  void setChangeHandler(const ChangeHandler &handler) { change_handler = handler; }
+/* records the table written to by an executed statement. Outside of a
+   transaction the change is reported right away */
+  void note_change(const std::string &sql);
+/* reports the changes recorded during a transaction if it was committed,
+   and forgets them */
+  void flush_changes(bool committed);
+
 };
 
 
@@ -308,6 +327,11 @@ public:
   virtual const void* getExecRes()=0;
 /* as open, but with our query exec Sql */
   virtual bool query(const std::string &sql) = 0;
+/* as query, but rows are only read from the database as the dataset is walked with next(),
+   so just the current row is held in memory. The dataset is forward only: walk it with
+   eof(), next() and get_sql_record() rather than num_rows() or seek().
+   Datasets that can't stream fall back to query() */
+  virtual bool query_stream(const std::string &sql) { return query(sql); }
 /* Close SQL Query*/
   virtual void close();
 /* This function looks for field Field_name with value equal Field_value
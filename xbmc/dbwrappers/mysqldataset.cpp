@@ -517,6 +517,7 @@ void MysqlDatabase::commit_transaction() {
     mysql_autocommit(conn, true);
     CLog::Log(LOGDEBUG,"Mysql commit transaction");
     _in_transaction = false;
+    flush_changes(true);
   }
 }
 
@@ -527,6 +528,7 @@ void MysqlDatabase::rollback_transaction() {
     mysql_autocommit(conn, true);
     CLog::Log(LOGDEBUG,"Mysql rollback transaction");
     _in_transaction = false;
+    flush_changes(false);
   }
 }
 
@@ -1390,6 +1392,7 @@ void MysqlDataset::make_query(StringList &_sql) {
       {
         throw DbErrors(db->getErrorMsg());
       }
+      db->note_change(query);
     } // end of for
 
     if (db->in_transaction() && autocommit) db->commit_transaction();
@@ -1525,6 +1528,7 @@ int MysqlDataset::exec(const std::string &sql) {
   }
   else
   {
+    db->note_change(qry);
     //! @todo collect results and store in exec_res
     return res;
   }
@@ -1575,8 +1579,8 @@ bool MysqlDataset::query(const std::string &query) {
   // returned rows
   while ((row = mysql_fetch_row(stmt)))
   { // have a row of data
-    sql_record *res = new sql_record;
-    res->resize(numColumns);
+    sql_record *res = result.records.add(numColumns);
+    unsigned long *lengths = mysql_fetch_lengths(stmt);
     for (unsigned int i = 0; i < numColumns; i++)
     {
       field_value &v = res->at(i);
@@ -1612,23 +1616,19 @@ bool MysqlDataset::query(const std::string &query) {
         case MYSQL_TYPE_STRING:
         case MYSQL_TYPE_VAR_STRING:
         case MYSQL_TYPE_VARCHAR:
-          if (row[i] != NULL) v.set_asString((const char *)row[i] );
-          break;
         case MYSQL_TYPE_TINY_BLOB:
         case MYSQL_TYPE_MEDIUM_BLOB:
         case MYSQL_TYPE_LONG_BLOB:
         case MYSQL_TYPE_BLOB:
-          if (row[i] != NULL) v.set_asString((const char *)row[i]);
+          if (row[i] != NULL) result.records.set_asString(v, (const char *)row[i], lengths[i]);
           break;
         case MYSQL_TYPE_NULL:
         default:
           CLog::Log(LOGDEBUG,"MYSQL: Unknown field type: %u", fields[i].type);
-          v.set_asString("");
           v.set_isNull();
           break;
       }
     }
-    result.records.push_back(res);
   }
   mysql_free_result(stmt);
   active = true;
@@ -1705,19 +1705,6 @@ void MysqlDataset::next(void) {
       fill_fields();
 }
 
-void MysqlDataset::free_row(void)
-{
-  if (frecno < 0 || (unsigned int)frecno >= result.records.size())
-    return;
-
-  sql_record *row = result.records[frecno];
-  if (row)
-  {
-    delete row;
-    result.records[frecno] = NULL;
-  }
-}
-
 bool MysqlDataset::seek(int pos) {
   if (ds_state == dsSelect)
   {
@@ -35,6 +35,8 @@
 
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
+#include <stdexcept>
 
 #ifndef __GNUC__
 #pragma warning (disable:4800)
@@ -44,124 +46,153 @@
 namespace dbiplus {
 
 //Constructors
-field_value::field_value()
+field_value::field_value() :
+  str_storage(str_Inline),
+  str_len(0),
+  str_capacity(0),
+  str_ptr(NULL)
 {
   field_type = ft_String;
   is_null = false;
+  str_inline[0] = '\0';
 }
 
-field_value::field_value(const char *s):
-  str_value(s)
+field_value::field_value(const char *s) :
+  str_storage(str_Inline),
+  str_len(0),
+  str_capacity(0),
+  str_ptr(NULL)
 {
-  field_type = ft_String;
+  set_asString(s);
   is_null = false;
 }
 
-field_value::field_value(const bool b) {
+field_value::field_value(const bool b) :
+  str_storage(str_Inline),
+  str_len(0),
+  str_capacity(0),
+  str_ptr(NULL)
+{
   bool_value = b;
   field_type = ft_Boolean;
   is_null = false;
 }
 
-field_value::field_value(const char c) {
+field_value::field_value(const char c) :
+  str_storage(str_Inline),
+  str_len(0),
+  str_capacity(0),
+  str_ptr(NULL)
+{
   char_value = c;
   field_type = ft_Char;
   is_null = false;
 }
 
-field_value::field_value(const short s) {
+field_value::field_value(const short s) :
+  str_storage(str_Inline),
+  str_len(0),
+  str_capacity(0),
+  str_ptr(NULL)
+{
   short_value = s;
   field_type = ft_Short;
   is_null = false;
 }
 
-field_value::field_value(const unsigned short us) {
+field_value::field_value(const unsigned short us) :
+  str_storage(str_Inline),
+  str_len(0),
+  str_capacity(0),
+  str_ptr(NULL)
+{
   ushort_value = us;
   field_type = ft_UShort;
   is_null = false;
 }
 
-field_value::field_value(const int i) {
+field_value::field_value(const int i) :
+  str_storage(str_Inline),
+  str_len(0),
+  str_capacity(0),
+  str_ptr(NULL)
+{
   int_value = i;
   field_type = ft_Int;
   is_null = false;
 }
 
-field_value::field_value(const unsigned int ui) {
+field_value::field_value(const unsigned int ui) :
+  str_storage(str_Inline),
+  str_len(0),
+  str_capacity(0),
+  str_ptr(NULL)
+{
   uint_value = ui;
   field_type = ft_UInt;
   is_null = false;
 }
 
-field_value::field_value(const float f) {
+field_value::field_value(const float f) :
+  str_storage(str_Inline),
+  str_len(0),
+  str_capacity(0),
+  str_ptr(NULL)
+{
   float_value = f;
   field_type = ft_Float;
   is_null = false;
 }
 
-field_value::field_value(const double d) {
+field_value::field_value(const double d) :
+  str_storage(str_Inline),
+  str_len(0),
+  str_capacity(0),
+  str_ptr(NULL)
+{
   double_value = d;
   field_type = ft_Double;
   is_null = false;
 }
 
-field_value::field_value(const int64_t i) {
+field_value::field_value(const int64_t i) :
+  str_storage(str_Inline),
+  str_len(0),
+  str_capacity(0),
+  str_ptr(NULL)
+{
   int64_value = i;
   field_type = ft_Int64;
   is_null = false;
 }
 
-field_value::field_value (const field_value & fv) {
-  switch (fv.get_fType()) {
-    case ft_String: {
-      set_asString(fv.get_asString());
-      break;
-    }
-    case ft_Boolean:{
-      set_asBool(fv.get_asBool());
-      break;
-    }
-    case ft_Char: {
-      set_asChar(fv.get_asChar());
-      break;
-    }
-    case ft_Short: {
-      set_asShort(fv.get_asShort());
-      break;
-    }
-    case ft_UShort: {
-      set_asUShort(fv.get_asUShort());
-      break;
-    }
-    case ft_Int: {
-      set_asInt(fv.get_asInt());
-      break;
-    }
-    case ft_UInt: {
-      set_asUInt(fv.get_asUInt());
-      break;
-    }
-    case ft_Float: {
-      set_asFloat(fv.get_asFloat());
-      break;
-    }
-    case ft_Double: {
-      set_asDouble(fv.get_asDouble());
-      break;
-    }
-    case ft_Int64: {
-      set_asInt64(fv.get_asInt64());
-      break;
-    }
-    default:
-      break;
-  }
-  is_null = fv.get_isNull();
+field_value::field_value (const field_value & fv) :
+  str_storage(str_Inline),
+  str_len(0),
+  str_capacity(0),
+  str_ptr(NULL)
+{
+  field_type = ft_String;
+  str_inline[0] = '\0';
+  *this = fv;
 }
 
+field_value::field_value(field_value && fv) noexcept :
+  str_storage(str_Inline),
+  str_len(0),
+  str_capacity(0),
+  str_ptr(NULL)
+{
+  field_type = ft_String;
+  str_inline[0] = '\0';
+  *this = std::move(fv);
+}
 
-//empty destructor
-field_value::~field_value() = default;
+field_value::~field_value()
+{
+  if (str_capacity)
+    delete[] str_ptr;
+}
 
 
 //Conversations functions
@@ -169,7 +200,7 @@ std::string field_value::get_asString() const {
     std::string tmp;
     switch (field_type) {
     case ft_String: {
-      tmp = str_value;
+      tmp.assign(str_value(), str_len);
       return tmp;
     }
     case ft_Boolean:{
@@ -226,7 +257,7 @@ std::string field_value::get_asString() const {
 bool field_value::get_asBool() const {
     switch (field_type) {
     case ft_String: {
-      if (str_value == "True" || str_value == "true" || str_value == "1")
+      if (strcmp(str_value(), "True") == 0 || strcmp(str_value(), "true") == 0 || strcmp(str_value(), "1") == 0)
           return true;
       else
 	return false;
@@ -270,7 +301,7 @@ bool field_value::get_asBool() const {
 char field_value::get_asChar() const {
   switch (field_type) {
     case ft_String: {
-      return str_value[0];
+      return str_value()[0];
     }
     case ft_Boolean:{
       if (bool_value)
@@ -325,7 +356,7 @@ char field_value::get_asChar() const {
 short field_value::get_asShort() const {
     switch (field_type) {
     case ft_String: {
-      return (short)atoi(str_value.c_str());
+      return (short)atoi(str_value());
     }
     case ft_Boolean:{
       return (short)bool_value;
@@ -363,7 +394,7 @@ short field_value::get_asShort() const {
 unsigned short field_value::get_asUShort() const {
     switch (field_type) {
     case ft_String: {
-      return (unsigned short)atoi(str_value.c_str());
+      return (unsigned short)atoi(str_value());
     }
     case ft_Boolean:{
       return (unsigned short)bool_value;
@@ -400,7 +431,7 @@ unsigned short field_value::get_asUShort() const {
 int field_value::get_asInt() const {
     switch (field_type) {
     case ft_String: {
-      return atoi(str_value.c_str());
+      return atoi(str_value());
     }
     case ft_Boolean:{
       return (int)bool_value;
@@ -437,7 +468,7 @@ int field_value::get_asInt() const {
 unsigned int field_value::get_asUInt() const {
     switch (field_type) {
     case ft_String: {
-      return (unsigned int)atoi(str_value.c_str());
+      return (unsigned int)atoi(str_value());
     }
     case ft_Boolean:{
       return (unsigned int)bool_value;
@@ -474,7 +505,7 @@ unsigned int field_value::get_asUInt() const {
 float field_value::get_asFloat() const {
     switch (field_type) {
     case ft_String: {
-      return (float)atof(str_value.c_str());
+      return (float)atof(str_value());
     }
     case ft_Boolean:{
       return (float)bool_value;
@@ -511,7 +542,7 @@ float field_value::get_asFloat() const {
 double field_value::get_asDouble() const {
     switch (field_type) {
     case ft_String: {
-      return atof(str_value.c_str());
+      return atof(str_value());
     }
     case ft_Boolean:{
       return (double)bool_value;
@@ -548,7 +579,7 @@ double field_value::get_asDouble() const {
 int64_t field_value::get_asInt64() const {
     switch (field_type) {
     case ft_String: {
-      return _atoi64(str_value.c_str());
+      return _atoi64(str_value());
     }
     case ft_Boolean:{
       return (int64_t)bool_value;
@@ -586,73 +617,84 @@ int64_t field_value::get_asInt64() const {
 field_value& field_value::operator= (const field_value & fv) {
   if ( this == &fv ) return *this;
 
-  is_null = fv.get_isNull();
+  if (fv.field_type == ft_String)
+    set_asString(fv.str_value(), fv.str_len);
+  else
+  {
+    // the union is copied whole, which covers every type but strings
+    field_type = fv.field_type;
+    memcpy(str_inline, fv.str_inline, sizeof(str_inline));
+  }
+  is_null = fv.is_null;
+  return *this;
+}
 
-  switch (fv.get_fType()) {
-    case ft_String: {
-      set_asString(fv.get_asString());
-      return *this;
-      break;
-    }
-    case ft_Boolean:{
-      set_asBool(fv.get_asBool());
-      return *this;
-      break;
-    }
-    case ft_Char: {
-      set_asChar(fv.get_asChar());
-      return *this;
-      break;
-    }
-    case ft_Short: {
-      set_asShort(fv.get_asShort());
-      return *this;
-      break;
-    }
-    case ft_UShort: {
-      set_asUShort(fv.get_asUShort());
-      return *this;
-      break;
-    }
-    case ft_Int: {
-      set_asInt(fv.get_asInt());
-      return *this;
-      break;
-    }
-    case ft_UInt: {
-      set_asUInt(fv.get_asUInt());
-      return *this;
-      break;
-    }
-    case ft_Float: {
-      set_asFloat(fv.get_asFloat());
-      return *this;
-      break;
-    }
-    case ft_Double: {
-      set_asDouble(fv.get_asDouble());
-      return *this;
-      break;
-    }
-    case ft_Int64: {
-      set_asInt64(fv.get_asInt64());
-      return *this;
-      break;
-    }
-    default:
-      return *this;
-    }
+field_value& field_value::operator= (field_value && fv) noexcept {
+  if ( this == &fv ) return *this;
+
+  if (fv.field_type == ft_String && fv.str_storage == str_Heap)
+  { // take over the text
+    if (str_capacity)
+      delete[] str_ptr;
+    str_ptr = fv.str_ptr;
+    str_capacity = fv.str_capacity;
+    str_len = fv.str_len;
+    str_storage = str_Heap;
+    field_type = ft_String;
+    is_null = fv.is_null;
+    fv.str_ptr = NULL;
+    fv.str_capacity = 0;
+    fv.str_len = 0;
+    fv.str_storage = str_Inline;
+    fv.str_inline[0] = '\0';
+    return *this;
+  }
+
+  return *this = static_cast<const field_value&>(fv);
 }
 
 
 
 //Set functions
 void field_value::set_asString(const char *s) {
-  str_value = s;
-  field_type = ft_String;}
+  set_asString(s, strlen(s));}
 
 void field_value::set_asString(const std::string & s) {
-  str_value = s;
+  set_asString(s.c_str(), s.size());}
+
+void field_value::set_asString(const char *s, unsigned int len) {
+  if (len < FIELD_VALUE_INLINE_STRING)
+  {
+    memmove(str_inline, s, len);
+    str_inline[len] = '\0';
+    str_storage = str_Inline;
+  }
+  else
+  {
+    if (str_capacity <= len)
+    {
+      char *text = new char[len + 1];
+      memcpy(text, s, len);
+      if (str_capacity)
+        delete[] str_ptr;
+      str_ptr = text;
+      str_capacity = len + 1;
+    }
+    else
+      memmove(str_ptr, s, len);
+    str_ptr[len] = '\0';
+    str_storage = str_Heap;
+  }
+  str_len = len;
+  field_type = ft_String;}
+
+void field_value::set_asStringRef(char *s, unsigned int len) {
+  if (str_capacity)
+    delete[] str_ptr;
+  str_capacity = 0;
+  str_ptr = s;
+  str_len = len;
+  str_storage = str_Ref;
   field_type = ft_String;}
 
 void field_value::set_asBool(const bool b) {
@@ -740,4 +782,94 @@ std::string field_value::gft() {
   return tmp;
   }
 
+const field_value &sql_record::at(unsigned int i) const {
+  if (i >= m_size)
+    throw std::out_of_range("sql_record::at");
+  return m_values[i];
+}
+
+field_value &sql_record::at(unsigned int i) {
+  if (i >= m_size)
+    throw std::out_of_range("sql_record::at");
+  return m_values[i];
+}
+
+
+#define QUERY_DATA_VALUES_BLOCK 4096       // field values
+#define QUERY_DATA_TEXT_BLOCK   (64 * 1024) // bytes
+
+query_data::query_data() :
+  m_valuesSize(0),
+  m_valuesUsed(0),
+  m_textSize(0),
+  m_textUsed(0),
+  m_memory(0)
+{
+}
+
+const sql_record *query_data::at(unsigned int row) const {
+  if (row >= m_rows.size())
+    throw std::out_of_range("query_data::at");
+  return &m_rows[row];
+}
+
+sql_record *query_data::at(unsigned int row) {
+  if (row >= m_rows.size())
+    throw std::out_of_range("query_data::at");
+  return &m_rows[row];
+}
+
+sql_record *query_data::add(unsigned int columns) {
+  if (m_values.empty() || m_valuesUsed + columns > m_valuesSize)
+  {
+    // blocks grow with the rows so far, a result of a row or two stays small
+    size_t size = m_rows.size() * columns;
+    if (size > QUERY_DATA_VALUES_BLOCK)
+      size = QUERY_DATA_VALUES_BLOCK;
+    m_valuesSize = size > columns ? size : columns;
+    m_values.emplace_back(new field_value[m_valuesSize]);
+    m_valuesUsed = 0;
+    m_memory += m_valuesSize * sizeof(field_value);
+  }
+  m_rows.emplace_back(m_values.back().get() + m_valuesUsed, columns);
+  m_valuesUsed += columns;
+  m_memory += sizeof(sql_record);
+  return &m_rows.back();
+}
+
+void query_data::set_asString(field_value &value, const char *text, unsigned int len) {
+  if (len < FIELD_VALUE_INLINE_STRING)
+  {
+    value.set_asString(text, len);
+    return;
+  }
+
+  if (m_textUsed + len + 1 > m_textSize)
+  {
+    size_t size = m_text.empty() ? QUERY_DATA_TEXT_BLOCK / 16 : QUERY_DATA_TEXT_BLOCK;
+    m_textSize = len + 1 > size ? len + 1 : size;
+    m_text.emplace_back(new char[m_textSize]);
+    m_textUsed = 0;
+    m_memory += m_textSize;
+  }
+  char *copy = m_text.back().get() + m_textUsed;
+  memcpy(copy, text, len);
+  copy[len] = '\0';
+  m_textUsed += len + 1;
+  value.set_asStringRef(copy, len);
+}
+
+void query_data::clear() {
+  m_rows.clear();
+  m_values.clear();
+  m_valuesSize = m_valuesUsed = 0;
+  m_text.clear();
+  m_textSize = m_textUsed = 0;
+  m_memory = 0;
+}
+
+size_t query_data::memory() const {
+  return m_memory;
+}
+
 } //namespace
@@ -28,7 +28,9 @@
 
 #pragma once
 
+#include <deque>
 #include <map>
+#include <memory>
 #include <vector>
 #include <iostream>
 #include <string>
@@ -59,10 +61,24 @@ enum fType {
 #endif
 
 
+// strings shorter than this are stored inside the field_value
+#define FIELD_VALUE_INLINE_STRING 16
+
 class field_value {
 private:
+  // where the text of a string value is
+  enum strStorage : unsigned char {
+    str_Inline,   // in str_inline
+    str_Heap,     // in str_ptr, owned
+    str_Ref       // in str_ptr, owned by the result set
+  };
+
   fType field_type;
-  std::string str_value;
+  bool is_null;
+  strStorage str_storage;
+  unsigned int str_len;
+  unsigned int str_capacity; // size of an owned str_ptr, kept when a shorter value is set
+  char *str_ptr;
   union {
     bool   bool_value;
     char   char_value;
@@ -74,9 +90,10 @@ private:
     double double_value;
     int64_t int64_value;
     void   *object_value;
+    char   str_inline[FIELD_VALUE_INLINE_STRING];
   } ;
 
-  bool is_null;
+  const char *str_value() const { return str_storage == str_Inline ? str_inline : str_ptr; }
 
 public:
   field_value();
@@ -91,11 +108,16 @@ public:
   explicit field_value(const double d);
   explicit field_value(const int64_t i);
   field_value(const field_value & fv);
+  field_value(field_value && fv) noexcept;
   ~field_value();
 
   fType get_fType() const {return field_type;}
   bool get_isNull() const {return is_null;}
   std::string get_asString() const;
+  /* text of a string value without copying it, valid until the value is changed.
+     Empty for values of other types */
+  const char *get_asCString() const { return field_type == ft_String ? str_value() : ""; }
+  unsigned int get_stringLength() const { return field_type == ft_String ? str_len : 0; }
   bool get_asBool() const;
   char get_asChar() const;
   short get_asShort() const;
@@ -127,6 +149,7 @@ public:
   field_value& operator= (const int64_t i)
     {set_asInt64(i); return *this;}
   field_value& operator= (const field_value & fv);
+  field_value& operator= (field_value && fv) noexcept;
 
   //class ostream;
   friend std::ostream& operator<< (std::ostream& os, const field_value &fv)
@@ -179,8 +202,12 @@ public:
   }
 
   void set_isNull(){is_null=true;}
+  void set_notNull(){is_null=false;}
   void set_asString(const char *s);
   void set_asString(const std::string & s);
+  void set_asString(const char *s, unsigned int len);
+/* refer to text owned by someone else, which must outlive the value */
+  void set_asStringRef(char *s, unsigned int len);
   void set_asBool(const bool b);
   void set_asChar(const char c);
   void set_asShort(const short s);
@@ -212,15 +239,76 @@ struct field {
 
 
 typedef std::vector<field> Fields;
-typedef std::vector<field_value> sql_record;
 typedef std::vector<field_prop> record_prop;
-typedef std::vector<sql_record*> query_data;
 typedef field_value variant;
 
 //typedef Fields::iterator fld_itor;
-typedef sql_record::iterator rec_itor;
 typedef record_prop::iterator recprop_itor;
-typedef query_data::iterator qry_itor;
+
+/* A row of a result set. The values are stored by the result set it belongs to */
+class sql_record
+{
+public:
+  sql_record(field_value *values, unsigned int size) : m_values(values), m_size(size) {}
+
+  unsigned int size() const { return m_size; }
+  bool empty() const { return m_size == 0; }
+
+  field_value &operator[](unsigned int i) { return m_values[i]; }
+  const field_value &operator[](unsigned int i) const { return m_values[i]; }
+  field_value &at(unsigned int i);
+  const field_value &at(unsigned int i) const;
+
+  field_value *begin() { return m_values; }
+  field_value *end() { return m_values + m_size; }
+  const field_value *begin() const { return m_values; }
+  const field_value *end() const { return m_values + m_size; }
+
+private:
+  field_value *m_values;
+  unsigned int m_size;
+};
+
+typedef field_value *rec_itor;
+
+/* The rows of a result set. The values of all the rows, and text too long to be
+   stored inside a value, are kept in a few large blocks rather than allocated per row */
+class query_data
+{
+public:
+  query_data();
+  ~query_data() = default;
+
+  unsigned int size() const { return m_rows.size(); }
+  bool empty() const { return m_rows.empty(); }
+
+  sql_record *operator[](unsigned int row) { return &m_rows[row]; }
+  const sql_record *operator[](unsigned int row) const { return &m_rows[row]; }
+  sql_record *at(unsigned int row);
+  const sql_record *at(unsigned int row) const;
+
+  /* append a row with the given number of columns, each an empty string */
+  sql_record *add(unsigned int columns);
+  /* set value to text that stays valid as long as the rows */
+  void set_asString(field_value &value, const char *text, unsigned int len);
+  void clear();
+
+  /* bytes held for the rows */
+  size_t memory() const;
+
+private:
+  query_data(const query_data&) = delete;
+  query_data& operator=(const query_data&) = delete;
+
+  std::deque<sql_record> m_rows;
+  std::vector<std::unique_ptr<field_value[]>> m_values;
+  unsigned int m_valuesSize;  // values in the last block of m_values
+  unsigned int m_valuesUsed;
+  std::vector<std::unique_ptr<char[]>> m_text;
+  size_t m_textSize;  // bytes in the last block of m_text
+  size_t m_textUsed;
+  size_t m_memory;
+};
 
 class result_set
 {
@@ -234,9 +322,6 @@ public:
   };
   void clear()
   {
-    for (unsigned int i = 0; i < records.size(); i++)
-      if (records[i])
-        delete records[i];
     records.clear();
     record_header.clear();
   };
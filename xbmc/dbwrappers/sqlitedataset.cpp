@@ -28,6 +28,7 @@
 
 #include <iostream>
 #include <string>
+#include <string.h>
 
 #include "sqlitedataset.h"
 #include "utils/log.h"
@@ -56,22 +57,15 @@ int callback(void* res_ptr,int ncol, char** result,char** cols)
 
   if (result != NULL)
   {
-    sql_record *rec = new sql_record;
-    rec->resize(ncol);
+    sql_record *rec = r->records.add(ncol);
     for (int i=0; i<ncol; i++)
     {
       field_value &v = rec->at(i);
       if (result[i] == NULL)
-      {
-        v.set_asString("");
         v.set_isNull();
-      }
       else
-      {
-        v.set_asString(result[i]);
-      }
+        r->records.set_asString(v, result[i], strlen(result[i]));
     }
-    r->records.push_back(rec);
   }
   return 0;
 }
@@ -411,6 +405,7 @@ void SqliteDatabase::commit_transaction() {
   if (active) {
     sqlite3_exec(conn,"commit",NULL,NULL,NULL);
     _in_transaction = false;
+    flush_changes(true);
   }
 }
 
@@ -418,6 +413,7 @@ void SqliteDatabase::rollback_transaction() {
   if (active) {
     sqlite3_exec(conn,"rollback",NULL,NULL,NULL);
     _in_transaction = false;
+    flush_changes(false);
   }
 }
 
@@ -459,6 +455,8 @@ std::string SqliteDatabase::vprepare(const char *format, va_list args)
 SqliteDataset::SqliteDataset():Dataset() {
   haveError = false;
   db = NULL;
+  stream_stmt = NULL;
+  stream_rows = -1;
   errmsg = NULL;
   autorefresh = false;
 }
@@ -467,11 +465,14 @@ SqliteDataset::SqliteDataset():Dataset() {
 SqliteDataset::SqliteDataset(SqliteDatabase *newDb):Dataset(newDb) {
   haveError = false;
   db = newDb;
+  stream_stmt = NULL;
+  stream_rows = -1;
   errmsg = NULL;
   autorefresh = false;
 }
 
  SqliteDataset::~SqliteDataset(){
+   if (stream_stmt) sqlite3_finalize(stream_stmt);
    if (errmsg) sqlite3_free(errmsg);
  }
 
@@ -507,6 +508,7 @@ void SqliteDataset::make_query(StringList &_sql) {
   if (db->setErr(sqlite3_exec(this->handle(),query.c_str(),NULL,NULL,&err),query.c_str())!=SQLITE_OK) {
     throw DbErrors(db->getErrorMsg());
   }
+  db->note_change(query);
   } // end of for
 
 
@@ -630,7 +632,10 @@ int SqliteDataset::exec(const std::string &sql) {
   }
 
   if((res = db->setErr(sqlite3_exec(handle(),qry.c_str(),&callback,&exec_res,&errmsg),qry.c_str())) == SQLITE_OK)
+  {
+    db->note_change(qry);
     return res;
+  }
   else
     {
       throw DbErrors(db->getErrorMsg());
@@ -646,7 +651,7 @@ const void* SqliteDataset::getExecRes() {
 }
 
 
-bool SqliteDataset::query(const std::string &query) {
+sqlite3_stmt *SqliteDataset::prepare_query(const std::string &query) {
     if(!handle()) throw DbErrors("No Database Connection");
     std::string qry = query;
     int fs = qry.find("select");
@@ -666,36 +671,54 @@ bool SqliteDataset::query(const std::string &query) {
   for (unsigned int i = 0; i < numColumns; i++)
     result.record_header[i].name = sqlite3_column_name(stmt, i);
 
+  return stmt;
+}
+
+void SqliteDataset::read_row(sqlite3_stmt *stmt, sql_record &row, query_data *storage) {
+  const unsigned int numColumns = row.size();
+  for (unsigned int i = 0; i < numColumns; i++)
+  {
+    field_value &v = row[i];
+    // a reused row may still hold a null from the previous one
+    v.set_notNull();
+    switch (sqlite3_column_type(stmt, i))
+    {
+    case SQLITE_INTEGER:
+      v.set_asInt64(sqlite3_column_int64(stmt, i));
+      break;
+    case SQLITE_FLOAT:
+      v.set_asDouble(sqlite3_column_double(stmt, i));
+      break;
+    case SQLITE_TEXT:
+    case SQLITE_BLOB:
+    {
+      const char *text = (const char *)sqlite3_column_text(stmt, i);
+      const unsigned int len = text ? sqlite3_column_bytes(stmt, i) : 0;
+      if (!text)
+        text = "";
+      if (storage)
+        storage->set_asString(v, text, len);
+      else
+        v.set_asString(text, len);
+      break;
+    }
+    case SQLITE_NULL:
+    default:
+      v.set_asString("", 0);
+      v.set_isNull();
+      break;
+    }
+  }
+}
+
+bool SqliteDataset::query(const std::string &query) {
+  sqlite3_stmt *stmt = prepare_query(query);
+
   // returned rows
+  const unsigned int numColumns = result.record_header.size();
   while (sqlite3_step(stmt) == SQLITE_ROW)
   { // have a row of data
-    sql_record *res = new sql_record;
-    res->resize(numColumns);
-    for (unsigned int i = 0; i < numColumns; i++)
-    {
-      field_value &v = res->at(i);
-      switch (sqlite3_column_type(stmt, i))
-      {
-      case SQLITE_INTEGER:
-        v.set_asInt64(sqlite3_column_int64(stmt, i));
-        break;
-      case SQLITE_FLOAT:
-        v.set_asDouble(sqlite3_column_double(stmt, i));
-        break;
-      case SQLITE_TEXT:
-        v.set_asString((const char *)sqlite3_column_text(stmt, i));
-        break;
-      case SQLITE_BLOB:
-        v.set_asString((const char *)sqlite3_column_text(stmt, i));
-        break;
-      case SQLITE_NULL:
-      default:
-        v.set_asString("");
-        v.set_isNull();
-        break;
-      }
-    }
-    result.records.push_back(res);
+    read_row(stmt, *result.records.add(numColumns), &result.records);
   }
   if (db->setErr(sqlite3_finalize(stmt),query.c_str()) == SQLITE_OK)
   {
@@ -710,6 +733,39 @@ bool SqliteDataset::query(const std::string &query) {
   }
 }
 
+bool SqliteDataset::query_stream(const std::string &query) {
+  stream_stmt = prepare_query(query);
+  stream_rows = 0;
+
+  // the one row is reused for every row of the result
+  result.records.add(result.record_header.size());
+  frecno = 0;
+  active = true;
+  ds_state = dsSelect;
+  step_stream();
+  return true;
+}
+
+void SqliteDataset::step_stream() {
+  const int res = sqlite3_step(stream_stmt);
+  if (res == SQLITE_ROW)
+  {
+    read_row(stream_stmt, *result.records[0], NULL);
+    stream_rows++;
+    fbof = feof = false;
+    fill_fields();
+    return;
+  }
+
+  fbof = stream_rows == 0;
+  feof = true;
+  const std::string qry = sqlite3_sql(stream_stmt);
+  const int err = sqlite3_finalize(stream_stmt);
+  stream_stmt = NULL;
+  if (res != SQLITE_DONE && db->setErr(err, qry.c_str()) != SQLITE_OK)
+    throw DbErrors(db->getErrorMsg());
+}
+
 void SqliteDataset::open(const std::string &sql) {
   set_select_sql(sql);
   open();
@@ -726,6 +782,12 @@ void SqliteDataset::open() {
 
 
 void SqliteDataset::close() {
+  if (stream_stmt)
+  {
+    sqlite3_finalize(stream_stmt);
+    stream_stmt = NULL;
+  }
+  stream_rows = -1;
   Dataset::close();
   result.clear();
   edit_object->clear();
@@ -746,6 +808,8 @@ void SqliteDataset::cancel() {
 
 
 int SqliteDataset::num_rows() {
+  if (stream_rows >= 0)
+    return stream_rows;
   return result.records.size();
 }
 
@@ -761,40 +825,43 @@ bool SqliteDataset::bof() {
 
 
 void SqliteDataset::first() {
+  if (stream_rows > 1)
+    throw DbErrors("Streaming dataset can't go back to the first row");
+  if (stream_rows >= 0)
+    return;
   Dataset::first();
   this->fill_fields();
 }
 
 void SqliteDataset::last() {
+  if (stream_rows >= 0)
+    throw DbErrors("Streaming dataset can't go to the last row");
   Dataset::last();
   fill_fields();
 }
 
 void SqliteDataset::prev(void) {
+  if (stream_rows >= 0)
+    throw DbErrors("Streaming dataset can't go back");
   Dataset::prev();
   fill_fields();
 }
 
 void SqliteDataset::next(void) {
+  if (stream_rows >= 0)
+  {
+    if (stream_stmt)
+      step_stream();
+    return;
+  }
   Dataset::next();
   if (!eof())
       fill_fields();
 }
 
-void SqliteDataset::free_row(void)
-{
-  if (frecno < 0 || (unsigned int)frecno >= result.records.size())
-    return;
-
-  sql_record *row = result.records[frecno];
-  if (row)
-  {
-    delete row;
-    result.records[frecno] = NULL;
-  }
-}
-
 bool SqliteDataset::seek(int pos) {
+  if (stream_rows >= 0)
+    throw DbErrors("Streaming dataset can't seek");
   if (ds_state == dsSelect) {
     Dataset::seek(pos);
     fill_fields();
@@ -124,8 +124,17 @@ protected:
 /* This function works only with MySQL database
   Filling the fields information from select statement */
   void fill_fields() override;
-/* Changing field values during dataset navigation */
-  virtual void free_row();  // free the memory allocated for the current row
+
+/* Prepares a select statement and sets the column headers of the result */
+  sqlite3_stmt *prepare_query(const std::string &query);
+/* Reads the row the statement is on into row. Text is kept in storage
+   if given, else in the values themselves, which can then be reused */
+  static void read_row(sqlite3_stmt *stmt, sql_record &row, query_data *storage);
+/* Steps a streaming query to its next row */
+  void step_stream();
+
+  sqlite3_stmt *stream_stmt; // statement of a streaming query, until all of its rows are read
+  int stream_rows;           // rows read by a streaming query, -1 when not streaming
 
 public:
 /* constructor */
@@ -148,6 +157,7 @@ or insert() operations default = false) */
   const void* getExecRes() override;
 /* as open, but with our query exec Sql */
   bool query(const std::string &query) override;
+  bool query_stream(const std::string &query) override;
 /* func. closes a query */
   void close(void) override;
 /* Cancel changes, made in insert or edit states of dataset */
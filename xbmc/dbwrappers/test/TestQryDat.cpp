@@ -0,0 +1,131 @@
+/*
+ *      Copyright (C) 2018 Team Kodi
+ *      http://kodi.tv
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this Program; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+
+#include "dbwrappers/qry_dat.h"
+
+#include "gtest/gtest.h"
+
+#include <cstring>
+#include <utility>
+
+using namespace dbiplus;
+
+TEST(TestQryDat, FieldValueTypes)
+{
+  field_value value(static_cast<int64_t>(1234567890123LL));
+  EXPECT_EQ(ft_Int64, value.get_fType());
+  EXPECT_EQ(1234567890123LL, value.get_asInt64());
+  EXPECT_EQ("1234567890123", value.get_asString());
+  EXPECT_STREQ("", value.get_asCString());
+
+  value.set_asDouble(2.5);
+  EXPECT_DOUBLE_EQ(2.5, value.get_asDouble());
+  EXPECT_EQ(2, value.get_asInt());
+
+  value.set_asString("42");
+  EXPECT_EQ(ft_String, value.get_fType());
+  EXPECT_EQ(42, value.get_asInt());
+  EXPECT_EQ(2U, value.get_stringLength());
+  EXPECT_TRUE(field_value("true").get_asBool());
+  EXPECT_FALSE(field_value("false").get_asBool());
+}
+
+TEST(TestQryDat, FieldValueStrings)
+{
+  const std::string shortText("short");
+  const std::string longText("a string that does not fit inside the value");
+
+  field_value value;
+  EXPECT_STREQ("", value.get_asCString());
+
+  value.set_asString(shortText);
+  EXPECT_EQ(shortText, value.get_asString());
+  value.set_asString(longText);
+  EXPECT_EQ(longText, value.get_asString());
+  EXPECT_EQ(longText.size(), value.get_stringLength());
+  value.set_asString(shortText);
+  EXPECT_STREQ(shortText.c_str(), value.get_asCString());
+
+  // switching to another type and back
+  value.set_asString(longText);
+  value.set_asInt(7);
+  EXPECT_EQ(7, value.get_asInt());
+  value.set_asString(shortText);
+  EXPECT_EQ(shortText, value.get_asString());
+
+  // copies and moves own their text
+  value.set_asString(longText);
+  field_value copy(value);
+  value.set_asString(shortText);
+  EXPECT_EQ(longText, copy.get_asString());
+  field_value moved(std::move(copy));
+  EXPECT_EQ(longText, moved.get_asString());
+  copy = moved;
+  EXPECT_EQ(longText, copy.get_asString());
+
+  value.set_isNull();
+  EXPECT_TRUE(value.get_isNull());
+  field_value nullCopy(value);
+  EXPECT_TRUE(nullCopy.get_isNull());
+  value.set_notNull();
+  EXPECT_FALSE(value.get_isNull());
+}
+
+TEST(TestQryDat, QueryData)
+{
+  const std::string longText("a string that is stored by the result set");
+
+  field_value copy;
+  {
+    query_data rows;
+    EXPECT_TRUE(rows.empty());
+    for (int i = 0; i < 10000; i++)
+    {
+      sql_record *row = rows.add(3);
+      ASSERT_EQ(3U, row->size());
+      EXPECT_EQ(ft_String, row->at(0).get_fType());
+      row->at(0).set_asInt(i);
+      rows.set_asString(row->at(1), longText.c_str(), longText.size());
+      rows.set_asString(row->at(2), "short", 5);
+    }
+    ASSERT_EQ(10000U, rows.size());
+    EXPECT_THROW(rows.at(10000), std::out_of_range);
+    EXPECT_THROW(rows.at(0)->at(3), std::out_of_range);
+
+    for (unsigned int i = 0; i < rows.size(); i += 997)
+    {
+      const sql_record *row = rows[i];
+      EXPECT_EQ(static_cast<int>(i), row->at(0).get_asInt());
+      EXPECT_EQ(longText, row->at(1).get_asString());
+      EXPECT_STREQ("short", row->at(2).get_asCString());
+    }
+    // values of all rows live in a few blocks, not a vector per row, at most a block of
+    // values and one of text are left unused
+    EXPECT_LT(rows.memory(), 10000 * (3 * sizeof(field_value) + sizeof(sql_record) + longText.size() + 1) +
+                             4096 * sizeof(field_value) + 64 * 1024);
+
+    copy = rows[5]->at(1);
+    rows.clear();
+    EXPECT_TRUE(rows.empty());
+  }
+  // a copy does not refer to the storage of the result set
+  EXPECT_EQ(longText, copy.get_asString());
+}
@@ -0,0 +1,243 @@
+/*
+ *      Copyright (C) 2018 Team Kodi
+ *      http://kodi.tv
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this Program; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+
+#include "dbwrappers/sqlitedataset.h"
+#include "filesystem/File.h"
+#include "filesystem/SpecialProtocol.h"
+#include "utils/StringUtils.h"
+#include "utils/TimeUtils.h"
+#include "utils/URIUtils.h"
+
+#include "gtest/gtest.h"
+
+#include <iostream>
+#include <memory>
+#include <set>
+
+using namespace dbiplus;
+
+namespace
+{
+const int songCount = 100000;
+
+// bytes held by the rows of a result set
+size_t ResultBytes(const result_set &result)
+{
+  size_t bytes = result.records.memory();
+  for (const auto &header : result.record_header)
+    bytes += sizeof(header) + header.name.capacity();
+  return bytes;
+}
+
+double Seconds(int64_t start)
+{
+  return static_cast<double>(CurrentHostCounter() - start) / CurrentHostFrequency();
+}
+}
+
+class TestSqliteDataset : public ::testing::Test
+{
+protected:
+  SqliteDatabase database;
+  std::unique_ptr<Dataset> dataset;
+
+  void SetUp() override
+  {
+    database.setHostName(CSpecialProtocol::TranslatePath("special://temp/").c_str());
+    database.setDatabase("TestSqliteDataset.db");
+    ASSERT_EQ(DB_CONNECTION_OK, database.connect(true));
+    dataset.reset(database.CreateDataset());
+
+    dataset->exec("CREATE TABLE song (idSong INTEGER PRIMARY KEY, strTitle TEXT, fRating REAL, strComment TEXT)");
+    dataset->exec("INSERT INTO song VALUES (1, 'First', 1.5, NULL)");
+    dataset->exec("INSERT INTO song VALUES (2, 'Second', NULL, 'with comment')");
+    dataset->exec("INSERT INTO song VALUES (3, 'Third', 3.5, NULL)");
+  }
+
+  void TearDown() override
+  {
+    dataset.reset();
+    database.disconnect();
+    XFILE::CFile::Delete(URIUtils::AddFileToFolder(database.getHostName(), database.getDatabase()));
+  }
+
+  void AddSongs(int count)
+  {
+    database.start_transaction();
+    for (int i = 4; i < count; i++)
+      dataset->exec(database.prepare("INSERT INTO song VALUES (%i, 'Song title %i', %f, 'Comment on song %i')",
+                                     i, i, i / 1000.0, i));
+    database.commit_transaction();
+  }
+};
+
+TEST_F(TestSqliteDataset, Stream)
+{
+  ASSERT_TRUE(dataset->query_stream("SELECT * FROM song ORDER BY idSong"));
+
+  ASSERT_FALSE(dataset->eof());
+  const sql_record *record = dataset->get_sql_record();
+  ASSERT_NE(nullptr, record);
+  EXPECT_EQ(1, record->at(0).get_asInt());
+  EXPECT_EQ("First", record->at(1).get_asString());
+  EXPECT_DOUBLE_EQ(1.5, record->at(2).get_asDouble());
+  EXPECT_TRUE(record->at(3).get_isNull());
+
+  dataset->next();
+  ASSERT_FALSE(dataset->eof());
+  record = dataset->get_sql_record();
+  EXPECT_EQ(2, dataset->fv("idSong").get_asInt());
+  EXPECT_TRUE(record->at(2).get_isNull());
+  EXPECT_FALSE(record->at(3).get_isNull());
+  EXPECT_EQ("with comment", record->at(3).get_asString());
+
+  dataset->next();
+  ASSERT_FALSE(dataset->eof());
+  record = dataset->get_sql_record();
+  EXPECT_EQ("Third", record->at(1).get_asString());
+  EXPECT_FALSE(record->at(2).get_isNull());
+  EXPECT_EQ(1U, dataset->get_result_set().records.size());
+
+  dataset->next();
+  EXPECT_TRUE(dataset->eof());
+  EXPECT_EQ(3, dataset->num_rows());
+  dataset->close();
+}
+
+TEST_F(TestSqliteDataset, StreamEmpty)
+{
+  ASSERT_TRUE(dataset->query_stream("SELECT * FROM song WHERE idSong > 3"));
+  EXPECT_TRUE(dataset->eof());
+  EXPECT_EQ(0, dataset->num_rows());
+  dataset->close();
+
+  // the dataset can be used for a normal query again
+  ASSERT_TRUE(dataset->query("SELECT * FROM song"));
+  EXPECT_EQ(3, dataset->num_rows());
+  dataset->close();
+}
+
+TEST_F(TestSqliteDataset, StreamForwardOnly)
+{
+  ASSERT_TRUE(dataset->query_stream("SELECT * FROM song"));
+  dataset->next();
+  EXPECT_THROW(dataset->seek(0), DbErrors);
+  EXPECT_THROW(dataset->prev(), DbErrors);
+  EXPECT_THROW(dataset->first(), DbErrors);
+  dataset->close();
+}
+
+TEST_F(TestSqliteDataset, StreamMatchesQuery)
+{
+  AddSongs(1000);
+
+  ASSERT_TRUE(dataset->query("SELECT * FROM song ORDER BY idSong"));
+  std::vector<std::string> rows;
+  for (; !dataset->eof(); dataset->next())
+  {
+    const sql_record *record = dataset->get_sql_record();
+    rows.push_back(StringUtils::Format("%i|%s|%f", record->at(0).get_asInt(), record->at(1).get_asString().c_str(),
+                                       record->at(2).get_asDouble()));
+  }
+  dataset->close();
+
+  ASSERT_TRUE(dataset->query_stream("SELECT * FROM song ORDER BY idSong"));
+  size_t row = 0;
+  for (; !dataset->eof(); dataset->next(), row++)
+  {
+    const sql_record *record = dataset->get_sql_record();
+    ASSERT_LT(row, rows.size());
+    EXPECT_EQ(rows[row], StringUtils::Format("%i|%s|%f", record->at(0).get_asInt(), record->at(1).get_asString().c_str(),
+                                             record->at(2).get_asDouble()));
+  }
+  dataset->close();
+  EXPECT_EQ(rows.size(), row);
+}
+
+TEST_F(TestSqliteDataset, ChangeHandler)
+{
+  std::vector<std::set<std::string> > changes;
+  database.setChangeHandler([&changes](const std::set<std::string> &tables) { changes.push_back(tables); });
+
+  // outside of a transaction every write is reported on its own
+  dataset->exec("UPDATE song SET fRating = 2.0 WHERE idSong = 1");
+  ASSERT_EQ(1U, changes.size());
+  EXPECT_EQ(std::set<std::string>{ "song" }, changes[0]);
+
+  // reads and indices aren't
+  dataset->exec("CREATE INDEX ix_song_title ON song (strTitle)");
+  ASSERT_TRUE(dataset->query("SELECT * FROM song"));
+  dataset->close();
+  EXPECT_EQ(1U, changes.size());
+
+  // writes in a transaction are reported once it is committed
+  database.start_transaction();
+  dataset->exec("CREATE TABLE album (idAlbum INTEGER PRIMARY KEY, strAlbum TEXT)");
+  dataset->exec("INSERT INTO album (idAlbum, strAlbum) VALUES (1, 'First')");
+  dataset->exec("DELETE FROM song WHERE idSong = 3");
+  EXPECT_EQ(1U, changes.size());
+  database.commit_transaction();
+  ASSERT_EQ(2U, changes.size());
+  EXPECT_EQ((std::set<std::string>{ "album", "song" }), changes[1]);
+
+  // and not at all if it is rolled back
+  database.start_transaction();
+  dataset->exec("INSERT OR REPLACE INTO Album VALUES (2, 'Second')");
+  database.rollback_transaction();
+  EXPECT_EQ(2U, changes.size());
+
+  dataset->exec("insert or replace into Album values (2, 'Second')");
+  ASSERT_EQ(3U, changes.size());
+  EXPECT_EQ(std::set<std::string>{ "album" }, changes[2]);
+
+  database.setChangeHandler(nullptr);
+}
+
+/* Memory held and time taken to walk a large library listing, materialized
+ * vs streamed. Run with --gtest_also_run_disabled_tests.
+ */
+TEST_F(TestSqliteDataset, DISABLED_LargeListing)
+{
+  AddSongs(songCount);
+
+  int64_t start = CurrentHostCounter();
+  ASSERT_TRUE(dataset->query("SELECT * FROM song"));
+  size_t queryBytes = ResultBytes(dataset->get_result_set());
+  int64_t queryIds = 0;
+  for (; !dataset->eof(); dataset->next())
+    queryIds += dataset->get_sql_record()->at(0).get_asInt64();
+  dataset->close();
+  double queryTime = Seconds(start);
+
+  start = CurrentHostCounter();
+  ASSERT_TRUE(dataset->query_stream("SELECT * FROM song"));
+  size_t streamBytes = ResultBytes(dataset->get_result_set());
+  int64_t streamIds = 0;
+  for (; !dataset->eof(); dataset->next())
+    streamIds += dataset->get_sql_record()->at(0).get_asInt64();
+  dataset->close();
+  double streamTime = Seconds(start);
+
+  EXPECT_EQ(queryIds, streamIds);
+  EXPECT_LT(streamBytes, queryBytes);
+  std::cout << songCount << " rows: query " << queryTime * 1000 << " ms, " << queryBytes / 1024 << " KiB held - "
+            << "stream " << streamTime * 1000 << " ms, " << streamBytes / 1024 << " KiB held" << std::endl;
+}
@@ -397,6 +397,11 @@ bool CDoubleCache::IsCachedPosition(int64_t iFilePosition)
   return m_pCache->IsCachedPosition(iFilePosition) || (m_pCacheOld && m_pCacheOld->IsCachedPosition(iFilePosition));
 }
 
+ssize_t CDoubleCache::ReadStored(int64_t iFilePosition, char *pBuffer, size_t iMaxSize)
+{
+  return m_pCache->ReadStored(iFilePosition, pBuffer, iMaxSize);
+}
+
 CCacheStrategy *CDoubleCache::CreateNew()
 {
   return new CDoubleCache(m_pCache->CreateNew());
@@ -64,6 +64,13 @@ public:
   virtual int64_t CachedDataEndPos() = 0;
   virtual bool IsCachedPosition(int64_t iFilePosition) = 0;
 
+  /*!
+   \brief Read data kept from an earlier session instead of the source
+   \param iFilePosition source position to read from
+   \return bytes read, 0 if the position isn't stored
+   */
+  virtual ssize_t ReadStored(int64_t iFilePosition, char *pBuffer, size_t iMaxSize) { return 0; }
+
   virtual CCacheStrategy *CreateNew() = 0;
 
   CEvent m_space;
@@ -130,6 +137,7 @@ public:
   int64_t CachedDataEndPosIfSeekTo(int64_t iFilePosition) override;
   int64_t CachedDataEndPos() override;
   bool IsCachedPosition(int64_t iFilePosition) override;
+  ssize_t ReadStored(int64_t iFilePosition, char *pBuffer, size_t iMaxSize) override;
 
   CCacheStrategy *CreateNew() override;
 
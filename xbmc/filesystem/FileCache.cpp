@@ -25,6 +25,7 @@
 #include "URL.h"
 
 #include "CircularCache.h"
+#include "SegmentCache.h"
 #include "threads/SingleLock.h"
 #include "utils/log.h"
 #include "settings/AdvancedSettings.h"
@@ -90,12 +91,131 @@ private:
   int64_t  m_size;
 };
 
+namespace XFILE
+{
+/*!
+ \brief One outstanding range read on its own source connection, used to
+ keep several requests in flight on high latency sources.
+ */
+class CCacheReadRequest : public CThread
+{
+public:
+  explicit CCacheReadRequest(unsigned int chunkSize)
+    : CThread("FileCacheRead")
+    , m_buffer(new char[chunkSize])
+  {
+  }
+
+  ~CCacheReadRequest() override
+  {
+    StopThread();
+    m_file.Close();
+  }
+
+  bool Open(const std::string& path)
+  {
+    if (!m_file.Open(path, READ_NO_CACHE | READ_TRUNCATED | READ_CHUNKED))
+      return false;
+
+    bool retry = false;
+    m_file.IoControl(IOCTRL_SET_RETRY, &retry);
+
+    Create(false);
+    return true;
+  }
+
+  void Issue(int64_t pos, unsigned int size)
+  {
+    m_pos = pos;
+    m_size = size;
+    m_busy = true;
+    m_request.Set();
+  }
+
+  /*! \brief Wait for the request to complete
+   \return true if done, false on timeout
+   */
+  bool Wait(unsigned int milliSeconds)
+  {
+    if (!m_busy)
+      return true;
+
+    if (!m_done.WaitMSec(milliSeconds))
+      return false;
+
+    m_busy = false;
+    return true;
+  }
+
+  /*! \brief Wait for an outstanding request to complete, its data is dropped
+   \param abort the wait is given up once this is set
+   \return true if done, false if the wait was given up
+   */
+  bool Finish(const std::atomic<bool>& abort)
+  {
+    while (m_busy && !m_done.WaitMSec(100))
+    {
+      if (abort)
+        return false;
+    }
+    m_busy = false;
+    return true;
+  }
+
+  bool IsBusy() const { return m_busy; }
+  int64_t GetPosition() const { return m_pos; }
+  unsigned int GetSize() const { return m_size; }
+  ssize_t GetResult() const { return m_result; }
+  const char* GetData() const { return m_buffer.get(); }
+
+protected:
+  void Process() override
+  {
+    while (!m_bStop)
+    {
+      if (AbortableWait(m_request) != WAIT_SIGNALED)
+        break;
+
+      m_result = 0;
+      if (m_file.GetPosition() == m_pos || m_file.Seek(m_pos, SEEK_SET) == m_pos)
+      {
+        // a short read would leave a hole before the next request
+        while (!m_bStop && m_result < static_cast<ssize_t>(m_size))
+        {
+          ssize_t read = m_file.Read(m_buffer.get() + m_result, m_size - m_result);
+          if (read < 0 && m_result == 0)
+            m_result = read;
+          if (read <= 0)
+            break;
+          m_result += read;
+        }
+      }
+      else
+        m_result = -1;
+
+      m_done.Set();
+    }
+  }
+
+private:
+  CFile m_file;
+  std::unique_ptr<char[]> m_buffer;
+  CEvent m_request;
+  CEvent m_done;
+  std::atomic<bool> m_busy{false};
+  int64_t m_pos = 0;
+  unsigned int m_size = 0;
+  ssize_t m_result = 0;
+};
+}
+
 
 CFileCache::CFileCache(const unsigned int flags)
   : CThread("FileCache")
   , m_pCache(NULL)
   , m_bDeleteCache(true)
   , m_seekPossible(0)
+  , m_seekPending(false)
   , m_nSeekResult(0)
   , m_seekPos(0)
   , m_readPos(0)
@@ -106,16 +226,29 @@ CFileCache::CFileCache(const unsigned int flags)
   , m_forwardCacheSize(0)
   , m_fileSize(0)
   , m_flags(flags)
+  , m_requestHead(0)
+  , m_requestOffset(0)
+  , m_requestPos(0)
+  , m_readBytes(0)
+  , m_readTime(0)
+  , m_readRateActual(0)
 {
 }
 
 CFileCache::CFileCache(CCacheStrategy *pCache, bool bDeleteCache /* = true */)
   : CThread("FileCacheStrategy")
   , m_seekPossible(0)
+  , m_seekPending(false)
   , m_chunkSize(0)
   , m_writeRate(0)
   , m_writeRateActual(0)
   , m_forwardCacheSize(0)
+  , m_requestHead(0)
+  , m_requestOffset(0)
+  , m_requestPos(0)
+  , m_readBytes(0)
+  , m_readTime(0)
+  , m_readRateActual(0)
 {
   m_pCache = pCache;
   m_bDeleteCache = bDeleteCache;
@@ -211,6 +344,16 @@ bool CFileCache::Open(const CURL& url)
       m_forwardCacheSize = front;
     }
 
+    // keep what we fetched on disk, reopening or resuming the file serves it from there.
+    // without a modification time a changed source can't be told apart, so nothing is kept
+    struct __stat64 st = {};
+    if (g_advancedSettings.m_cachePersistentSize > 0 && m_seekPossible > 0 && m_fileSize > 0 &&
+        m_source.Stat(&st) == 0 && st.st_mtime != 0)
+    {
+      const int64_t budget = static_cast<int64_t>(g_advancedSettings.m_cachePersistentSize) * 1024 * 1024;
+      m_pCache = new CSegmentCache(m_pCache, std::make_shared<CSegmentStore>(m_sourcePath, m_fileSize, st.st_mtime, budget));
+    }
+
     if (m_flags & READ_MULTI_STREAM)
     {
       // If READ_MULTI_STREAM flag is set: Double buffering is required
@@ -230,9 +373,16 @@ bool CFileCache::Open(const CURL& url)
   m_writePos = 0;
   m_writeRate = 1024 * 1024;
   m_writeRateActual = 0;
+  m_readBytes = 0;
+  m_readTime = 0;
+  m_readRateActual = 0;
+  m_seekPending = false;
   m_seekEvent.Reset();
   m_seekEnded.Reset();
 
+  if (g_advancedSettings.m_cacheReadAheadRequests > 1 && m_seekPossible > 0 && m_fileSize > 0)
+    OpenPipeline();
+
   CThread::Create(false);
 
   return true;
@@ -257,6 +407,7 @@ void CFileCache::Process()
   CWriteRate limiter;
   CWriteRate average;
   bool cacheReachEOF = false;
+  bool sourceBehind = false;
 
   while (!m_bStop)
   {
@@ -264,13 +415,19 @@ void CFileCache::Process()
     m_fileSize = m_source.GetLength();
 
     // check for seek events
-    if (m_seekEvent.WaitMSec(0))
+    if (m_seekPending)
     {
       m_seekEvent.Reset();
       int64_t cacheMaxPos = m_pCache->CachedDataEndPosIfSeekTo(m_seekPos);
       cacheReachEOF = (cacheMaxPos == m_fileSize);
       bool sourceSeekFailed = false;
-      if (!cacheReachEOF)
+      if (!cacheReachEOF && !m_requests.empty())
+      {
+        if (!ResetPipeline(cacheMaxPos))
+          break; // stopped while waiting for requests
+        m_nSeekResult = cacheMaxPos;
+      }
+      else if (!cacheReachEOF)
       {
         m_nSeekResult = m_source.Seek(cacheMaxPos, SEEK_SET);
         if (m_nSeekResult != cacheMaxPos)
@@ -282,6 +439,7 @@ void CFileCache::Process()
       }
       if (!sourceSeekFailed)
       {
+        sourceBehind = cacheReachEOF;
         const bool bCompleteReset = m_pCache->Reset(m_seekPos, false);
         m_readPos = m_seekPos;
         m_writePos = m_pCache->CachedDataEndPos();
@@ -291,6 +449,7 @@ void CFileCache::Process()
         m_nSeekResult = m_seekPos;
       }
 
+      m_seekPending = false;
       m_seekEnded.Set();
     }
 
@@ -305,12 +464,9 @@ void CFileCache::Process()
       if (limiter.Rate(m_writePos) < m_writeRate * g_advancedSettings.m_cacheReadFactor)
         break;
 
-      if (m_seekEvent.WaitMSec(100))
-      {
-        if (!m_bStop)
-          m_seekEvent.Set();
+      m_seekEvent.WaitMSec(100);
+      if (m_bStop || m_seekPending)
         break;
-      }
     }
 
     size_t maxWrite = m_pCache->GetMaxWriteSize(m_chunkSize);
@@ -325,9 +481,35 @@ void CFileCache::Process()
     }
 
     ssize_t iRead = 0;
+    const char* data = buffer.get();
     if (!cacheReachEOF)
-      iRead = m_source.Read(buffer.get(), maxWrite);
-    if (iRead == 0)
+    {
+      iRead = m_pCache->ReadStored(m_writePos, buffer.get(), maxWrite);
+      if (iRead > 0)
+        sourceBehind = true;
+      else
+      {
+        // the source didn't advance while we served stored data
+        if (sourceBehind)
+        {
+          if (!m_requests.empty())
+          {
+            if (!ResetPipeline(m_writePos))
+              break;
+          }
+          else if (m_source.Seek(m_writePos, SEEK_SET) != m_writePos)
+          {
+            CLog::Log(LOGERROR, "CFileCache::Process - Error seeking source to %" PRId64" after stored data", m_writePos);
+            break;
+          }
+          sourceBehind = false;
+        }
+        iRead = ReadSource(buffer.get(), maxWrite, &data);
+      }
+    }
+    if (iRead == 0 && (m_bStop || m_seekPending))
+      continue; // the read was abandoned, handle the seek first
+    else if (iRead == 0)
     {
       // Check for actual EOF and retry as long as we still have data in our cache
       if (m_writePos < m_fileSize && m_pCache->WaitForData(0, 0) > 0)
@@ -335,11 +517,8 @@ void CFileCache::Process()
         CLog::Log(LOGDEBUG, "CFileCache::Process - Source read didn't return any data! Will retry.");
 
         // Wait a bit:
-        if (m_seekEvent.WaitMSec(5000))
-        {
-          if (!m_bStop)
-            m_seekEvent.Set(); // hack so that later we realize seek is needed
-        }
+        if (!m_seekPending)
+          m_seekEvent.WaitMSec(5000);
 
         // and retry:
         continue; // while (!m_bStop)
@@ -351,14 +530,15 @@ void CFileCache::Process()
         m_pCache->EndOfInput();
 
         // The thread event will now also cause the wait of an event to return a false.
-        if (AbortableWait(m_seekEvent) == WAIT_SIGNALED)
+        while (!m_seekPending)
         {
-          m_pCache->ClearEndOfInput();
-          if (!m_bStop)
-            m_seekEvent.Set(); // hack so that later we realize seek is needed
+          if (AbortableWait(m_seekEvent) != WAIT_SIGNALED)
+            break;
         }
-        else
+        if (!m_seekPending)
           break; // while (!m_bStop)
+
+        m_pCache->ClearEndOfInput();
       }
     }
     else if (iRead < 0) // Fatal error
@@ -367,10 +547,9 @@ void CFileCache::Process()
 
       while (m_pCache->WaitForData(0, 0) > 0)
       {
-        if (m_seekEvent.WaitMSec(100))
-        {
+        m_seekEvent.WaitMSec(100);
+        if (m_bStop || m_seekPending)
           break;
-        }
       }
 
       break; // while (!m_bStop)
@@ -380,7 +559,7 @@ void CFileCache::Process()
     while (!m_bStop && (iTotalWrite < iRead))
     {
       int iWrite = 0;
-      iWrite = m_pCache->WriteToCache(buffer.get() + iTotalWrite, iRead - iTotalWrite);
+      iWrite = m_pCache->WriteToCache(data + iTotalWrite, iRead - iTotalWrite);
 
       // write should always work. all handling of buffering and errors should be
       // done inside the cache strategy. only if unrecoverable error happened, WriteToCache would return error and we break.
@@ -398,12 +577,8 @@ void CFileCache::Process()
       iTotalWrite += iWrite;
 
       // check if seek was asked. otherwise if cache is full we'll freeze.
-      if (m_seekEvent.WaitMSec(0))
-      {
-        if (!m_bStop)
-          m_seekEvent.Set(); // make sure we get the seek event later.
+      if (m_seekPending)
         break;
-      }
     }
 
     m_writePos += iTotalWrite;
@@ -412,6 +587,126 @@ void CFileCache::Process()
     // avoid uncertainty at start of caching
     m_writeRateActual = average.Rate(m_writePos, 1000);
   }
+
+  CLog::Log(LOGDEBUG, "CFileCache::Process - %u outstanding requests, read rate %u B/s, write rate %u B/s",
+            std::max(1u, static_cast<unsigned>(m_requests.size())), m_readRateActual.load(), m_writeRateActual);
+
+  ClosePipeline();
+}
+
+ssize_t CFileCache::ReadSource(char* buffer, size_t size, const char** data)
+{
+  const unsigned start = XbmcThreads::SystemClockMillis();
+  ssize_t iRead;
+
+  if (m_requests.empty())
+  {
+    *data = buffer;
+    iRead = m_source.Read(buffer, size);
+  }
+  else
+  {
+    const size_t count = m_requests.size();
+    CCacheReadRequest* head = m_requests[m_requestHead].get();
+
+    // the rest of the head request may still be handed out
+    if (m_requestOffset == 0)
+    {
+      // keep every request busy, in order of their file position
+      for (size_t i = 0; i < count; i++)
+      {
+        CCacheReadRequest* request = m_requests[(m_requestHead + i) % count].get();
+        if (!request->IsBusy() && m_requestPos < m_fileSize)
+        {
+          request->Issue(m_requestPos, m_chunkSize);
+          m_requestPos += m_chunkSize;
+        }
+      }
+
+      if (!head->IsBusy())
+        return 0; // all requests beyond eof
+
+      while (!head->Wait(100))
+      {
+        if (m_bStop || m_seekPending)
+          return 0;
+      }
+    }
+
+    const ssize_t result = head->GetResult();
+    if (result <= 0)
+    {
+      ResetPipeline(head->GetPosition());
+      return result;
+    }
+
+    iRead = std::min(static_cast<ssize_t>(size), result - static_cast<ssize_t>(m_requestOffset));
+    *data = head->GetData() + m_requestOffset;
+    m_requestOffset += iRead;
+
+    if (m_requestOffset == static_cast<size_t>(result))
+    {
+      m_requestOffset = 0;
+      // a short read leaves a hole before the requests behind it
+      if (result < static_cast<ssize_t>(head->GetSize()))
+        ResetPipeline(head->GetPosition() + result);
+      else
+        m_requestHead = (m_requestHead + 1) % count;
+    }
+  }
+
+  if (iRead > 0)
+  {
+    m_readBytes += iRead;
+    m_readTime += XbmcThreads::SystemClockMillis() - start;
+    if (m_readTime > 0)
+      m_readRateActual = static_cast<unsigned>(1000 * m_readBytes / m_readTime);
+  }
+
+  return iRead;
+}
+
+bool CFileCache::OpenPipeline()
+{
+  for (unsigned int i = 0; i < g_advancedSettings.m_cacheReadAheadRequests; i++)
+  {
+    std::unique_ptr<CCacheReadRequest> request(new CCacheReadRequest(m_chunkSize));
+    if (!request->Open(m_sourcePath))
+    {
+      CLog::Log(LOGDEBUG, "CFileCache::OpenPipeline - unable to open additional connection, using sequential reads");
+      ClosePipeline();
+      return false;
+    }
+    m_requests.push_back(std::move(request));
+  }
+
+  m_requestHead = 0;
+  m_requestOffset = 0;
+  m_requestPos = 0;
+  return true;
+}
+
+bool CFileCache::ResetPipeline(int64_t pos)
+{
+  // outstanding data can't be cancelled, wait and drop it
+  for (auto& request : m_requests)
+  {
+    if (!request->Finish(m_bStop))
+      return false;
+  }
+
+  m_requestHead = 0;
+  m_requestOffset = 0;
+  m_requestPos = pos;
+  return true;
+}
+
+void CFileCache::ClosePipeline()
+{
+  // let requests stuck in a read stop all at once
+  for (auto& request : m_requests)
+    request->StopThread(false);
+  m_requests.clear();
 }
 
 void CFileCache::OnExit()
@@ -510,6 +805,7 @@ int64_t CFileCache::Seek(int64_t iFilePosition, int iWhence)
     /* never request closer to end than 2k, speeds up tag reading */
     m_seekPos = std::min(iTarget, std::max((int64_t)0, m_fileSize - m_chunkSize));
 
+    m_seekPending = true;
     m_seekEvent.Set();
     if (!m_seekEnded.Wait())
     {
@@ -529,7 +825,6 @@ int64_t CFileCache::Seek(int64_t iFilePosition, int iWhence)
       m_pCache->Seek(iTarget);
     }
     m_readPos = iTarget;
-    m_seekEvent.Reset();
   }
   else
     m_readPos = iTarget;
@@ -540,6 +835,7 @@ int64_t CFileCache::Seek(int64_t iFilePosition, int iWhence)
 void CFileCache::Close()
 {
   StopThread();
+  ClosePipeline();
 
   CSingleLock lock(m_sync);
   if (m_pCache)
@@ -583,6 +879,7 @@ int CFileCache::IoControl(EIoControl request, void* param)
     status->level   = (m_forwardCacheSize == 0) ? 0.0 : (float) status->forward / m_forwardCacheSize;
     status->maxrate = m_writeRate;
     status->currate = m_writeRateActual;
+    status->readrate = m_readRateActual;
     return 0;
   }
 
@@ -26,9 +26,12 @@
 #include "File.h"
 #include "threads/Thread.h"
 #include <atomic>
+#include <memory>
+#include <vector>
 
 namespace XFILE
 {
+  class CCacheReadRequest;
 
   class CFileCache : public IFile, public CThread
   {
@@ -68,6 +71,18 @@ namespace XFILE
     }
 
   private:
+    /*! \brief Read the next chunk from the source, either directly or from
+     the pipeline of outstanding range requests.
+     \param buffer buffer to use for a direct read
+     \param size maximum size of a direct read
+     \param data set to the start of the data read
+     \return bytes read, 0 on EOF or < 0 on error
+     */
+    ssize_t ReadSource(char* buffer, size_t size, const char** data);
+    bool OpenPipeline();
+    bool ResetPipeline(int64_t pos);
+    void ClosePipeline();
+
     CCacheStrategy *m_pCache;
     bool m_bDeleteCache;
     int m_seekPossible;
@@ -75,6 +90,7 @@ namespace XFILE
     std::string m_sourcePath;
     CEvent m_seekEvent;
     CEvent m_seekEnded;
+    std::atomic<bool> m_seekPending; ///< a seek waits for the cache thread, m_seekEvent only wakes it up
     int64_t m_nSeekResult;
     int64_t m_seekPos;
     int64_t m_readPos;
@@ -86,6 +102,14 @@ namespace XFILE
     std::atomic<int64_t> m_fileSize;
     unsigned int m_flags;
     CCriticalSection m_sync;
+
+    std::vector<std::unique_ptr<CCacheReadRequest>> m_requests;
+    size_t m_requestHead;
+    size_t m_requestOffset; ///< bytes of the head request handed out already
+    int64_t m_requestPos;
+    int64_t m_readBytes;
+    unsigned m_readTime;
+    std::atomic<unsigned> m_readRateActual;
   };
 
 }
@@ -64,6 +64,7 @@ struct SCacheStatus
   unsigned maxrate;  /**< maximum number of bytes per second cache is allowed to fill */
   unsigned currate;  /**< average read rate from source file since last position change */
   float    level;    /**< cache level (0.0 - 1.0) */
+  unsigned readrate; /**< rate achieved while actually reading from source, excluding throttling */
 };
 
 typedef enum {
@@ -19,8 +19,14 @@
  */
 
 #include "DirectoryNodeSong.h"
+
+#include <limits>
+
 #include "QueryParams.h"
 #include "music/MusicDatabase.h"
+#include "music/MusicDbUrl.h"
+#include "utils/SortUtils.h"
+#include "utils/Variant.h"
 
 using namespace XFILE::MUSICDATABASEDIRECTORY;
 
@@ -40,7 +46,46 @@ bool CDirectoryNodeSong::GetContent(CFileItemList& items) const
   CollectQueryParams(params);
 
   std::string strBaseDir=BuildPath();
-  bool bSuccess=musicdatabase.GetSongsNav(strBaseDir, items, params.GetGenreId(), params.GetArtistId(), params.GetAlbumId());
+
+  // The "pagesize" option asks for one page of the listing, sorted by the database
+  // with the "sortby", "sortorder" and "ignorearticle" options. A page size of 0
+  // asks for all songs from "pagestart" on. Sort methods the database can't apply
+  // are ignored and the whole listing is returned instead.
+  SortDescription sorting;
+  bool paged = false;
+  CMusicDbUrl musicUrl;
+  if (musicUrl.FromString(strBaseDir) && musicUrl.HasOption("pagesize"))
+  {
+    const CUrlOptions::UrlOptions& options = musicUrl.GetOptions();
+    auto option = [&options](const std::string& key)
+    {
+      auto it = options.find(key);
+      return it != options.end() ? it->second : CVariant();
+    };
+
+    sorting.sortBy = SortUtils::SortMethodFromString(option("sortby").asString());
+    sorting.sortOrder = SortUtils::SortOrderFromString(option("sortorder").asString());
+    if (option("ignorearticle").asBoolean())
+      sorting.sortAttributes = SortAttributeIgnoreArticle;
+    const int pageSize = static_cast<int>(option("pagesize").asInteger());
+    sorting.limitStart = static_cast<int>(option("pagestart").asInteger());
+    sorting.limitEnd = pageSize > 0 ? sorting.limitStart + pageSize : std::numeric_limits<int>::max();
+
+    std::vector<std::string> orderFields;
+    paged = sorting.limitEnd > sorting.limitStart && musicdatabase.GetSongsOrderFields(sorting, orderFields);
+    if (!paged)
+      sorting = SortDescription();
+
+    for (const auto& key : { "pagesize", "pagestart", "sortby", "sortorder", "ignorearticle" })
+      musicUrl.RemoveOption(key);
+    strBaseDir = musicUrl.ToString();
+  }
+
+  bool bSuccess=musicdatabase.GetSongsNav(strBaseDir, items, params.GetGenreId(), params.GetArtistId(), params.GetAlbumId(), sorting);
+
+  // let the caller know there are more songs to fetch after this page
+  if (bSuccess && paged && items.GetProperty("total").asInteger() > sorting.limitEnd)
+    items.SetProperty("paged", true);
 
   musicdatabase.Close();
 
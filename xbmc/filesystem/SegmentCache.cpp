@@ -0,0 +1,446 @@
+/*
+ *      Copyright (C) 2018 Team Kodi
+ *      http://kodi.tv
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this Program; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "SegmentCache.h"
+#include "Directory.h"
+#include "FileItem.h"
+#include "SpecialProtocol.h"
+#include "URL.h"
+#include "threads/SingleLock.h"
+#include "threads/SystemClock.h"
+#include "utils/JobManager.h"
+#include "utils/Digest.h"
+#include "utils/StringUtils.h"
+#include "utils/URIUtils.h"
+#include "utils/log.h"
+
+#include <algorithm>
+#include <utility>
+
+using namespace XFILE;
+using KODI::UTILITY::CDigest;
+
+#define SEGMENT_CACHE_ROOT "special://temp/segmentcache/"
+#define SEGMENT_CACHE_STAMP "lastused"
+// suffix of a store being removed, left behind if removing it failed
+#define SEGMENT_CACHE_REMOVED ".removed"
+// minimum time between two scans of the store for eviction (in ms)
+#define SEGMENT_CACHE_EVICT_INTERVAL 60000
+
+namespace
+{
+// shared by all stores, guards the members below
+CCriticalSection storeSection;
+// keys of the stores currently open, these are never evicted
+std::multiset<std::string> openStores;
+// size of the whole store in bytes, -1 until it was scanned
+int64_t storedBytes = -1;
+bool evictPending = false;
+unsigned int lastEvict = 0;
+}
+
+const int64_t CSegmentStore::SEGMENT_SIZE;
+
+CSegmentStore::CSegmentStore(const std::string& url, int64_t size, int64_t mtime, int64_t budget)
+  : m_fileSize(size)
+  , m_budget(budget)
+{
+  m_key = CDigest::Calculate(CDigest::Type::MD5, StringUtils::Format("%s|%" PRId64"|%" PRId64, url.c_str(), size, mtime));
+  m_directory = URIUtils::AddFileToFolder(SEGMENT_CACHE_ROOT, m_key);
+}
+
+CSegmentStore::~CSegmentStore()
+{
+  Close();
+}
+
+bool CSegmentStore::Open()
+{
+  CSingleLock lock(m_section);
+
+  m_stored.clear();
+  m_pending.clear();
+  m_pendingIndex = -1;
+
+  // registered before the directory is touched, so eviction leaves it alone
+  if (!m_registered)
+  {
+    CSingleLock storeLock(storeSection);
+    openStores.insert(m_key);
+    m_registered = true;
+  }
+  RequestEvict(m_budget);
+
+  if (!CDirectory::Exists(m_directory))
+  {
+    CDirectory::Create(SEGMENT_CACHE_ROOT);
+    if (!CDirectory::Create(m_directory))
+    {
+      CLog::Log(LOGERROR, "CSegmentStore::Open - unable to create %s", m_directory.c_str());
+      return false;
+    }
+  }
+  else
+  {
+    CFileItemList items;
+    CDirectory::GetDirectory(m_directory, items, ".seg", DIR_FLAG_NO_FILE_DIRS | DIR_FLAG_BYPASS_CACHE);
+    for (int i = 0; i < items.Size(); i++)
+    {
+      const std::string name = URIUtils::GetFileName(items[i]->GetPath());
+      int64_t index = strtoll(name.c_str(), nullptr, 10);
+      int64_t expected = std::min(SEGMENT_SIZE, m_fileSize - index * SEGMENT_SIZE);
+      if (index >= 0 && items[i]->m_dwSize == expected)
+        m_stored.insert(index);
+    }
+    CLog::Log(LOGDEBUG, "CSegmentStore::Open - %u stored segments in %s", static_cast<unsigned>(m_stored.size()), m_directory.c_str());
+  }
+
+  // the stamp's modification time drives the lru eviction
+  CFile stamp;
+  if (stamp.OpenForWrite(URIUtils::AddFileToFolder(m_directory, SEGMENT_CACHE_STAMP), true))
+  {
+    stamp.Write("1", 1);
+    stamp.Close();
+  }
+
+  return true;
+}
+
+void CSegmentStore::Close()
+{
+  CSingleLock lock(m_section);
+
+  m_readFile.Close();
+  m_readIndex = -1;
+  m_pending.clear();
+  m_pendingIndex = -1;
+
+  if (m_registered)
+  {
+    CSingleLock storeLock(storeSection);
+    openStores.erase(openStores.find(m_key));
+    m_registered = false;
+  }
+}
+
+std::string CSegmentStore::GetSegmentPath(int64_t index) const
+{
+  return URIUtils::AddFileToFolder(m_directory, StringUtils::Format("%08" PRId64".seg", index));
+}
+
+bool CSegmentStore::IsStored(int64_t pos)
+{
+  CSingleLock lock(m_section);
+  return m_stored.find(pos / SEGMENT_SIZE) != m_stored.end();
+}
+
+void CSegmentStore::Write(int64_t pos, const char* data, size_t size)
+{
+  CSingleLock lock(m_section);
+
+  while (size > 0 && pos < m_fileSize)
+  {
+    int64_t index = pos / SEGMENT_SIZE;
+    int64_t offset = pos % SEGMENT_SIZE;
+    size_t len = static_cast<size_t>(std::min<int64_t>(size, SEGMENT_SIZE - offset));
+
+    if (m_pendingIndex != index || static_cast<int64_t>(m_pending.size()) != offset)
+    {
+      // only segments collected from their start are stored
+      m_pending.clear();
+      m_pendingIndex = -1;
+      if (offset == 0 && m_stored.find(index) == m_stored.end())
+        m_pendingIndex = index;
+    }
+
+    if (m_pendingIndex == index)
+    {
+      m_pending.insert(m_pending.end(), data, data + len);
+      if (static_cast<int64_t>(m_pending.size()) == std::min(SEGMENT_SIZE, m_fileSize - index * SEGMENT_SIZE))
+        StorePending();
+    }
+
+    pos += len;
+    data += len;
+    size -= len;
+  }
+}
+
+void CSegmentStore::StorePending()
+{
+  const int64_t size = static_cast<int64_t>(m_pending.size());
+
+  // reserve the space up front, nothing is stored before the store was scanned
+  bool fits;
+  {
+    CSingleLock storeLock(storeSection);
+    fits = storedBytes >= 0 && storedBytes + size <= m_budget;
+    if (fits)
+      storedBytes += size;
+  }
+  if (!fits)
+  {
+    RequestEvict(m_budget);
+    m_pending.clear();
+    m_pendingIndex = -1;
+    return;
+  }
+
+  const std::string path = GetSegmentPath(m_pendingIndex);
+  const std::string tmpPath = path + ".tmp";
+
+  // write to a temporary name first, a crash must not leave a short segment
+  CFile file;
+  bool written = false;
+  if (file.OpenForWrite(tmpPath, true))
+  {
+    written = file.Write(m_pending.data(), m_pending.size()) == static_cast<ssize_t>(m_pending.size());
+    file.Close();
+  }
+
+  if (written && CFile::Rename(tmpPath, path))
+    m_stored.insert(m_pendingIndex);
+  else
+  {
+    CLog::Log(LOGWARNING, "CSegmentStore::StorePending - unable to store %s", path.c_str());
+    CFile::Delete(tmpPath);
+
+    CSingleLock storeLock(storeSection);
+    storedBytes -= size;
+  }
+
+  m_pending.clear();
+  m_pendingIndex = -1;
+}
+
+ssize_t CSegmentStore::Read(int64_t pos, char* buffer, size_t size)
+{
+  CSingleLock lock(m_section);
+
+  int64_t index = pos / SEGMENT_SIZE;
+  if (m_stored.find(index) == m_stored.end())
+    return 0;
+
+  if (m_readIndex != index)
+  {
+    m_readFile.Close();
+    m_readIndex = -1;
+    if (!m_readFile.Open(GetSegmentPath(index), READ_NO_CACHE))
+    {
+      m_stored.erase(index);
+      return 0;
+    }
+    m_readIndex = index;
+  }
+
+  int64_t offset = pos % SEGMENT_SIZE;
+  if (m_readFile.Seek(offset, SEEK_SET) != offset)
+    return 0;
+
+  size = static_cast<size_t>(std::min<int64_t>(size, m_readFile.GetLength() - offset));
+  ssize_t read = m_readFile.Read(buffer, size);
+  return std::max<ssize_t>(read, 0);
+}
+
+void CSegmentStore::RequestEvict(int64_t budget)
+{
+  {
+    CSingleLock storeLock(storeSection);
+    const unsigned int now = XbmcThreads::SystemClockMillis();
+    if (evictPending || (storedBytes >= 0 && now - lastEvict < SEGMENT_CACHE_EVICT_INTERVAL))
+      return;
+    evictPending = true;
+    lastEvict = now;
+  }
+
+  CJobManager::GetInstance().Submit([budget]() {
+    Evict(budget);
+
+    CSingleLock storeLock(storeSection);
+    evictPending = false;
+  }, CJob::PRIORITY_LOW_PAUSABLE);
+}
+
+void CSegmentStore::Evict(int64_t budget)
+{
+  CFileItemList sources;
+  if (!CDirectory::GetDirectory(SEGMENT_CACHE_ROOT, sources, "", DIR_FLAG_NO_FILE_DIRS | DIR_FLAG_BYPASS_CACHE))
+  {
+    // nothing stored yet
+    CSingleLock storeLock(storeSection);
+    storedBytes = 0;
+    return;
+  }
+
+  struct Source
+  {
+    std::string path;
+    CDateTime used;
+    int64_t size;
+  };
+  std::vector<Source> entries;
+  int64_t total = 0;
+
+  for (int i = 0; i < sources.Size(); i++)
+  {
+    if (!sources[i]->m_bIsFolder)
+      continue;
+
+    CFileItemList files;
+    CDirectory::GetDirectory(sources[i]->GetPath(), files, "", DIR_FLAG_NO_FILE_DIRS | DIR_FLAG_BYPASS_CACHE);
+
+    Source entry = { sources[i]->GetPath(), sources[i]->m_dateTime, 0 };
+    for (int j = 0; j < files.Size(); j++)
+    {
+      entry.size += files[j]->m_dwSize;
+      if (URIUtils::GetFileName(files[j]->GetPath()) == SEGMENT_CACHE_STAMP)
+        entry.used = files[j]->m_dateTime;
+    }
+    total += entry.size;
+    entries.push_back(entry);
+  }
+
+  std::sort(entries.begin(), entries.end(), [](const Source& a, const Source& b) { return a.used < b.used; });
+
+  for (const auto& entry : entries)
+  {
+    if (total <= budget)
+      break;
+
+    std::string path = entry.path;
+    URIUtils::RemoveSlashAtEnd(path);
+    std::string removed = path;
+    if (!StringUtils::EndsWith(path, SEGMENT_CACHE_REMOVED))
+    {
+      // the store is moved out of the way while held, a store opened afterwards starts
+      // out empty and the files are deleted without holding up the stores being opened
+      CSingleLock storeLock(storeSection);
+      if (openStores.find(URIUtils::GetFileName(path)) != openStores.end())
+        continue;
+      removed += SEGMENT_CACHE_REMOVED;
+      if (!CFile::Rename(path, removed))
+        continue;
+    }
+
+    CLog::Log(LOGDEBUG, "CSegmentStore::Evict - removing %s", entry.path.c_str());
+    if (CDirectory::RemoveRecursive(removed))
+      total -= entry.size;
+  }
+
+  CSingleLock storeLock(storeSection);
+  storedBytes = total;
+}
+
+CSegmentCache::CSegmentCache(CCacheStrategy *impl, std::shared_ptr<CSegmentStore> store)
+  : m_pCache(impl)
+  , m_store(std::move(store))
+{
+}
+
+CSegmentCache::~CSegmentCache()
+{
+  delete m_pCache;
+}
+
+int CSegmentCache::Open()
+{
+  m_store->Open();
+  return m_pCache->Open();
+}
+
+void CSegmentCache::Close()
+{
+  m_pCache->Close();
+  m_store->Close();
+}
+
+size_t CSegmentCache::GetMaxWriteSize(const size_t& iRequestSize)
+{
+  return m_pCache->GetMaxWriteSize(iRequestSize);
+}
+
+int CSegmentCache::WriteToCache(const char *pBuffer, size_t iSize)
+{
+  int64_t pos = m_pCache->CachedDataEndPos();
+  int written = m_pCache->WriteToCache(pBuffer, iSize);
+  if (written > 0)
+    m_store->Write(pos, pBuffer, written);
+  return written;
+}
+
+int CSegmentCache::ReadFromCache(char *pBuffer, size_t iMaxSize)
+{
+  return m_pCache->ReadFromCache(pBuffer, iMaxSize);
+}
+
+int64_t CSegmentCache::WaitForData(unsigned int iMinAvail, unsigned int iMillis)
+{
+  return m_pCache->WaitForData(iMinAvail, iMillis);
+}
+
+int64_t CSegmentCache::Seek(int64_t iFilePosition)
+{
+  return m_pCache->Seek(iFilePosition);
+}
+
+bool CSegmentCache::Reset(int64_t iSourcePosition, bool clearAnyway)
+{
+  return m_pCache->Reset(iSourcePosition, clearAnyway);
+}
+
+void CSegmentCache::EndOfInput()
+{
+  m_pCache->EndOfInput();
+}
+
+bool CSegmentCache::IsEndOfInput()
+{
+  return m_pCache->IsEndOfInput();
+}
+
+void CSegmentCache::ClearEndOfInput()
+{
+  m_pCache->ClearEndOfInput();
+}
+
+int64_t CSegmentCache::CachedDataEndPosIfSeekTo(int64_t iFilePosition)
+{
+  return m_pCache->CachedDataEndPosIfSeekTo(iFilePosition);
+}
+
+int64_t CSegmentCache::CachedDataEndPos()
+{
+  return m_pCache->CachedDataEndPos();
+}
+
+bool CSegmentCache::IsCachedPosition(int64_t iFilePosition)
+{
+  return m_pCache->IsCachedPosition(iFilePosition);
+}
+
+ssize_t CSegmentCache::ReadStored(int64_t iFilePosition, char *pBuffer, size_t iMaxSize)
+{
+  return m_store->Read(iFilePosition, pBuffer, iMaxSize);
+}
+
+CCacheStrategy *CSegmentCache::CreateNew()
+{
+  return new CSegmentCache(m_pCache->CreateNew(), m_store);
+}
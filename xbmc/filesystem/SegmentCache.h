@@ -0,0 +1,130 @@
+/*
+ *      Copyright (C) 2018 Team Kodi
+ *      http://kodi.tv
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this Program; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#pragma once
+
+#include "CacheStrategy.h"
+#include "File.h"
+#include "threads/CriticalSection.h"
+
+#include <memory>
+#include <set>
+#include <string>
+#include <vector>
+
+namespace XFILE {
+
+/*!
+ \brief Fixed size segments of one source file, kept on disk across sessions.
+
+ Segments are stored under special://temp/segmentcache/<key>/ where the key
+ is derived from url, size and modification time of the source, so a changed
+ source never serves stale data. Only complete segments are stored.
+ */
+class CSegmentStore
+{
+public:
+  /*!
+   \param url source file
+   \param size size of the source file
+   \param mtime modification time of the source file
+   \param budget size all stores together are kept below, in bytes
+   */
+  CSegmentStore(const std::string& url, int64_t size, int64_t mtime, int64_t budget);
+  ~CSegmentStore();
+
+  bool Open();
+  void Close();
+
+  /*! \brief Feed data written to the cache, stores segments once completed */
+  void Write(int64_t pos, const char* data, size_t size);
+  /*! \brief Read stored data at pos, at most up to the end of its segment
+   \return bytes read or 0 if pos is not stored
+   */
+  ssize_t Read(int64_t pos, char* buffer, size_t size);
+  bool IsStored(int64_t pos);
+
+  /*! \brief Evict least recently used sources that are not open until the
+   store fits its budget. Scans the whole store, run from a job.
+   */
+  static void Evict(int64_t budget);
+  /*! \brief Run Evict in the background, unless it ran lately */
+  static void RequestEvict(int64_t budget);
+
+  static const int64_t SEGMENT_SIZE = 2 * 1024 * 1024;
+
+private:
+  std::string GetSegmentPath(int64_t index) const;
+  void StorePending();
+
+  CCriticalSection m_section;
+  std::string m_key;
+  std::string m_directory;
+  int64_t m_fileSize;
+  int64_t m_budget;
+  bool m_registered = false;
+  std::set<int64_t> m_stored;
+
+  std::vector<char> m_pending;
+  int64_t m_pendingIndex = -1;
+
+  CFile m_readFile;
+  int64_t m_readIndex = -1;
+};
+
+/*!
+ \brief Cache strategy decorator mirroring cached data into a CSegmentStore.
+
+ Reads and writes go to the wrapped strategy, CFileCache fetches stored
+ segments through ReadStored() instead of reading them from the source.
+ */
+class CSegmentCache : public CCacheStrategy
+{
+public:
+  CSegmentCache(CCacheStrategy *impl, std::shared_ptr<CSegmentStore> store);
+  ~CSegmentCache() override;
+
+  int Open() override;
+  void Close() override;
+
+  size_t GetMaxWriteSize(const size_t& iRequestSize) override;
+  int WriteToCache(const char *pBuffer, size_t iSize) override;
+  int ReadFromCache(char *pBuffer, size_t iMaxSize) override;
+  int64_t WaitForData(unsigned int iMinAvail, unsigned int iMillis) override;
+
+  int64_t Seek(int64_t iFilePosition) override;
+  bool Reset(int64_t iSourcePosition, bool clearAnyway=true) override;
+  void EndOfInput() override;
+  bool IsEndOfInput() override;
+  void ClearEndOfInput() override;
+
+  int64_t CachedDataEndPosIfSeekTo(int64_t iFilePosition) override;
+  int64_t CachedDataEndPos() override;
+  bool IsCachedPosition(int64_t iFilePosition) override;
+  ssize_t ReadStored(int64_t iFilePosition, char *pBuffer, size_t iMaxSize) override;
+
+  CCacheStrategy *CreateNew() override;
+
+protected:
+  CCacheStrategy *m_pCache;
+  std::shared_ptr<CSegmentStore> m_store;
+};
+
+}
@@ -18,6 +18,7 @@
  *
  */
 
+#include <algorithm>
 #include <math.h>
 
 #include "SmartPlaylistDirectory.h"
@@ -28,7 +29,10 @@
 #include "filesystem/FileDirectoryFactory.h"
 #include "music/MusicDatabase.h"
 #include "playlists/SmartPlayList.h"
+#include "playlists/SmartPlaylistCache.h"
+#include "profiles/ProfilesManager.h"
 #include "settings/Settings.h"
+#include "threads/SystemClock.h"
 #include "utils/SortUtils.h"
 #include "utils/StringUtils.h"
 #include "utils/URIUtils.h"
@@ -40,6 +44,87 @@
 #define PROPERTY_GROUP_BY           "group.by"
 #define PROPERTY_GROUP_MIXED        "group.mixed"
 
+namespace
+{
+// library tables the items of smart playlists are read from
+const char *VideoTables[] = { "files", "path", "bookmark", "streamdetails", "art", "rating", "uniqueid",
+                              "genre", "genre_link", "actor", "actor_link", "director_link", "writer_link",
+                              "studio", "studio_link", "country", "country_link", "tag", "tag_link" };
+const char *MovieTables[] = { "movie", "sets" };
+const char *TvShowTables[] = { "tvshow", "tvshowlinkpath", "seasons", "episode" };
+const char *MusicVideoTables[] = { "musicvideo" };
+const char *MusicTables[] = { "song", "album", "artist", "song_artist", "album_artist", "song_genre", "genre",
+                              "role", "discography", "path", "art", "source", "source_path", "album_source" };
+
+template<size_t N>
+void AddTables(std::vector<std::string> &tables, const char *(&names)[N])
+{
+  tables.insert(tables.end(), names, names + N);
+}
+
+// version of the library tables a playlist is read from, 0 if their changes can't be followed
+uint64_t GetLibraryVersion(const CSmartPlaylist &playlist)
+{
+  const std::string &type = playlist.GetType();
+  uint64_t version = 0;
+
+  if (CSmartPlaylist::IsVideoType(type))
+  {
+    std::vector<std::string> tables;
+    AddTables(tables, VideoTables);
+    if (type == "movies")
+      AddTables(tables, MovieTables);
+    else if (type == "tvshows" || type == "episodes")
+      AddTables(tables, TvShowTables);
+    else
+      AddTables(tables, MusicVideoTables);
+
+    CVideoDatabase db;
+    if (!db.Open())
+      return 0;
+    version = db.GetChangeVersion(tables);
+    db.Close();
+    if (!version)
+      return 0;
+  }
+
+  if (CSmartPlaylist::IsMusicType(type) || type.empty())
+  {
+    std::vector<std::string> tables;
+    AddTables(tables, MusicTables);
+
+    CMusicDatabase db;
+    if (!db.Open())
+      return 0;
+    uint64_t musicVersion = db.GetChangeVersion(tables);
+    db.Close();
+    if (!musicVersion)
+      return 0;
+    // versions only ever grow, so the larger one changes with either library
+    version = std::max(version, musicVersion);
+  }
+
+  return version;
+}
+
+// what the items of a playlist depend on besides the library
+std::string GetCacheKey(const CSmartPlaylist &playlist, const std::string &strBaseDir)
+{
+  std::string xsp;
+  if (!playlist.SaveAsJson(xsp))
+    return "";
+
+  const CSettings &settings = CServiceBroker::GetSettings();
+  return StringUtils::Format("%s|%d%d%d%d%d|%s", strBaseDir.c_str(),
+                             settings.GetBool(CSettings::SETTING_FILELISTS_IGNORETHEWHENSORTING),
+                             settings.GetBool(CSettings::SETTING_VIDEOLIBRARY_GROUPMOVIESETS),
+                             settings.GetBool(CSettings::SETTING_VIDEOLIBRARY_GROUPSINGLEITEMSETS),
+                             settings.GetBool(CSettings::SETTING_VIDEOLIBRARY_SHOWEMPTYTVSHOWS),
+                             settings.GetBool(CSettings::SETTING_MUSICLIBRARY_SHOWCOMPILATIONARTISTS),
+                             xsp.c_str());
+}
+}
+
 namespace XFILE
 {
   CSmartPlaylistDirectory::CSmartPlaylistDirectory() = default;
@@ -60,6 +145,36 @@ namespace XFILE
   }
 
   bool CSmartPlaylistDirectory::GetDirectory(const CSmartPlaylist &playlist, CFileItemList& items, const std::string &strBaseDir /* = "" */, bool filter /* = false */)
+  {
+    // the items are kept until the library tables they were read from change.
+    // Filters are applied once, and a random order is meant to differ every time.
+    // With a master lock the items depend on the sources unlocked at the time.
+    std::string cacheKey;
+    uint64_t version = 0;
+    if (!filter && items.IsEmpty() && playlist.GetOrder() != SortByRandom &&
+        CServiceBroker::GetProfileManager().GetMasterProfile().getLockMode() == LOCK_MODE_EVERYONE)
+    {
+      version = GetLibraryVersion(playlist);
+      if (version)
+        cacheKey = GetCacheKey(playlist, strBaseDir);
+      if (!cacheKey.empty() && CSmartPlaylistCache::GetInstance().Get(cacheKey, version, items))
+        return true;
+    }
+
+    unsigned int start = XbmcThreads::SystemClockMillis();
+    bool success = GetLibraryItems(playlist, items, strBaseDir, filter);
+    CSmartPlaylistCache::GetInstance().AddQuery(XbmcThreads::SystemClockMillis() - start);
+
+    if (success && !cacheKey.empty())
+    {
+      std::set<std::string> referencedPlaylists;
+      CSmartPlaylistCache::GetInstance().Add(cacheKey, version, items, playlist.IsTimeRelative(referencedPlaylists));
+    }
+
+    return success;
+  }
+
+  bool CSmartPlaylistDirectory::GetLibraryItems(const CSmartPlaylist &playlist, CFileItemList& items, const std::string &strBaseDir, bool filter)
   {
     bool success = false, success2 = false;
     std::vector<std::string> virtualFolders;
@@ -346,7 +461,12 @@ namespace XFILE
 
   bool CSmartPlaylistDirectory::Remove(const CURL& url)
   {
-    return XFILE::CFile::Delete(url);
+    if (!XFILE::CFile::Delete(url))
+      return false;
+
+    // other playlists may include this one
+    CSmartPlaylistCache::GetInstance().Clear();
+    return true;
   }
 }
 
@@ -115,6 +115,29 @@ bool CDDSImage::ReadFile(const std::string &inputFile)
   return true;
 }
 
+bool CDDSImage::WriteFile(const std::string &outputFile) const
+{
+  if (!m_data)
+    return false;
+
+  // open the file
+  CFile file;
+  if (!file.OpenForWrite(outputFile, true))
+    return false;
+
+  // write the header, then the data
+  if (file.Write("DDS ", 4) != 4 ||
+      file.Write(&m_desc, sizeof(m_desc)) != sizeof(m_desc) ||
+      file.Write(m_data, m_desc.linearSize) != m_desc.linearSize)
+  {
+    file.Close();
+    return false;
+  }
+
+  file.Close();
+  return true;
+}
+
 unsigned int CDDSImage::GetStorageRequirements(unsigned int width, unsigned int height, unsigned int format)
 {
   switch (format)
@@ -37,6 +37,7 @@ public:
   unsigned char *GetData() const;
 
   bool ReadFile(const std::string &file);
+  bool WriteFile(const std::string &file) const;
 
 private:
   void Allocate(unsigned int width, unsigned int height, unsigned int format);
@@ -22,6 +22,10 @@
 #include "windowing/GraphicContext.h"
 #include <stdio.h>
 
+#define COST_MODEL_PASS_OVERHEAD   16384.0f // pixels, for a pass that draws nothing
+#define COST_MODEL_CONTROL_COST     2048.0f // pixels, per control drawn in a pass
+#define COST_MODEL_MAX_REGIONS        64    // above this, just take the union
+
 void CUnionDirtyRegionSolver::Solve(const CDirtyRegionList &input, CDirtyRegionList &output)
 {
   CDirtyRegion unifiedRegion;
@@ -81,3 +85,58 @@ void CGreedyDirtyRegionSolver::Solve(const CDirtyRegionList &input, CDirtyRegion
       output.push_back(currentRegion);
   }
 }
+
+CCostModelDirtyRegionSolver::CCostModelDirtyRegionSolver()
+{
+  SetControlsPerPass(0.0f);
+}
+
+void CCostModelDirtyRegionSolver::SetControlsPerPass(float controlsPerPass)
+{
+  m_costPerPass = COST_MODEL_PASS_OVERHEAD + COST_MODEL_CONTROL_COST * controlsPerPass;
+}
+
+void CCostModelDirtyRegionSolver::Solve(const CDirtyRegionList &input, CDirtyRegionList &output)
+{
+  for (const auto &region : input)
+  {
+    if (!region.IsEmpty())
+      output.push_back(region);
+  }
+
+  if (output.size() > COST_MODEL_MAX_REGIONS)
+  {
+    CDirtyRegion unifiedRegion;
+    for (const auto &region : output)
+      unifiedRegion.Union(region);
+    output.assign(1, unifiedRegion);
+    return;
+  }
+
+  while (output.size() > 1)
+  {
+    // merging i and j saves a pass, but fills the union rather than the two regions
+    float bestSaving = 0.0f;
+    size_t bestI = 0, bestJ = 0;
+    for (size_t i = 0; i < output.size(); i++)
+    {
+      for (size_t j = i + 1; j < output.size(); j++)
+      {
+        CDirtyRegion merged(output[i]);
+        merged.Union(output[j]);
+        float saving = m_costPerPass + output[i].Area() + output[j].Area() - merged.Area();
+        if (saving > bestSaving)
+        {
+          bestSaving = saving;
+          bestI = i;
+          bestJ = j;
+        }
+      }
+    }
+    if (bestSaving <= 0.0f)
+      break;
+
+    output[bestI].Union(output[bestJ]);
+    output.erase(output.begin() + bestJ);
+  }
+}
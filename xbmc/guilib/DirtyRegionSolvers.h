@@ -49,3 +49,25 @@ private:
   float m_costNewRegion;
   float m_costPerArea;
 };
+
+/*!
+ \brief Merges regions while that is estimated to be cheaper than rendering them separately.
+
+ The cost of a rendering pass is the area it fills plus the overhead of walking and drawing
+ the controls, in the same unit of pixels. Two regions are merged when the pass saved outweighs
+ the extra area of their union, best merge first, until no merge pays off.
+ */
+class CCostModelDirtyRegionSolver : public IDirtyRegionSolver
+{
+public:
+  CCostModelDirtyRegionSolver();
+  void Solve(const CDirtyRegionList &input, CDirtyRegionList &output) override;
+
+  /*! \brief Update the overhead of a pass from how many controls the passes of the last frame drew
+   \param controlsPerPass average number of controls rendered per pass
+   */
+  void SetControlsPerPass(float controlsPerPass);
+
+private:
+  float m_costPerPass;
+};
@@ -23,11 +23,13 @@
 #include "utils/log.h"
 #include <stdio.h>
 #include "DirtyRegionSolvers.h"
+#include "threads/SingleLock.h"
 
 CDirtyRegionTracker::CDirtyRegionTracker(int buffering)
 {
   m_buffering = buffering;
   m_solver = NULL;
+  m_costModelSolver = NULL;
 }
 
 CDirtyRegionTracker::~CDirtyRegionTracker()
@@ -38,9 +40,15 @@ CDirtyRegionTracker::~CDirtyRegionTracker()
 void CDirtyRegionTracker::SelectAlgorithm()
 {
   delete m_solver;
+  m_costModelSolver = NULL;
 
   switch (g_advancedSettings.m_guiAlgorithmDirtyRegions)
   {
+    case DIRTYREGION_SOLVER_COST_MODEL:
+      CLog::Log(LOGDEBUG, "guilib: Cost model as algorithm for solving rendering passes");
+      m_costModelSolver = new CCostModelDirtyRegionSolver();
+      m_solver = m_costModelSolver;
+      break;
     case DIRTYREGION_SOLVER_FILL_VIEWPORT_ON_CHANGE:
       CLog::Log(LOGDEBUG, "guilib: Fill viewport on change for solving rendering passes");
       m_solver = new CFillViewportOnChangeRegionSolver();
@@ -94,3 +102,37 @@ void CDirtyRegionTracker::CleanMarkedRegions()
     i--;
   }
 }
+
+void CDirtyRegionTracker::BeginFrame()
+{
+  m_frameStats.regions = 0;
+  m_frameStats.pixels = 0;
+  m_frameStats.controls = 0;
+  m_frameStats.culledControls = 0;
+}
+
+void CDirtyRegionTracker::AddPass(const CRect &region)
+{
+  m_frameStats.regions++;
+  m_frameStats.pixels += static_cast<uint64_t>(region.Area());
+}
+
+void CDirtyRegionTracker::EndFrame(bool rendered)
+{
+  m_frameStats.frames++;
+  if (!rendered)
+    m_frameStats.idleFrames++;
+
+  // culled controls still cost a visit, but far less than a draw
+  if (m_costModelSolver && m_frameStats.regions)
+    m_costModelSolver->SetControlsPerPass((m_frameStats.controls + m_frameStats.culledControls / 8.0f) / m_frameStats.regions);
+
+  CSingleLock lock(m_statsSection);
+  m_stats = m_frameStats;
+}
+
+DirtyRegionStats CDirtyRegionTracker::GetStats() const
+{
+  CSingleLock lock(m_statsSection);
+  return m_stats;
+}
@@ -20,7 +20,12 @@
 
 #pragma once
 
+#include <stdint.h>
+
 #include "IDirtyRegionSolver.h"
+#include "threads/CriticalSection.h"
+
+class CCostModelDirtyRegionSolver;
 
 #if defined(TARGET_DARWIN_IOS)
 #define DEFAULT_BUFFERING 4
@@ -28,6 +33,19 @@
 #define DEFAULT_BUFFERING 3
 #endif
 
+/*!
+ \brief What the last frame rendered, to tell how well the dirty regions keep redrawing down
+ */
+struct DirtyRegionStats
+{
+  unsigned int regions = 0;        ///< rendering passes
+  uint64_t pixels = 0;             ///< pixels covered by the passes
+  unsigned int controls = 0;       ///< controls rendered, over all passes
+  unsigned int culledControls = 0; ///< controls skipped as they were outside the pass
+  uint64_t frames = 0;             ///< frames so far
+  uint64_t idleFrames = 0;         ///< frames so far that had nothing to render
+};
+
 class CDirtyRegionTracker
 {
 public:
@@ -40,8 +58,23 @@ public:
   CDirtyRegionList GetDirtyRegions();
   void CleanMarkedRegions();
 
+  /*! \brief Frame statistics, called from the rendering thread
+   \sa GetStats
+   */
+  void BeginFrame();
+  void AddPass(const CRect &region);
+  void AddControl(bool culled) { if (culled) m_frameStats.culledControls++; else m_frameStats.controls++; }
+  void EndFrame(bool rendered);
+
+  DirtyRegionStats GetStats() const;
+
 private:
   CDirtyRegionList m_markedRegions;
   int m_buffering;
   IDirtyRegionSolver *m_solver;
+  CCostModelDirtyRegionSolver *m_costModelSolver; ///< m_solver if it is the cost model solver, fed from the frame stats
+
+  DirtyRegionStats m_frameStats; ///< frame being rendered
+  DirtyRegionStats m_stats;      ///< last frame rendered
+  mutable CCriticalSection m_statsSection;
 };
@@ -19,6 +19,7 @@
  */
 
 #include "GUIBaseContainer.h"
+#include "GUIComponent.h"
 #include "GUIListItemLayout.h"
 #include "GUIMessage.h"
 #include "ServiceBroker.h"
@@ -28,6 +29,7 @@
 #include "utils/log.h"
 #include "utils/SortUtils.h"
 #include "utils/StringUtils.h"
+#include "utils/Variant.h"
 #include "FileItem.h"
 #include "input/Key.h"
 #include "utils/MathUtils.h"
@@ -35,11 +37,15 @@
 #include "listproviders/IListProvider.h"
 #include "settings/Settings.h"
 #include "guilib/guiinfo/GUIInfoLabels.h"
+#include "GUILargeTextureManager.h"
+#include "GUIWindowManager.h"
 
 #define HOLD_TIME_START 100
 #define HOLD_TIME_END   3000
 #define SCROLLING_GAP   200U
 #define SCROLLING_THRESHOLD 300U
+#define PREFETCH_TIME       1.0f // seconds of scrolling to prefetch artwork for
+#define PREFETCH_MAX_PAGES  4
 
 CGUIBaseContainer::CGUIBaseContainer(int parentID, int controlID, float posX, float posY, float width, float height, ORIENTATION orientation, const CScroller& scroller, int preloadItems)
     : IGUIContainer(parentID, controlID, posX, posY, width, height)
@@ -56,6 +62,13 @@ CGUIBaseContainer::CGUIBaseContainer(int parentID, int controlID, float posX, fl
   m_layout = NULL;
   m_focusedLayout = NULL;
   m_cacheItems = preloadItems;
+  m_precomputeStart = m_precomputeEnd = 0;
+  m_prefetchStart = m_prefetchEnd = 0;
+  m_pagedItems = false;
+  m_pageRequested = false;
+  m_scrollVelocity = 0.0f;
+  m_lastScrollValue = 0.0f;
+  m_lastScrollTime = 0;
   m_scrollItemsPerFrame = 0.0f;
   m_type = VIEW_TYPE_NONE;
   m_listProvider = NULL;
@@ -69,6 +82,7 @@ CGUIBaseContainer::CGUIBaseContainer(const CGUIBaseContainer &) = default;
 
 CGUIBaseContainer::~CGUIBaseContainer(void)
 {
+  ReleasePrefetchedItems();
   delete m_listProvider;
 }
 
@@ -143,6 +157,31 @@ void CGUIBaseContainer::Process(unsigned int currentTime, CDirtyRegionList &dirt
     current++;
   }
 
+  // lay out the labels of the next page in the background, so they are ready once scrolled into view
+  if (m_scroller.IsScrollingDown())
+    PrecomputeItems(offset + m_itemsPerPage + 1 + cacheAfter, offset + 2 * m_itemsPerPage + 1 + cacheAfter);
+  else if (m_scroller.IsScrollingUp())
+    PrecomputeItems(offset - cacheBefore - m_itemsPerPage, offset - cacheBefore);
+
+  // and queue the artwork of the items we're heading towards, further ahead the faster we go
+  int prefetchCount = GetPrefetchCount(currentTime);
+  if (prefetchCount > 0)
+    PrefetchItems(offset + m_itemsPerPage + 1 + cacheAfter, offset + m_itemsPerPage + 1 + cacheAfter + prefetchCount);
+  else if (prefetchCount < 0)
+    PrefetchItems(offset - cacheBefore + prefetchCount, offset - cacheBefore);
+  else
+    ReleasePrefetchedItems();
+
+  // ask our window for the next page of a paged listing before we get to the end of it.
+  // The page is bound on a later frame, as binding changes the items we are processing
+  if (m_pagedItems && !m_pageRequested &&
+      offset + m_itemsPerPage + 1 + cacheAfter + std::max(prefetchCount, m_itemsPerPage) >= (int)m_items.size())
+  {
+    m_pageRequested = true;
+    CGUIMessage msg(GUI_MSG_LOAD_PAGE, GetID(), GetParentID());
+    CServiceBroker::GetGUI()->GetWindowManager().SendThreadMessage(msg, GetParentID());
+  }
+
   // when we are scrolling up, offset will become lower (integer division, see offset calc)
   // to have same behaviour when scrolling down, we need to set page control to offset+1
   UpdatePageControl(offset + (m_scroller.IsScrollingDown() ? 1 : 0));
@@ -230,6 +269,9 @@ void CGUIBaseContainer::Render()
     float focusedPos = 0;
     CGUIListItemPtr focusedItem;
     int current = offset - cacheBefore;
+    float visibleStart = (m_orientation == VERTICAL) ? m_posY : m_posX;
+    float visibleEnd = visibleStart + ((m_orientation == VERTICAL) ? m_height : m_width);
+    unsigned int missingTiles = 0;
     while (pos < end && m_items.size())
     {
       int itemNo = CorrectOffset(current, 0);
@@ -239,6 +281,11 @@ void CGUIBaseContainer::Render()
       if (itemNo >= 0)
       {
         CGUIListItemPtr item = m_items[itemNo];
+        // count the items on screen that are still waiting for their artwork
+        float size = focused ? m_focusedLayout->Size(m_orientation) : m_layout->Size(m_orientation);
+        const CGUIListItemLayout *layout = focused ? item->GetFocusedLayout() : item->GetLayout();
+        if (pos + size > visibleStart && pos < visibleEnd && layout && layout->HasLoadingImages())
+          missingTiles++;
         // render our item
         if (focused)
         {
@@ -266,6 +313,9 @@ void CGUIBaseContainer::Render()
         RenderItem(focusedPos, origin.y, focusedItem.get(), true);
     }
 
+    if (!m_items.empty())
+      CServiceBroker::GetGUI()->GetLargeTextureManager().RecordFrame(missingTiles);
+
     CServiceBroker::GetWinSystem()->GetGfxContext().RestoreClipRegion();
   }
 
@@ -414,13 +464,33 @@ bool CGUIBaseContainer::OnMessage(CGUIMessage& message)
     {
       if (message.GetMessage() == GUI_MSG_LABEL_BIND && message.GetPointer())
       { // bind our items
-        Reset();
         CFileItemList *items = static_cast<CFileItemList*>(message.GetPointer());
-        for (int i = 0; i < items->Size(); i++)
-          m_items.push_back(items->Get(i));
-        UpdateLayout(true); // true to refresh all items
-        UpdateScrollByLetter();
-        SelectItem(message.GetParam1());
+
+        // the next page of a paged listing only adds items at the end, so keep
+        // our layouts, scroll position and selection rather than starting over
+        bool appended = m_pagedItems && !m_items.empty() && items->Size() > (int)m_items.size();
+        for (unsigned int i = 0; appended && i < m_items.size(); i++)
+          appended = m_items[i] == items->Get(i);
+
+        if (appended)
+        {
+          for (int i = m_items.size(); i < items->Size(); i++)
+            m_items.push_back(items->Get(i));
+          SetPageControlRange();
+          UpdateScrollByLetter();
+          MarkDirtyRegion();
+        }
+        else
+        {
+          Reset();
+          for (int i = 0; i < items->Size(); i++)
+            m_items.push_back(items->Get(i));
+          UpdateLayout(true); // true to refresh all items
+          UpdateScrollByLetter();
+          SelectItem(message.GetParam1());
+        }
+        m_pagedItems = items->GetProperty("paged").asBoolean();
+        m_pageRequested = false;
         return true;
       }
       else if (message.GetMessage() == GUI_MSG_LABEL_RESET)
@@ -866,6 +936,7 @@ void CGUIBaseContainer::AllocResources()
 void CGUIBaseContainer::FreeResources(bool immediately)
 {
   CGUIControl::FreeResources(immediately);
+  ReleasePrefetchedItems();
   if (m_listProvider)
   {
     if (immediately)
@@ -884,6 +955,8 @@ void CGUIBaseContainer::UpdateLayout(bool updateAllItems)
     for (iItems it = m_items.begin(); it != m_items.end(); ++it)
       (*it)->FreeMemory();
   }
+  m_precomputeStart = m_precomputeEnd = 0;
+  ReleasePrefetchedItems();
   // and recalculate the layout
   CalculateLayout();
   SetPageControlRange();
@@ -1145,6 +1218,10 @@ void CGUIBaseContainer::Reset()
 {
   m_wasReset = true;
   m_items.clear();
+  m_precomputeStart = m_precomputeEnd = 0;
+  ReleasePrefetchedItems();
+  m_pagedItems = false;
+  m_pageRequested = false;
   m_lastItem.reset();
   ResetAutoScrolling();
 }
@@ -1205,6 +1282,94 @@ void CGUIBaseContainer::FreeMemory(int keepStart, int keepEnd)
   }
 }
 
+void CGUIBaseContainer::PrecomputeItems(int start, int end)
+{
+  for (int i = start; i < end; ++i)
+  {
+    if (i >= m_precomputeStart && i < m_precomputeEnd)
+      continue; // done last time
+    int itemNo = CorrectOffset(i, 0);
+    if (itemNo < 0 || itemNo >= (int)m_items.size())
+      continue;
+    const CGUIListItemPtr &item = m_items[itemNo];
+    if (!item->GetLayout())
+      m_layout->PrecomputeLabels(item.get());
+  }
+  m_precomputeStart = start;
+  m_precomputeEnd = end;
+}
+
+int CGUIBaseContainer::GetPrefetchCount(unsigned int currentTime)
+{
+  float value = m_scroller.GetValue();
+  if (currentTime > m_lastScrollTime && m_lastScrollTime)
+  {
+    float velocity = (value - m_lastScrollValue) / m_layout->Size(m_orientation) * 1000.0f / (currentTime - m_lastScrollTime);
+    // smooth it out, so that stepping through items one at a time looks like continuous scrolling
+    m_scrollVelocity = 0.8f * m_scrollVelocity + 0.2f * velocity;
+    if (fabs(m_scrollVelocity) < 0.5f)
+      m_scrollVelocity = 0.0f;
+  }
+  m_lastScrollValue = value;
+  m_lastScrollTime = currentTime;
+
+  if (m_scrollVelocity == 0.0f)
+    return 0;
+
+  int count = MathUtils::round_int(fabs(m_scrollVelocity) * PREFETCH_TIME);
+  count = std::max(m_itemsPerPage, std::min(count, PREFETCH_MAX_PAGES * m_itemsPerPage));
+  return m_scrollVelocity > 0 ? count : -count;
+}
+
+void CGUIBaseContainer::PrefetchItems(int start, int end)
+{
+  if (start == m_prefetchStart && end == m_prefetchEnd)
+    return;
+
+  std::set<std::string> prefetched;
+  std::vector<std::string> images;
+  for (int i = start; i < end; ++i)
+  {
+    int itemNo = CorrectOffset(i, 0);
+    if (itemNo < 0 || itemNo >= (int)m_items.size())
+      continue;
+    const CGUIListItemPtr &item = m_items[itemNo];
+    if (item->GetLayout())
+      continue; // its images are being loaded already
+    images.clear();
+    m_layout->GetLargeImages(item.get(), images);
+    prefetched.insert(images.begin(), images.end());
+  }
+
+  // queue the new images before releasing the old ones, so that images in both windows aren't cancelled
+  CGUILargeTextureManager &textureManager = CServiceBroker::GetGUI()->GetLargeTextureManager();
+  for (std::set<std::string>::const_iterator it = prefetched.begin(); it != prefetched.end(); ++it)
+  {
+    if (m_prefetched.find(*it) == m_prefetched.end())
+      textureManager.PrefetchImage(*it);
+  }
+  for (std::set<std::string>::const_iterator it = m_prefetched.begin(); it != m_prefetched.end(); ++it)
+  {
+    if (prefetched.find(*it) == prefetched.end())
+      textureManager.ReleaseImage(*it);
+  }
+  m_prefetched.swap(prefetched);
+  m_prefetchStart = start;
+  m_prefetchEnd = end;
+}
+
+void CGUIBaseContainer::ReleasePrefetchedItems()
+{
+  if (!m_prefetched.empty())
+  {
+    CGUILargeTextureManager &textureManager = CServiceBroker::GetGUI()->GetLargeTextureManager();
+    for (std::set<std::string>::const_iterator it = m_prefetched.begin(); it != m_prefetched.end(); ++it)
+      textureManager.ReleaseImage(*it);
+    m_prefetched.clear();
+  }
+  m_prefetchStart = m_prefetchEnd = 0;
+}
+
 bool CGUIBaseContainer::InsideLayout(const CGUIListItemLayout *layout, const CPoint &point) const
 {
   if (!layout) return false;
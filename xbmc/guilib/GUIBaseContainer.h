@@ -28,6 +28,8 @@
 #include <utility>
 #include <vector>
 #include <list>
+#include <set>
+#include <string>
 
 #include "IGUIContainer.h"
 #include "GUIAction.h"
@@ -139,6 +141,10 @@ protected:
   int ScrollCorrectionRange() const;
   inline float Size() const;
   void FreeMemory(int keepStart, int keepEnd);
+  void PrecomputeItems(int start, int end);
+  int GetPrefetchCount(unsigned int currentTime);
+  void PrefetchItems(int start, int end);
+  void ReleasePrefetchedItems();
   void GetCurrentLayouts();
   CGUIListItemLayout *GetFocusedLayout() const;
 
@@ -225,6 +231,16 @@ private:
   int m_cursor;
   int m_offset;
   int m_cacheItems;
+  int m_precomputeStart;  ///< first item whose labels were laid out in the background
+  int m_precomputeEnd;    ///< item after the last one whose labels were laid out in the background
+  int m_prefetchStart;    ///< first item whose artwork is being prefetched
+  int m_prefetchEnd;      ///< item after the last one whose artwork is being prefetched
+  std::set<std::string> m_prefetched; ///< images held on to by the prefetch
+  bool m_pagedItems;      ///< the bound listing has more items to fetch a page at a time
+  bool m_pageRequested;   ///< the next page has been asked for and not yet bound
+  float m_scrollVelocity; ///< smoothed scroll speed in items per second, negative when scrolling up
+  float m_lastScrollValue;
+  unsigned int m_lastScrollTime;
   CStopWatch m_scrollTimer;
   CStopWatch m_lastScrollStartTimer;
   CStopWatch m_pageChangeTimer;
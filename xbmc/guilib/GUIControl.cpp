@@ -32,6 +32,7 @@
 #include "input/InputManager.h"
 #include "input/Key.h"
 #include "ServiceBroker.h"
+#include "utils/FrameProfiler.h"
 
 using namespace KODI::GUILIB;
 
@@ -129,6 +130,8 @@ void CGUIControl::DynamicResourceAlloc(bool bOnOff)
 // 3. reset the animation transform
 void CGUIControl::DoProcess(unsigned int currentTime, CDirtyRegionList &dirtyregions)
 {
+  CFrameProfilerScope profile("control", "CGUIControl::Process", GetID());
+
   CRect dirtyRegion = m_renderRegion;
 
   bool changed = (m_controlDirtyState & DIRTY_STATE_CONTROL) != 0 || (m_bInvalidated && IsVisible());
@@ -180,12 +183,27 @@ void CGUIControl::Process(unsigned int currentTime, CDirtyRegionList &dirtyregio
 // 3. reset the animation transform
 void CGUIControl::DoRender()
 {
+  CFrameProfilerScope profile("control", "CGUIControl::Render", GetID());
+
   if (IsVisible())
   {
     bool hasStereo = m_stereo != 0.0
                   && CServiceBroker::GetWinSystem()->GetGfxContext().GetStereoMode() != RENDER_STEREO_MODE_MONO
                   && CServiceBroker::GetWinSystem()->GetGfxContext().GetStereoMode() != RENDER_STEREO_MODE_OFF;
 
+    // skip controls that lie entirely outside the region being redrawn
+    if (!hasStereo && !m_hasCamera && m_hasProcessed && !m_renderRegion.IsEmpty())
+    {
+      CRect region(m_renderRegion);
+      region.Intersect(CServiceBroker::GetWinSystem()->GetGfxContext().GetScissors());
+      if (region.IsEmpty())
+      {
+        CServiceBroker::GetGUI()->GetWindowManager().OnControlRendered(true);
+        return;
+      }
+    }
+    CServiceBroker::GetGUI()->GetWindowManager().OnControlRendered(false);
+
     CServiceBroker::GetWinSystem()->GetGfxContext().SetTransform(m_cachedTransform);
     if (m_hasCamera)
       CServiceBroker::GetWinSystem()->GetGfxContext().SetCameraPosition(m_camera);
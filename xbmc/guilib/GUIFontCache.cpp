@@ -50,6 +50,21 @@ class CGUIFontCacheImpl
         delete(it->second);
       hashMap.clear();
     }
+    void Flush(const std::function<bool(const vecText &, uint32_t)> &uses)
+    {
+      for (auto it = ageMap.begin(); it != ageMap.end();)
+      {
+        const CGUIFontCacheKey<Position> &key = it->second->second->m_key;
+        if (uses(key.m_text, key.m_alignment))
+        {
+          delete(it->second->second);
+          hashMap.erase(it->second);
+          it = ageMap.erase(it);
+        }
+        else
+          ++it;
+      }
+    }
     typename HashMap::iterator FindKey(CGUIFontCacheKey<Position> key)
     {
       CGUIFontCacheHash<Position> hashGen;
@@ -95,6 +110,7 @@ public:
                 bool scrolling,
                 unsigned int nowMillis, bool &dirtyCache);
   void Flush();
+  void Flush(const std::function<bool(const vecText &, uint32_t)> &uses);
 };
 
 template<class Position, class Value>
@@ -208,17 +224,31 @@ void CGUIFontCacheImpl<Position, Value>::Flush()
   m_list.Flush();
 }
 
+template<class Position, class Value>
+void CGUIFontCache<Position, Value>::Flush(const std::function<bool(const vecText &, uint32_t)> &uses)
+{
+  m_impl->Flush(uses);
+}
+
+template<class Position, class Value>
+void CGUIFontCacheImpl<Position, Value>::Flush(const std::function<bool(const vecText &, uint32_t)> &uses)
+{
+  m_list.Flush(uses);
+}
+
 template CGUIFontCache<CGUIFontCacheStaticPosition, CGUIFontCacheStaticValue>::CGUIFontCache(CGUIFontTTFBase &font);
 template CGUIFontCache<CGUIFontCacheStaticPosition, CGUIFontCacheStaticValue>::~CGUIFontCache();
 template CGUIFontCacheEntry<CGUIFontCacheStaticPosition, CGUIFontCacheStaticValue>::~CGUIFontCacheEntry();
 template CGUIFontCacheStaticValue &CGUIFontCache<CGUIFontCacheStaticPosition, CGUIFontCacheStaticValue>::Lookup(CGUIFontCacheStaticPosition &, const std::vector<UTILS::Color> &, const vecText &, uint32_t, float, bool, unsigned int, bool &);
 template void CGUIFontCache<CGUIFontCacheStaticPosition, CGUIFontCacheStaticValue>::Flush();
+template void CGUIFontCache<CGUIFontCacheStaticPosition, CGUIFontCacheStaticValue>::Flush(const std::function<bool(const vecText &, uint32_t)> &);
 
 template CGUIFontCache<CGUIFontCacheDynamicPosition, CGUIFontCacheDynamicValue>::CGUIFontCache(CGUIFontTTFBase &font);
 template CGUIFontCache<CGUIFontCacheDynamicPosition, CGUIFontCacheDynamicValue>::~CGUIFontCache();
 template CGUIFontCacheEntry<CGUIFontCacheDynamicPosition, CGUIFontCacheDynamicValue>::~CGUIFontCacheEntry();
 template CGUIFontCacheDynamicValue &CGUIFontCache<CGUIFontCacheDynamicPosition, CGUIFontCacheDynamicValue>::Lookup(CGUIFontCacheDynamicPosition &, const std::vector<UTILS::Color> &, const vecText &, uint32_t, float, bool, unsigned int, bool &);
 template void CGUIFontCache<CGUIFontCacheDynamicPosition, CGUIFontCacheDynamicValue>::Flush();
+template void CGUIFontCache<CGUIFontCacheDynamicPosition, CGUIFontCacheDynamicValue>::Flush(const std::function<bool(const vecText &, uint32_t)> &);
 
 void CVertexBuffer::clear()
 {
@@ -30,6 +30,7 @@
 #include <stdint.h>
 
 #include <algorithm>
+#include <functional>
 #include <vector>
 #include <memory>
 #include <cassert>
@@ -154,6 +155,8 @@ public:
                 bool scrolling,
                 unsigned int nowMillis, bool &dirtyCache);
   void Flush();
+  /*! \brief Drop the entries for which uses(text, alignment) returns true */
+  void Flush(const std::function<bool(const vecText &, uint32_t)> &uses);
 };
 
 struct CGUIFontCacheStaticPosition
@@ -27,6 +27,7 @@
 #include "addons/FontResource.h"
 #include "GUIFontTTF.h"
 #include "GUIFont.h"
+#include "GUITextLayoutCache.h"
 #include "utils/XMLUtils.h"
 #include "GUIControlFactory.h"
 #include "filesystem/Directory.h"
@@ -41,6 +42,7 @@
 
 #ifdef TARGET_POSIX
 #include "filesystem/SpecialProtocol.h"
+#include "threads/SingleLock.h"
 #endif
 
 using namespace ADDON;
@@ -251,6 +253,9 @@ void GUIFontManager::ReloadTTFFonts(void)
 
     font->SetFont(pFontFile);
   }
+
+  CSingleLock lock(CServiceBroker::GetWinSystem()->GetGfxContext());
+  CGUITextLayoutCache::GetInstance().Clear();
 }
 
 void GUIFontManager::Unload(const std::string& strFontName)
@@ -259,6 +264,9 @@ void GUIFontManager::Unload(const std::string& strFontName)
   {
     if (StringUtils::EqualsNoCase((*iFont)->GetFontName(), strFontName))
     {
+      // layouts may refer to the font, including ones being made in the background
+      CSingleLock lock(CServiceBroker::GetWinSystem()->GetGfxContext());
+      CGUITextLayoutCache::GetInstance().Clear();
       delete (*iFont);
       m_vecFonts.erase(iFont);
       return;
@@ -340,6 +348,10 @@ CGUIFont* GUIFontManager::GetDefaultFont(bool border)
 
 void GUIFontManager::Clear()
 {
+  // layouts may refer to the fonts, including ones being made in the background
+  CSingleLock lock(CServiceBroker::GetWinSystem()->GetGfxContext());
+  CGUITextLayoutCache::GetInstance().Clear();
+
   for (int i = 0; i < (int)m_vecFonts.size(); ++i)
   {
     CGUIFont* pFont = m_vecFonts[i];
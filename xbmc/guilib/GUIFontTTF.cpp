@@ -25,6 +25,7 @@
 #include "windowing/GraphicContext.h"
 #include "ServiceBroker.h"
 #include "filesystem/SpecialProtocol.h"
+#include "utils/FrameProfiler.h"
 #include "utils/MathUtils.h"
 #include "utils/log.h"
 #include "rendering/RenderSystem.h"
@@ -32,6 +33,7 @@
 #include "URL.h"
 #include "filesystem/File.h"
 #include "threads/SystemClock.h"
+#include "utils/TimeUtils.h"
 
 #include <math.h>
 #include <memory>
@@ -59,6 +61,7 @@
 
 #define CHARS_PER_TEXTURE_LINE 20 // number of characters to cache per texture line
 #define CHAR_CHUNK    64      // 64 chars allocated at a time (1024 bytes)
+#define GLYPH_CACHE_HEIGHT 2048 // cache texture height after which the least recently used lines are reused
 #define GLYPH_STRENGTH_BOLD 24
 #define GLYPH_STRENGTH_LIGHT -48
 
@@ -179,6 +182,7 @@ CGUIFontTTFBase::CGUIFontTTFBase(const std::string& strFileName) : m_staticCache
   m_cellBaseLine = m_cellHeight = 0;
   m_numChars = 0;
   m_posX = m_posY = 0;
+  m_numTextureLines = 0;
   m_textureHeight = m_textureWidth = 0;
   m_textureScaleX = m_textureScaleY = 0.0;
   m_ellipsesWidth = m_height = 0.0f;
@@ -219,9 +223,11 @@ void CGUIFontTTFBase::ClearCharacterCache()
   memset(m_charquick, 0, sizeof(m_charquick));
   m_numChars = 0;
   m_maxChars = CHAR_CHUNK;
-  // set the posX and posY so that our texture will be created on first character write.
+  // set the posX so that our texture will be created on first character write.
   m_posX = m_textureWidth;
-  m_posY = -(int)GetTextureLineHeight();
+  m_posY = 0;
+  m_numTextureLines = 0;
+  m_textureLineUsed.clear();
   m_textureHeight = 0;
 }
 
@@ -236,6 +242,8 @@ void CGUIFontTTFBase::Clear()
   m_numChars = 0;
   m_posX = 0;
   m_posY = 0;
+  m_numTextureLines = 0;
+  m_textureLineUsed.clear();
   m_nestedBeginCount = 0;
 
   if (m_face)
@@ -329,9 +337,11 @@ bool CGUIFontTTFBase::Load(const std::string& strFilename, float height, float a
     m_textureWidth = m_renderSystem->GetMaxTextureSize();
   m_textureScaleX = 1.0f / m_textureWidth;
 
-  // set the posX and posY so that our texture will be created on first character write.
+  // set the posX so that our texture will be created on first character write.
   m_posX = m_textureWidth;
-  m_posY = -(int)GetTextureLineHeight();
+  m_posY = 0;
+  m_numTextureLines = 0;
+  m_textureLineUsed.clear();
 
   // cache the ellipses width
   Character *ellipse = GetCharacter(L'.');
@@ -554,6 +564,9 @@ void CGUIFontTTFBase::DrawTextInternal(float x, float y, const std::vector<UTILS
   }
   else
   {
+    // the cached vertices are drawn from the lines of these characters
+    TouchCharacters(text, rawAlignment);
+
     if (hardwareClipping)
       m_vertexTrans.push_back(CTranslatedVertices(dynamicPos.m_x, dynamicPos.m_y, dynamicPos.m_z, &vertexBuffer, CServiceBroker::GetWinSystem()->GetGfxContext().GetClipRegion()));
     else
@@ -611,21 +624,19 @@ unsigned int CGUIFontTTFBase::GetTextureLineHeight() const
   return m_cellHeight + spacing_between_characters_in_texture;
 }
 
-CGUIFontTTFBase::Character* CGUIFontTTFBase::GetCharacter(character_t chr)
+CGUIFontTTFBase::Character* CGUIFontTTFBase::FindCharacter(character_t chr)
 {
   wchar_t letter = (wchar_t)(chr & 0xffff);
   character_t style = (chr & 0x7000000) >> 24;
 
-  // ignore linebreaks
-  if (letter == L'\r')
-    return NULL;
+  Character *found = NULL;
 
   // quick access to ascii chars
   if (letter < 255)
   {
     character_t ch = (style << 8) | letter;
-    if (ch < LOOKUPTABLE_SIZE && m_charquick[ch])
-      return m_charquick[ch];
+    if (ch < LOOKUPTABLE_SIZE)
+      found = m_charquick[ch];
   }
 
   // letters are stored based on style and letter
@@ -633,7 +644,7 @@ CGUIFontTTFBase::Character* CGUIFontTTFBase::GetCharacter(character_t chr)
 
   int low = 0;
   int high = m_numChars - 1;
-  while (low <= high)
+  while (!found && low <= high)
   {
     int mid = (low + high) >> 1;
     if (ch > m_char[mid].letterAndStyle)
@@ -641,39 +652,51 @@ CGUIFontTTFBase::Character* CGUIFontTTFBase::GetCharacter(character_t chr)
     else if (ch < m_char[mid].letterAndStyle)
       high = mid - 1;
     else
-      return &m_char[mid];
+      found = &m_char[mid];
   }
-  // if we get to here, then low is where we should insert the new character
 
-  // increase the size of the buffer if we need it
-  if (m_numChars >= m_maxChars)
-  { // need to increase the size of the buffer
-    Character *newTable = new Character[m_maxChars + CHAR_CHUNK];
-    if (m_char)
-    {
-      memcpy(newTable, m_char, low * sizeof(Character));
-      memcpy(newTable + low + 1, m_char + low, (m_numChars - low) * sizeof(Character));
-      delete[] m_char;
-    }
-    m_char = newTable;
-    m_maxChars += CHAR_CHUNK;
+  // keep the texture line from being reused while it's drawn from
+  if (found && found->line >= 0)
+    m_textureLineUsed[found->line] = CTimeUtils::GetFrameTime();
+
+  return found;
+}
+
+void CGUIFontTTFBase::TouchCharacters(const vecText &text, uint32_t alignment)
+{
+  if (alignment & XBFONT_TRUNCATED)
+    FindCharacter(L'.');
+  for (vecText::const_iterator pos = text.begin(); pos != text.end(); ++pos)
+    FindCharacter(*pos);
+}
+
+CGUIFontTTFBase::Character* CGUIFontTTFBase::GetCharacter(character_t chr)
+{
+  wchar_t letter = (wchar_t)(chr & 0xffff);
+  character_t style = (chr & 0x7000000) >> 24;
+
+  // ignore linebreaks
+  if (letter == L'\r')
+    return NULL;
+
+  Character *found = FindCharacter(chr);
+  if (found)
+    return found;
+
+  // letters are stored based on style and letter
+  character_t ch = (style << 16) | letter;
 
-  }
-  else
-  { // just move the data along as necessary
-    memmove(m_char + low + 1, m_char + low, (m_numChars - low) * sizeof(Character));
-  }
   // render the character to our texture
   // must End() as we can't render text to our texture during a Begin(), End() block
   unsigned int nestedBeginCount = m_nestedBeginCount;
   m_nestedBeginCount = 1;
   if (nestedBeginCount) End();
-  if (!CacheCharacter(letter, style, m_char + low))
+  Character newChar;
+  if (!CacheCharacter(letter, style, &newChar))
   { // unable to cache character - try clearing them all out and starting over
     CLog::Log(LOGDEBUG, "%s: Unable to cache character.  Clearing character cache of %i characters", __FUNCTION__, m_numChars);
     ClearCharacterCache();
-    low = 0;
-    if (!CacheCharacter(letter, style, m_char + low))
+    if (!CacheCharacter(letter, style, &newChar))
     {
       CLog::Log(LOGERROR, "%s: Unable to cache character (out of memory?)", __FUNCTION__);
       if (nestedBeginCount) Begin();
@@ -684,7 +707,46 @@ CGUIFontTTFBase::Character* CGUIFontTTFBase::GetCharacter(character_t chr)
   if (nestedBeginCount) Begin();
   m_nestedBeginCount = nestedBeginCount;
 
-  // fixup quick access
+  // caching may have evicted characters, so find where the new one goes
+  int low = 0;
+  int high = m_numChars - 1;
+  while (low <= high)
+  {
+    int mid = (low + high) >> 1;
+    if (ch > m_char[mid].letterAndStyle)
+      low = mid + 1;
+    else
+      high = mid - 1;
+  }
+
+  // increase the size of the buffer if we need it
+  if (m_numChars >= m_maxChars)
+  { // need to increase the size of the buffer
+    Character *newTable = new Character[m_maxChars + CHAR_CHUNK];
+    if (m_char)
+    {
+      memcpy(newTable, m_char, low * sizeof(Character));
+      memcpy(newTable + low + 1, m_char + low, (m_numChars - low) * sizeof(Character));
+      delete[] m_char;
+    }
+    m_char = newTable;
+    m_maxChars += CHAR_CHUNK;
+
+  }
+  else
+  { // just move the data along as necessary
+    memmove(m_char + low + 1, m_char + low, (m_numChars - low) * sizeof(Character));
+  }
+  m_char[low] = newChar;
+  m_numChars++;
+
+  RebuildQuickLookup();
+
+  return m_char + low;
+}
+
+void CGUIFontTTFBase::RebuildQuickLookup()
+{
   memset(m_charquick, 0, sizeof(m_charquick));
   for(int i=0;i<m_numChars;i++)
   {
@@ -694,12 +756,102 @@ CGUIFontTTFBase::Character* CGUIFontTTFBase::GetCharacter(character_t chr)
       m_charquick[ch] = m_char+i;
     }
   }
+}
 
-  return m_char + low;
+bool CGUIFontTTFBase::NextTextureLine()
+{
+  const unsigned int lineHeight = GetTextureLineHeight();
+
+  // continue below the lines filled so far while the texture has room for it ...
+  unsigned int posY = m_numTextureLines * lineHeight;
+  if (m_texture && posY + lineHeight <= m_textureHeight)
+  {
+    m_posY = posY;
+    m_numTextureLines++;
+    return true;
+  }
+
+  // ... or grow it, until it's large enough to be worth reusing lines that haven't been drawn from lately ...
+  unsigned int maxHeight = std::min<unsigned int>(GLYPH_CACHE_HEIGHT, m_renderSystem->GetMaxTextureSize());
+  if (posY + lineHeight > maxHeight && EvictTextureLine())
+    return true;
+
+  // ... and only grow further if every line is in use right now
+  unsigned int newHeight = posY + lineHeight;
+  if (newHeight > m_renderSystem->GetMaxTextureSize())
+  {
+    CLog::Log(LOGDEBUG, "%s: New cache texture is too large (%u > %u pixels long)", __FUNCTION__, newHeight, m_renderSystem->GetMaxTextureSize());
+    return false;
+  }
+
+  CBaseTexture* newTexture = ReallocTexture(newHeight);
+  if (newTexture == NULL)
+  {
+    CLog::Log(LOGDEBUG, "%s: Failed to allocate new texture of height %u", __FUNCTION__, newHeight);
+    return false;
+  }
+  m_texture = newTexture;
+  m_textureLineUsed.resize(m_textureHeight / lineHeight, 0);
+
+  m_posY = posY;
+  m_numTextureLines++;
+  return true;
+}
+
+bool CGUIFontTTFBase::EvictTextureLine()
+{
+  // find the least recently drawn from line that hasn't been used during this frame
+  const unsigned int frameTime = CTimeUtils::GetFrameTime();
+  int line = -1;
+  for (unsigned int i = 0; i < m_numTextureLines; i++)
+  {
+    if (m_textureLineUsed[i] != frameTime && (line < 0 || m_textureLineUsed[i] < m_textureLineUsed[line]))
+      line = i;
+  }
+  if (line < 0)
+    return false;
+
+  // drop its characters from the (sorted) table
+  std::vector<character_t> evicted;
+  int numChars = 0;
+  for (int i = 0; i < m_numChars; i++)
+  {
+    if (m_char[i].line != line)
+      m_char[numChars++] = m_char[i];
+    else
+      evicted.push_back(m_char[i].letterAndStyle);
+  }
+  m_numChars = numChars;
+  RebuildQuickLookup();
+
+  // only the cached vertices of text drawing one of the dropped characters refer to the line.
+  // as drawing cached text keeps its lines in use, these haven't been drawn for a while either
+  auto uses = [&evicted](const vecText &text, uint32_t alignment)
+  {
+    if ((alignment & XBFONT_TRUNCATED) && std::binary_search(evicted.begin(), evicted.end(), static_cast<character_t>(L'.')))
+      return true;
+    for (vecText::const_iterator pos = text.begin(); pos != text.end(); ++pos)
+    {
+      const character_t ch = (((*pos & 0x7000000) >> 24) << 16) | (*pos & 0xffff);
+      if (std::binary_search(evicted.begin(), evicted.end(), ch))
+        return true;
+    }
+    return false;
+  };
+  m_staticCache.Flush(uses);
+  m_dynamicCache.Flush(uses);
+
+  const unsigned int lineHeight = GetTextureLineHeight();
+  m_posY = line * lineHeight;
+  ClearTextureRows(m_posY, std::min(m_posY + lineHeight, m_textureHeight));
+  m_textureLineUsed[line] = frameTime;
+  return true;
 }
 
 bool CGUIFontTTFBase::CacheCharacter(wchar_t letter, uint32_t style, Character *ch)
 {
+  CFrameProfilerScope profile("font", "CGUIFontTTFBase::CacheCharacter", static_cast<int>(letter));
+
   int glyph_index = FT_Get_Char_Index( m_face, letter );
 
   FT_Glyph glyph = NULL;
@@ -743,33 +895,15 @@ bool CGUIFontTTFBase::CacheCharacter(wchar_t letter, uint32_t style, Character *
     // check we have enough room for the character.
     // cast-fest is here to avoid warnings due to freeetype version differences (signedness of width).
     if (static_cast<int>(m_posX + bitGlyph->left + bitmap.width) > static_cast<int>(m_textureWidth))
-    { // no space - gotta drop to the next line (which means creating a new texture and copying it across)
+    { // no space - gotta drop to the next line (which may mean reusing an old line or growing the texture)
       m_posX = 0;
-      m_posY += GetTextureLineHeight();
       if (bitGlyph->left < 0)
         m_posX += -bitGlyph->left;
 
-      if(m_posY + GetTextureLineHeight() >= m_textureHeight)
+      if (!NextTextureLine())
       {
-        // create the new larger texture
-        unsigned int newHeight = m_posY + GetTextureLineHeight();
-        // check for max height
-        if (newHeight > m_renderSystem->GetMaxTextureSize())
-        {
-          CLog::Log(LOGDEBUG, "%s: New cache texture is too large (%u > %u pixels long)", __FUNCTION__, newHeight, m_renderSystem->GetMaxTextureSize());
-          FT_Done_Glyph(glyph);
-          return false;
-        }
-
-        CBaseTexture* newTexture = NULL;
-        newTexture = ReallocTexture(newHeight);
-        if(newTexture == NULL)
-        {
-          FT_Done_Glyph(glyph);
-          CLog::Log(LOGDEBUG, "%s: Failed to allocate new texture of height %u", __FUNCTION__, newHeight);
-          return false;
-        }
-        m_texture = newTexture;
+        FT_Done_Glyph(glyph);
+        return false;
       }
     }
 
@@ -789,6 +923,7 @@ bool CGUIFontTTFBase::CacheCharacter(wchar_t letter, uint32_t style, Character *
   ch->right = ch->left + bitmap.width;
   ch->bottom = ch->top + bitmap.rows;
   ch->advance = (float)MathUtils::round_int( (float)m_face->glyph->advance.x / 64 );
+  ch->line = isEmptyGlyph ? -1 : static_cast<short>(m_posY / GetTextureLineHeight());
 
   // we need only render if we actually have some pixels
   if (!isEmptyGlyph)
@@ -801,8 +936,8 @@ bool CGUIFontTTFBase::CacheCharacter(wchar_t letter, uint32_t style, Character *
     CopyCharToTexture(bitGlyph, x1, y1, x2, y2);
 
     m_posX += spacing_between_characters_in_texture + (unsigned short)std::max(ch->right - ch->left + ch->offsetX, ch->advance);
+    m_textureLineUsed[ch->line] = CTimeUtils::GetFrameTime();
   }
-  m_numChars++;
 
   // free the glyph
   FT_Done_Glyph(glyph);
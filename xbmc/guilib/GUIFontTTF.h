@@ -104,6 +104,7 @@ protected:
     float left, top, right, bottom;
     float advance;
     character_t letterAndStyle;
+    short line;                      // texture line holding the glyph, -1 if it has no pixels
   };
   void AddReference();
   void RemoveReference();
@@ -123,12 +124,18 @@ protected:
 
   // Stuff for pre-rendering for speed
   inline Character *GetCharacter(character_t letter);
+  Character *FindCharacter(character_t letter);
+  void TouchCharacters(const vecText &text, uint32_t alignment);
   bool CacheCharacter(wchar_t letter, uint32_t style, Character *ch);
   void RenderCharacter(float posX, float posY, const Character *ch, UTILS::Color color, bool roundX, std::vector<SVertex> &vertices);
   void ClearCharacterCache();
+  void RebuildQuickLookup();
+  bool NextTextureLine();
+  bool EvictTextureLine();
 
   virtual CBaseTexture* ReallocTexture(unsigned int& newHeight) = 0;
   virtual bool CopyCharToTexture(FT_BitmapGlyph bitGlyph, unsigned int x1, unsigned int y1, unsigned int x2, unsigned int y2) = 0;
+  virtual void ClearTextureRows(unsigned int y1, unsigned int y2) = 0;
   virtual void DeleteHardwareTexture() = 0;
 
   // modifying glyphs
@@ -141,6 +148,8 @@ protected:
   unsigned int m_textureHeight;      // height of our texture
   int m_posX;                        // current position in the texture
   int m_posY;
+  unsigned int m_numTextureLines;    // number of texture lines that have been filled so far
+  std::vector<unsigned int> m_textureLineUsed; // frame time each texture line was last drawn from
 
   /*! \brief the height of each line in the texture.
    Accounts for spacing between lines to avoid characters overlapping.
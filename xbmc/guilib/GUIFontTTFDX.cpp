@@ -290,6 +290,17 @@ bool CGUIFontTTFDX::CopyCharToTexture(FT_BitmapGlyph bitGlyph, unsigned int x1,
   return false;
 }
 
+void CGUIFontTTFDX::ClearTextureRows(unsigned int y1, unsigned int y2)
+{
+  ComPtr<ID3D11DeviceContext> pContext = DX::DeviceResources::Get()->GetImmediateContext();
+  if (m_speedupTexture && m_speedupTexture->Get() && pContext && y2 > y1)
+  {
+    std::vector<uint8_t> zero(m_textureWidth * (y2 - y1), 0);
+    CD3D11_BOX dstBox(0, y1, 0, m_textureWidth, y2, 1);
+    pContext->UpdateSubresource(m_speedupTexture->Get(), 0, &dstBox, zero.data(), m_textureWidth, 0);
+  }
+}
+
 void CGUIFontTTFDX::DeleteHardwareTexture()
 {
 }
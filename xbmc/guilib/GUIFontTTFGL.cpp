@@ -365,6 +365,20 @@ bool CGUIFontTTFGL::CopyCharToTexture(FT_BitmapGlyph bitGlyph, unsigned int x1,
     target += m_texture->GetPitch();
   }
 
+  MarkTextureUpdated(y1, y2);
+
+  return true;
+}
+
+void CGUIFontTTFGL::ClearTextureRows(unsigned int y1, unsigned int y2)
+{
+  memset(m_texture->GetPixels() + y1 * m_texture->GetPitch(), 0, (y2 - y1) * m_texture->GetPitch());
+
+  MarkTextureUpdated(y1, y2);
+}
+
+void CGUIFontTTFGL::MarkTextureUpdated(unsigned int y1, unsigned int y2)
+{
   switch (m_textureStatus)
   {
   case TEXTURE_UPDATED:
@@ -392,8 +406,6 @@ bool CGUIFontTTFGL::CopyCharToTexture(FT_BitmapGlyph bitGlyph, unsigned int x1,
   default:
     break;
   }
-
-  return true;
 }
 
 void CGUIFontTTFGL::DeleteHardwareTexture()
@@ -320,6 +320,24 @@ void CGUIImage::SetCrossFade(unsigned int time)
     m_crossFadeTime = 1;
 }
 
+bool CGUIImage::IsLoading() const
+{
+  return IsVisible() && m_texture.IsLoading();
+}
+
+std::string CGUIImage::GetLargeImage(const CGUIListItem *item) const
+{
+  if (m_info.IsConstant())
+    return "";
+
+  std::string path = m_info.GetItemLabel(item, true);
+  if (path.empty())
+    path = m_info.GetFallback();
+  if (path.empty() || (!m_texture.IsLazyLoaded() && CServiceBroker::GetGUI()->GetTextureManager().CanLoad(path)))
+    return "";
+  return path;
+}
+
 void CGUIImage::SetFileName(const std::string& strFileName, bool setConstant, const bool useCache)
 {
   if (setConstant)
@@ -93,6 +93,13 @@ public:
   void SetCrossFade(unsigned int time);
 
   const std::string& GetFileName() const;
+  bool IsLoading() const;
+
+  /*! \brief Get the image this control would show for a list item, if it's loaded in the background.
+   \param item the list item.
+   \return path of the image, empty if there is none or it isn't loaded by the large texture manager.
+   */
+  std::string GetLargeImage(const CGUIListItem *item) const;
   float GetTextureWidth() const;
   float GetTextureHeight() const;
 
@@ -182,6 +182,11 @@ bool CGUILabel::SetText(const std::string &label)
     return false;
 }
 
+void CGUILabel::PrecomputeText(const std::string &label) const
+{
+  m_textLayout.Precompute(label, m_maxRect.Width());
+}
+
 bool CGUILabel::SetTextW(const std::wstring &label)
 {
   if (m_textLayout.UpdateW(label, m_maxRect.Width(), m_invalid))
@@ -138,6 +138,12 @@ public:
    */
   bool SetStyledText(const vecText &text, const std::vector<UTILS::Color> &colors);
 
+  /*! \brief Lay out text in the background that is likely to be set on this label soon
+   \param label text that will be passed to SetText
+   \sa SetText, CGUITextLayout::Precompute
+   */
+  void PrecomputeText(const std::string &label) const;
+
   /*! \brief Set the color to use for the label
    Sets the color to be used for this label.  Takes effect at the next render
    \param color color to be used for the label
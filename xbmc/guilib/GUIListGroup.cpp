@@ -20,6 +20,7 @@
 
 #include "GUIListGroup.h"
 #include "GUIListLabel.h"
+#include "GUIImage.h"
 #include "utils/log.h"
 
 CGUIListGroup::CGUIListGroup(int parentID, int controlID, float posX, float posY, float width, float height)
@@ -222,6 +223,52 @@ void CGUIListGroup::SetState(bool selected, bool focused)
   }
 }
 
+void CGUIListGroup::PrecomputeLabels(const CGUIListItem *item) const
+{
+  for (ciControls it = m_children.begin(); it != m_children.end(); ++it)
+  {
+    if ((*it)->GetControlType() == CGUIControl::GUICONTROL_LISTLABEL)
+      static_cast<const CGUIListLabel*>(*it)->PrecomputeLabel(item);
+    else if ((*it)->GetControlType() == CGUIControl::GUICONTROL_LISTGROUP)
+      static_cast<const CGUIListGroup*>(*it)->PrecomputeLabels(item);
+  }
+}
+
+void CGUIListGroup::GetLargeImages(const CGUIListItem *item, std::vector<std::string> &images) const
+{
+  for (ciControls it = m_children.begin(); it != m_children.end(); ++it)
+  {
+    if ((*it)->GetControlType() == CGUIControl::GUICONTROL_IMAGE ||
+        (*it)->GetControlType() == CGUIControl::GUICONTROL_BORDEREDIMAGE)
+    {
+      std::string image = static_cast<const CGUIImage*>(*it)->GetLargeImage(item);
+      if (!image.empty())
+        images.push_back(image);
+    }
+    else if ((*it)->GetControlType() == CGUIControl::GUICONTROL_LISTGROUP)
+      static_cast<const CGUIListGroup*>(*it)->GetLargeImages(item, images);
+  }
+}
+
+bool CGUIListGroup::HasLoadingImages() const
+{
+  for (ciControls it = m_children.begin(); it != m_children.end(); ++it)
+  {
+    if ((*it)->GetControlType() == CGUIControl::GUICONTROL_IMAGE ||
+        (*it)->GetControlType() == CGUIControl::GUICONTROL_BORDEREDIMAGE)
+    {
+      if (static_cast<const CGUIImage*>(*it)->IsLoading())
+        return true;
+    }
+    else if ((*it)->GetControlType() == CGUIControl::GUICONTROL_LISTGROUP)
+    {
+      if (static_cast<const CGUIListGroup*>(*it)->HasLoadingImages())
+        return true;
+    }
+  }
+  return false;
+}
+
 void CGUIListGroup::SelectItemFromPoint(const CPoint &point)
 {
   CPoint controlCoords(point);
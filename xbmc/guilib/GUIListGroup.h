@@ -55,6 +55,9 @@ public:
   bool MoveRight();
   void SetState(bool selected, bool focused);
   void SelectItemFromPoint(const CPoint &point);
+  void PrecomputeLabels(const CGUIListItem *item) const;
+  void GetLargeImages(const CGUIListItem *item, std::vector<std::string> &images) const;
+  bool HasLoadingImages() const;
 
 protected:
   const CGUIListItem *m_item;
@@ -55,6 +55,13 @@ public:
   bool MoveLeft();
   bool MoveRight();
 
+  /*! \brief Lay out the text of this layout's labels for an item in the background, ahead of the item being shown.
+   \sa CGUITextLayout::Precompute
+   */
+  void PrecomputeLabels(const CGUIListItem *item) const { m_group.PrecomputeLabels(item); };
+  void GetLargeImages(const CGUIListItem *item, std::vector<std::string> &images) const { m_group.GetLargeImages(item, images); };
+  bool HasLoadingImages() const { return m_group.HasLoadingImages(); };
+
 #ifdef _DEBUG
   void DumpTextureUse();
 #endif
@@ -112,6 +112,12 @@ void CGUIListLabel::SetWidth(float width)
   CGUIControl::SetWidth(m_width);
 }
 
+void CGUIListLabel::PrecomputeLabel(const CGUIListItem *item) const
+{
+  if (!m_info.IsConstant())
+    m_label.PrecomputeText(m_info.GetItemLabel(item));
+}
+
 void CGUIListLabel::SetLabel(const std::string &label)
 {
   m_label.SetText(label);
@@ -51,6 +51,7 @@ public:
   void SetWidth(float width) override;
 
   void SetLabel(const std::string &label);
+  void PrecomputeLabel(const CGUIListItem *item) const;
   void SetSelected(bool selected);
   void SetScrolling(bool scrolling);
 
@@ -171,6 +171,16 @@
  */
 #define GUI_MSG_SUBTITLE_DOWNLOADED  52
 
+/*!
+ \brief A container is close to the end of a listing that is fetched a page at a time
+ */
+#define GUI_MSG_LOAD_PAGE  53
+
+/*!
+ \brief A page of a listing has been fetched in the background
+ */
+#define GUI_MSG_PAGE_LOADED  54
+
 
 #define GUI_MSG_USER         1000
 
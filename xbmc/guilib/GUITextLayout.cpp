@@ -22,9 +22,29 @@
 #include "GUIFont.h"
 #include "GUIControl.h"
 #include "GUIColorManager.h"
+#include "GUITextLayoutCache.h"
 #include "utils/CharsetConverter.h"
+#include "utils/JobManager.h"
 #include "utils/StringUtils.h"
 
+namespace
+{
+
+void GetLayoutCacheKey(const std::wstring &text, CGUIFont *font, UTILS::Color textColor, bool wrap, float maxHeight, float maxWidth, bool forceLTRReadingOrder, CGUITextLayoutCache::Key &key)
+{
+  key.text = text;
+  key.font = font;
+  key.style = font->GetStyle();
+  key.textColor = textColor;
+  key.maxWidth = (wrap && maxWidth > 0) ? maxWidth : 0;
+  key.maxHeight = maxHeight;
+  key.forceLTRReadingOrder = forceLTRReadingOrder;
+  key.scaleX = CServiceBroker::GetWinSystem()->GetGfxContext().GetGUIScaleX();
+  key.scaleY = CServiceBroker::GetWinSystem()->GetGfxContext().GetGUIScaleY();
+}
+
+}
+
 CGUIString::CGUIString(iString start, iString end, bool carriageReturn)
 {
   m_text.assign(start, end);
@@ -238,13 +258,108 @@ bool CGUITextLayout::UpdateW(const std::wstring &text, float maxWidth /*= 0*/, b
 
 void CGUITextLayout::UpdateCommon(const std::wstring &text, float maxWidth, bool forceLTRReadingOrder)
 {
-  // parse the text for style information
-  vecText parsedText;
-  std::vector<UTILS::Color> colors;
-  ParseText(text, m_font ? m_font->GetStyle() : 0, m_textColor, colors, parsedText);
+  // check whether the text has been laid out before
+  CGUITextLayoutCache::Key key;
+  CGUITextLayoutCache::EntryPtr cached;
+  if (m_font)
+  {
+    GetLayoutCacheKey(text, m_font, m_textColor, m_wrap, m_maxHeight, maxWidth, forceLTRReadingOrder, key);
+    cached = CGUITextLayoutCache::GetInstance().Get(key);
+    if (cached && cached->measured)
+    {
+      m_lines = cached->lines;
+      m_colors = cached->colors;
+      m_textWidth = cached->width;
+      m_textHeight = cached->height;
+      return;
+    }
+  }
 
-  // and update
-  UpdateStyled(parsedText, colors, maxWidth, forceLTRReadingOrder);
+  if (cached)
+  { // parsed by Precompute(), what's left needs the font
+    if (m_wrap && maxWidth > 0)
+      UpdateStyled(cached->text, cached->colors, maxWidth, forceLTRReadingOrder);
+    else
+      UpdateLines(cached->lines, cached->colors);
+  }
+  else
+  {
+    // parse the text for style information
+    vecText parsedText;
+    std::vector<UTILS::Color> colors;
+    ParseText(text, m_font ? m_font->GetStyle() : 0, m_textColor, colors, parsedText);
+
+    // and update
+    UpdateStyled(parsedText, colors, maxWidth, forceLTRReadingOrder);
+  }
+
+  if (m_font)
+  {
+    std::shared_ptr<CGUITextLayoutCache::Entry> entry(new CGUITextLayoutCache::Entry);
+    entry->measured = true;
+    entry->lines = m_lines;
+    entry->colors = m_colors;
+    entry->width = m_textWidth;
+    entry->height = m_textHeight;
+    CGUITextLayoutCache::GetInstance().Add(key, entry);
+  }
+}
+
+void CGUITextLayout::UpdateLines(const std::vector<CGUIString> &lines, const std::vector<UTILS::Color> &colors)
+{
+  m_colors = colors;
+
+  int maxLines = GetMaxLines();
+  if (maxLines > 0 && lines.size() > static_cast<size_t>(maxLines))
+    m_lines.assign(lines.begin(), lines.begin() + maxLines);
+  else
+    m_lines = lines;
+
+  // remove any trailing blank lines
+  while (!m_lines.empty() && m_lines.back().m_text.empty())
+    m_lines.pop_back();
+
+  CalcTextExtent();
+}
+
+void CGUITextLayout::Precompute(const std::string &text, float maxWidth, bool forceLTRReadingOrder) const
+{
+  if (!m_font || text.empty())
+    return;
+
+  CGUITextLayoutCache::Key key;
+  std::wstring utf16;
+  g_charsetConverter.utf8ToW(text, utf16, false);
+
+  // colors are looked up by name in the skin, which is left to the render thread
+  if (utf16.find(L"[COLOR") != std::wstring::npos)
+    return;
+
+  GetLayoutCacheKey(utf16, m_font, m_textColor, m_wrap, m_maxHeight, maxWidth, forceLTRReadingOrder, key);
+  if (!CGUITextLayoutCache::GetInstance().BeginPrecompute(key))
+    return;
+
+  unsigned int generation = CGUITextLayoutCache::GetInstance().GetGeneration();
+  CJobManager::GetInstance().Submit([key, generation]() {
+    // the fonts are only ever used by the render thread, which may be drawing with them right now.
+    // So only parse and, unless the text is wrapped, break and flip the lines here.
+    // Wrapping and measuring are left to the Update() finding this in the cache
+    std::shared_ptr<CGUITextLayoutCache::Entry> entry(new CGUITextLayoutCache::Entry);
+    entry->measured = false;
+    ParseText(key.text, key.style, key.textColor, entry->colors, entry->text);
+    if (key.maxWidth <= 0)
+    {
+      CGUITextLayout layout(nullptr, false); // no font, so no maximum number of lines either
+      layout.LineBreakText(entry->text, entry->lines);
+      BidiTransform(entry->lines, key.forceLTRReadingOrder);
+      entry->text.clear();
+    }
+
+    CGUITextLayoutCache &layoutCache = CGUITextLayoutCache::GetInstance();
+    if (layoutCache.GetGeneration() == generation)
+      layoutCache.Add(key, entry);
+    layoutCache.EndPrecompute(key);
+  });
 }
 
 void CGUITextLayout::UpdateStyled(const vecText &text, const std::vector<UTILS::Color> &colors, float maxWidth, bool forceLTRReadingOrder)
@@ -499,7 +614,7 @@ void CGUITextLayout::WrapText(const vecText &text, float maxWidth)
   if (!m_font)
     return;
 
-  int nMaxLines = (m_maxHeight > 0 && m_font->GetLineHeight() > 0)?(int)ceilf(m_maxHeight / m_font->GetLineHeight()):-1;
+  int nMaxLines = GetMaxLines();
 
   m_lines.clear();
 
@@ -573,7 +688,7 @@ void CGUITextLayout::WrapText(const vecText &text, float maxWidth)
 
 void CGUITextLayout::LineBreakText(const vecText &text, std::vector<CGUIString> &lines)
 {
-  int nMaxLines = (m_maxHeight > 0 && m_font && m_font->GetLineHeight() > 0)?(int)ceilf(m_maxHeight / m_font->GetLineHeight()):-1;
+  int nMaxLines = GetMaxLines();
   vecText::const_iterator lineStart = text.begin();
   vecText::const_iterator pos = text.begin();
   while (pos != text.end() && (nMaxLines <= 0 || lines.size() < (size_t)nMaxLines))
@@ -598,6 +713,11 @@ void CGUITextLayout::LineBreakText(const vecText &text, std::vector<CGUIString>
   }
 }
 
+int CGUITextLayout::GetMaxLines() const
+{
+  return (m_maxHeight > 0 && m_font && m_font->GetLineHeight() > 0)?(int)ceilf(m_maxHeight / m_font->GetLineHeight()):-1;
+}
+
 void CGUITextLayout::GetTextExtent(float &width, float &height) const
 {
   width = m_textWidth;
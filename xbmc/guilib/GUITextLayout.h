@@ -105,6 +105,16 @@ public:
    */
   void UpdateStyled(const vecText &text, const std::vector<UTILS::Color> &colors, float maxWidth = 0, bool forceLTRReadingOrder = false);
 
+  /*! \brief Prepare the layout of text in the background, so that a later Update() with the same text finds it in the layout cache.
+   Parsing and bidi flipping happen on a job thread. Wrapping and measuring need the font, so they are left to
+   the Update() on the render thread. Must be called from the render thread, as the current GUI scale is part of the layout.
+   \param text the utf8 text to lay out.
+   \param maxWidth the maximum width for wrapping text, defaults to 0 (no max width).
+   \param forceLTRReadingOrder whether to force left to right reading order, defaults to false.
+   \sa Update
+   */
+  void Precompute(const std::string &text, float maxWidth = 0, bool forceLTRReadingOrder = false) const;
+
   unsigned int GetTextLength() const;
   void GetFirstText(vecText &text) const;
   void Reset();
@@ -122,6 +132,8 @@ protected:
   static void BidiTransform(std::vector<CGUIString> &lines, bool forceLTRReadingOrder);
   static std::wstring BidiFlip(const std::wstring &text, bool forceLTRReadingOrder);
   void CalcTextExtent();
+  int GetMaxLines() const;
+  void UpdateLines(const std::vector<CGUIString> &lines, const std::vector<UTILS::Color> &colors);
   void UpdateCommon(const std::wstring &text, float maxWidth, bool forceLTRReadingOrder);
 
   /*! \brief Returns the text, utf8 encoded
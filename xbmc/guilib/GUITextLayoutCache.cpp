@@ -0,0 +1,109 @@
+/*
+ *      Copyright (C) 2018 Team Kodi
+ *      http://kodi.tv
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this Program; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+
+#include "GUITextLayoutCache.h"
+
+#include <tuple>
+
+#include "threads/SingleLock.h"
+
+#define TEXT_LAYOUT_CACHE_SIZE 2048 // number of layouts kept around
+
+bool CGUITextLayoutCache::Key::operator<(const Key &right) const
+{
+  return std::tie(font, style, textColor, maxWidth, maxHeight, forceLTRReadingOrder, scaleX, scaleY, text) <
+         std::tie(right.font, right.style, right.textColor, right.maxWidth, right.maxHeight, right.forceLTRReadingOrder, right.scaleX, right.scaleY, right.text);
+}
+
+CGUITextLayoutCache& CGUITextLayoutCache::GetInstance()
+{
+  static CGUITextLayoutCache layoutCache;
+  return layoutCache;
+}
+
+CGUITextLayoutCache::EntryPtr CGUITextLayoutCache::Get(const Key &key)
+{
+  CSingleLock lock(m_section);
+  m_requests++;
+  auto it = m_lookup.find(key);
+  if (it == m_lookup.end())
+    return EntryPtr();
+
+  m_hits++;
+  m_entries.splice(m_entries.begin(), m_entries, it->second);
+  return it->second->second;
+}
+
+void CGUITextLayoutCache::Add(const Key &key, const EntryPtr &entry)
+{
+  CSingleLock lock(m_section);
+  auto it = m_lookup.find(key);
+  if (it != m_lookup.end())
+  {
+    if (entry->measured || !it->second->second->measured)
+      it->second->second = entry;
+    m_entries.splice(m_entries.begin(), m_entries, it->second);
+    return;
+  }
+
+  m_entries.emplace_front(key, entry);
+  m_lookup.insert(std::make_pair(key, m_entries.begin()));
+  while (m_entries.size() > TEXT_LAYOUT_CACHE_SIZE)
+  {
+    m_lookup.erase(m_entries.back().first);
+    m_entries.pop_back();
+  }
+}
+
+bool CGUITextLayoutCache::BeginPrecompute(const Key &key)
+{
+  CSingleLock lock(m_section);
+  if (m_lookup.find(key) != m_lookup.end())
+    return false;
+  return m_pending.insert(key).second;
+}
+
+void CGUITextLayoutCache::EndPrecompute(const Key &key)
+{
+  CSingleLock lock(m_section);
+  m_pending.erase(key);
+}
+
+void CGUITextLayoutCache::Clear()
+{
+  CSingleLock lock(m_section);
+  m_lookup.clear();
+  m_entries.clear();
+  m_generation++;
+}
+
+unsigned int CGUITextLayoutCache::GetGeneration() const
+{
+  CSingleLock lock(m_section);
+  return m_generation;
+}
+
+void CGUITextLayoutCache::GetStats(uint64_t &hits, uint64_t &requests) const
+{
+  CSingleLock lock(m_section);
+  hits = m_hits;
+  requests = m_requests;
+}
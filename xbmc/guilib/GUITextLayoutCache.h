@@ -0,0 +1,119 @@
+/*
+ *      Copyright (C) 2018 Team Kodi
+ *      http://kodi.tv
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this Program; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+
+#pragma once
+
+/*!
+\file GUITextLayoutCache.h
+\brief
+*/
+
+#include <list>
+#include <map>
+#include <memory>
+#include <set>
+#include <stdint.h>
+#include <string>
+#include <vector>
+
+#include "GUITextLayout.h"
+#include "threads/CriticalSection.h"
+#include "utils/Color.h"
+
+/*!
+ \ingroup labels
+ \brief Content addressed cache of text layouts shared by all CGUITextLayout instances.
+
+ A layout is identified by its text and everything that affects how it is broken into lines
+ and measured. Entries are evicted least recently used first.
+ */
+class CGUITextLayoutCache
+{
+public:
+  struct Key
+  {
+    std::wstring text;
+    CGUIFont *font;
+    uint32_t style;
+    UTILS::Color textColor;
+    float maxWidth;             ///< wrapping width, 0 if the text isn't wrapped
+    float maxHeight;
+    bool forceLTRReadingOrder;
+    float scaleX;
+    float scaleY;
+
+    bool operator<(const Key &right) const;
+  };
+
+  struct Entry
+  {
+    bool measured;              ///< false if only parsed in the background, see CGUITextLayout::Precompute
+    vecText text;               ///< parsed text still to be wrapped, if not measured
+    std::vector<CGUIString> lines;
+    std::vector<UTILS::Color> colors;
+    float width;
+    float height;
+  };
+  typedef std::shared_ptr<const Entry> EntryPtr;
+
+  static CGUITextLayoutCache& GetInstance();
+
+  /*! \brief Look up a layout, counting towards the hit rate.
+   \return the cached layout, or an empty pointer if it isn't cached
+   */
+  EntryPtr Get(const Key &key);
+  /*! \brief Cache a layout. A measured layout isn't replaced by one that isn't.
+   */
+  void Add(const Key &key, const EntryPtr &entry);
+
+  /*! \brief Reserve a key for background layout.
+   \return false if the key is already cached or being laid out
+   \sa EndPrecompute
+   */
+  bool BeginPrecompute(const Key &key);
+  void EndPrecompute(const Key &key);
+
+  /*! \brief Drop all layouts, e.g. when the fonts they refer to go away.
+   Must be called with the graphics context locked.
+   */
+  void Clear();
+
+  /*! \brief Incremented on every Clear(), so background layout can tell its font went away.
+   */
+  unsigned int GetGeneration() const;
+
+  void GetStats(uint64_t &hits, uint64_t &requests) const;
+
+private:
+  CGUITextLayoutCache() = default;
+  CGUITextLayoutCache(const CGUITextLayoutCache&) = delete;
+  CGUITextLayoutCache& operator=(const CGUITextLayoutCache&) = delete;
+
+  typedef std::list<std::pair<Key, EntryPtr> > EntryList;
+
+  mutable CCriticalSection m_section;
+  EntryList m_entries;                             ///< most recently used first
+  std::map<Key, EntryList::iterator> m_lookup;
+  std::set<Key> m_pending;
+  unsigned int m_generation = 0;
+  uint64_t m_hits = 0;
+  uint64_t m_requests = 0;
+};
@@ -116,6 +116,7 @@ public:
   bool HitTest(const CPoint &point) const { return CRect(m_posX, m_posY, m_posX + m_width, m_posY + m_height).PtInRect(point); };
   bool IsAllocated() const { return m_isAllocated != NO; };
   bool FailedToAlloc() const { return m_isAllocated == NORMAL_FAILED || m_isAllocated == LARGE_FAILED; };
+  bool IsLoading() const { return m_isAllocated == LARGE && !m_texture.size(); };
   bool ReadyToRender() const;
 protected:
   bool CalculateSize();
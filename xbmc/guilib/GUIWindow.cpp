@@ -25,6 +25,8 @@
 #include "GUIControlFactory.h"
 #include "GUIControlGroup.h"
 #include "GUIControlProfiler.h"
+#include "GUIWindowXMLCache.h"
+#include "TextureManager.h"
 
 #include "addons/Skin.h"
 #include "GUIInfoManager.h"
@@ -41,6 +43,7 @@
 #include "utils/Color.h"
 #include "utils/Variant.h"
 #include "utils/StringUtils.h"
+#include "utils/FrameProfiler.h"
 
 using namespace KODI::MESSAGING;
 
@@ -136,6 +139,11 @@ bool CGUIWindow::Load(const std::string& strFileName, bool bContainsPath)
 
 bool CGUIWindow::LoadXML(const std::string &strPath, const std::string &strLowerPath)
 {
+  // a window prepared before with the same includes and include conditions needn't be parsed or resolved again
+  std::unique_ptr<TiXmlElement> preparedRoot = CGUIWindowXMLCache::GetInstance().Get(strPath, m_xmlIncludeConditions);
+  if (preparedRoot)
+    return Load(preparedRoot.get());
+
   // load window xml if we don't have it stored yet
   if (!m_windowXMLRootElement)
   {
@@ -162,7 +170,11 @@ bool CGUIWindow::LoadXML(const std::string &strPath, const std::string &strLower
   else
     CLog::Log(LOGDEBUG, "Using already stored xml root node for %s", strPath.c_str());
 
-  return Load(Prepare(m_windowXMLRootElement).get());
+  preparedRoot = Prepare(m_windowXMLRootElement);
+  if (preparedRoot)
+    CGUIWindowXMLCache::GetInstance().Add(strPath, *preparedRoot, m_xmlIncludeConditions);
+
+  return Load(preparedRoot.get());
 }
 
 std::unique_ptr<TiXmlElement> CGUIWindow::Prepare(TiXmlElement *pRootElement)
@@ -192,6 +204,9 @@ bool CGUIWindow::Load(TiXmlElement *pRootElement)
   // now load in the skin file
   SetDefaults();
 
+  m_textures.clear();
+  GetTextures(pRootElement, m_textures);
+
   CGUIControlFactory::GetInfoColor(pRootElement, "backgroundcolor", m_clearBackground, GetID());
   CGUIControlFactory::GetActions(pRootElement, "onload", m_loadActions);
   CGUIControlFactory::GetActions(pRootElement, "onunload", m_unloadActions);
@@ -283,6 +298,21 @@ bool CGUIWindow::Load(TiXmlElement *pRootElement)
   return true;
 }
 
+void CGUIWindow::GetTextures(const TiXmlElement *element, std::vector<std::string> &textures)
+{
+  for (const TiXmlElement *child = element->FirstChildElement(); child; child = child->NextSiblingElement())
+  {
+    // <texture>, <texturefocus>, <bordertexture>, <midtexture> and so on
+    if (strstr(child->Value(), "texture") != nullptr)
+    {
+      const char *texture = child->GetText();
+      if (texture && *texture && !strchr(texture, '$'))
+        textures.push_back(texture);
+    }
+    GetTextures(child, textures);
+  }
+}
+
 void CGUIWindow::LoadControl(TiXmlElement* pControl, CGUIControlGroup *pGroup, const CRect &rect)
 {
   // get control type
@@ -339,6 +369,8 @@ void CGUIWindow::DoProcess(unsigned int currentTime, CDirtyRegionList &dirtyregi
   if (!IsControlDirty() && g_advancedSettings.m_guiSmartRedraw)
     return;
 
+  CFrameProfilerScope profile("window", "CGUIWindow::Process", GetID());
+
   CServiceBroker::GetWinSystem()->GetGfxContext().SetRenderingResolution(m_coordsRes, m_needsScaling);
   CServiceBroker::GetWinSystem()->GetGfxContext().AddGUITransform();
   CGUIControlGroup::DoProcess(currentTime, dirtyregions);
@@ -359,6 +391,8 @@ void CGUIWindow::DoRender()
   // to occur.
   if (!m_bAllocated) return;
 
+  CFrameProfilerScope profile("window", "CGUIWindow::Render", GetID());
+
   CServiceBroker::GetWinSystem()->GetGfxContext().SetRenderingResolution(m_coordsRes, m_needsScaling);
 
   CServiceBroker::GetWinSystem()->GetGfxContext().AddGUITransform();
@@ -765,8 +799,11 @@ void CGUIWindow::AllocResources(bool forceLoad /*= false */)
   slend = CurrentHostCounter();
 #endif
 
-  // and now allocate resources
+  // and now allocate resources, unpacking the bundled textures in one go first
+  CGUITextureManager &textureManager = CServiceBroker::GetGUI()->GetTextureManager();
+  textureManager.PreloadTextures(m_textures);
   CGUIControlGroup::AllocResources();
+  textureManager.ClearPreloadedTextures();
 
 #ifdef _DEBUG
   int64_t end, freq;
@@ -296,7 +296,14 @@ protected:
   bool m_custom;
 
 private:
+  /*! \brief Collect the names of the textures used by the window's controls
+   \param element the (prepared) window xml to search
+   \param textures [out] the texture names, without any that are set from infolabels
+   */
+  static void GetTextures(const TiXmlElement *element, std::vector<std::string> &textures);
+
   std::map<std::string, CVariant, icompare> m_mapProperties;
   std::map<INFO::InfoPtr, bool> m_xmlIncludeConditions; ///< \brief used to store conditions used to resolve includes for this window
+  std::vector<std::string> m_textures; ///< \brief textures referenced by the window xml, preloaded on AllocResources
 };
 
@@ -36,6 +36,7 @@
 #include "input/Key.h"
 #include "utils/log.h"
 #include "utils/StringUtils.h"
+#include "utils/FrameProfiler.h"
 
 #include "windows/GUIWindowHome.h"
 #include "events/windows/GUIWindowEventLog.h"
@@ -1120,6 +1121,7 @@ bool RenderOrderSortFunction(CGUIWindow *first, CGUIWindow *second)
 void CGUIWindowManager::Process(unsigned int currentTime)
 {
   assert(g_application.IsCurrentThread());
+  CFrameProfilerScope profile("gui", "CGUIWindowManager::Process");
   CSingleLock lock(CServiceBroker::GetWinSystem()->GetGfxContext());
 
   m_dirtyregions.clear();
@@ -1201,14 +1203,17 @@ void CGUIWindowManager::RenderEx() const
 bool CGUIWindowManager::Render()
 {
   assert(g_application.IsCurrentThread());
+  CFrameProfilerScope profile("gui", "CGUIWindowManager::Render");
   CSingleExit lock(CServiceBroker::GetWinSystem()->GetGfxContext());
 
   CDirtyRegionList dirtyRegions = m_tracker.GetDirtyRegions();
+  m_tracker.BeginFrame();
 
   bool hasRendered = false;
   // If we visualize the regions we will always render the entire viewport
   if (g_advancedSettings.m_guiVisualizeDirtyRegions || g_advancedSettings.m_guiAlgorithmDirtyRegions == DIRTYREGION_SOLVER_FILL_VIEWPORT_ALWAYS)
   {
+    m_tracker.AddPass(CServiceBroker::GetWinSystem()->GetGfxContext().GetScissors());
     RenderPass();
     hasRendered = true;
   }
@@ -1216,6 +1221,7 @@ bool CGUIWindowManager::Render()
   {
     if (!dirtyRegions.empty())
     {
+      m_tracker.AddPass(CServiceBroker::GetWinSystem()->GetGfxContext().GetScissors());
       RenderPass();
       hasRendered = true;
     }
@@ -1228,6 +1234,7 @@ bool CGUIWindowManager::Render()
         continue;
 
       CServiceBroker::GetWinSystem()->GetGfxContext().SetScissors(*i);
+      m_tracker.AddPass(CServiceBroker::GetWinSystem()->GetGfxContext().GetScissors());
       RenderPass();
       hasRendered = true;
     }
@@ -1244,9 +1251,21 @@ bool CGUIWindowManager::Render()
       CGUITexture::DrawQuad(*i, 0x4c00ff00);
   }
 
+  m_tracker.EndFrame(hasRendered);
+
   return hasRendered;
 }
 
+void CGUIWindowManager::OnControlRendered(bool culled)
+{
+  m_tracker.AddControl(culled);
+}
+
+DirtyRegionStats CGUIWindowManager::GetDirtyRegionStats() const
+{
+  return m_tracker.GetStats();
+}
+
 void CGUIWindowManager::AfterRender()
 {
   m_tracker.CleanMarkedRegions();
@@ -112,6 +112,16 @@ public:
 
   void RenderEx() const;
 
+  /*! \brief Count a control visited by the current rendering pass
+   \param culled true if the control was skipped as it lies outside the pass
+   */
+  void OnControlRendered(bool culled);
+
+  /*! \brief What the last Render() redrew
+   \sa DirtyRegionStats
+   */
+  DirtyRegionStats GetDirtyRegionStats() const;
+
   /*! \brief Do any post render activities.
    */
   void AfterRender();
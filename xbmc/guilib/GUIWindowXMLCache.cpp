@@ -0,0 +1,408 @@
+/*
+ *      Copyright (C) 2018 Team Kodi
+ *      http://kodi.tv
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this Program; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+
+#include "GUIWindowXMLCache.h"
+
+#include <algorithm>
+#include <cstring>
+
+#include "GUIComponent.h"
+#include "GUIInfoManager.h"
+#include "ServiceBroker.h"
+#include "addons/Skin.h"
+#include "filesystem/Directory.h"
+#include "filesystem/File.h"
+#include "threads/SingleLock.h"
+#include "utils/Crc32.h"
+#include "utils/JobManager.h"
+#include "utils/StringUtils.h"
+#include "utils/SystemInfo.h"
+#include "utils/URIUtils.h"
+#include "utils/XBMCTinyXML.h"
+#include "utils/log.h"
+
+#define WINDOW_XML_CACHE_PATH "special://temp/skincache/"
+#define WINDOW_XML_CACHE_MAGIC "KWXC"
+#define WINDOW_XML_CACHE_VERSION 1
+
+namespace
+{
+enum NodeType
+{
+  NODE_ELEMENT = 1,
+  NODE_TEXT,
+  NODE_CDATA
+};
+
+void WriteUInt32(std::string &data, uint32_t value)
+{
+  for (int i = 0; i < 4; i++)
+    data.push_back(static_cast<char>((value >> (8 * i)) & 0xff));
+}
+
+void WriteUInt64(std::string &data, uint64_t value)
+{
+  WriteUInt32(data, static_cast<uint32_t>(value));
+  WriteUInt32(data, static_cast<uint32_t>(value >> 32));
+}
+
+void WriteString(std::string &data, const std::string &value)
+{
+  WriteUInt32(data, static_cast<uint32_t>(value.size()));
+  data.append(value);
+}
+
+void WriteNode(std::string &data, const TiXmlNode *node)
+{
+  if (node->Type() == TiXmlNode::TINYXML_TEXT)
+  {
+    data.push_back(static_cast<const TiXmlText*>(node)->CDATA() ? NODE_CDATA : NODE_TEXT);
+    WriteString(data, node->ValueStr());
+    return;
+  }
+
+  const TiXmlElement *element = static_cast<const TiXmlElement*>(node);
+  data.push_back(NODE_ELEMENT);
+  WriteString(data, element->ValueStr());
+
+  uint32_t attributes = 0;
+  for (const TiXmlAttribute *attribute = element->FirstAttribute(); attribute; attribute = attribute->Next())
+    attributes++;
+  WriteUInt32(data, attributes);
+  for (const TiXmlAttribute *attribute = element->FirstAttribute(); attribute; attribute = attribute->Next())
+  {
+    WriteString(data, attribute->Name());
+    WriteString(data, attribute->ValueStr());
+  }
+
+  // comments and the like are of no interest
+  uint32_t children = 0;
+  for (const TiXmlNode *child = element->FirstChild(); child; child = child->NextSibling())
+  {
+    if (child->Type() == TiXmlNode::TINYXML_ELEMENT || child->Type() == TiXmlNode::TINYXML_TEXT)
+      children++;
+  }
+  WriteUInt32(data, children);
+  for (const TiXmlNode *child = element->FirstChild(); child; child = child->NextSibling())
+  {
+    if (child->Type() == TiXmlNode::TINYXML_ELEMENT || child->Type() == TiXmlNode::TINYXML_TEXT)
+      WriteNode(data, child);
+  }
+}
+
+class CReader
+{
+public:
+  explicit CReader(const std::string &data) : m_data(data) {}
+
+  bool ReadUInt8(uint8_t &value)
+  {
+    if (m_position + 1 > m_data.size())
+      return false;
+    value = static_cast<uint8_t>(m_data[m_position++]);
+    return true;
+  }
+
+  bool ReadUInt32(uint32_t &value)
+  {
+    if (m_position + 4 > m_data.size())
+      return false;
+    value = 0;
+    for (int i = 0; i < 4; i++)
+      value |= static_cast<uint32_t>(static_cast<uint8_t>(m_data[m_position++])) << (8 * i);
+    return true;
+  }
+
+  bool ReadUInt64(uint64_t &value)
+  {
+    uint32_t low, high;
+    if (!ReadUInt32(low) || !ReadUInt32(high))
+      return false;
+    value = (static_cast<uint64_t>(high) << 32) | low;
+    return true;
+  }
+
+  bool ReadString(std::string &value)
+  {
+    uint32_t size;
+    if (!ReadUInt32(size) || m_position + size > m_data.size())
+      return false;
+    value.assign(m_data, m_position, size);
+    m_position += size;
+    return true;
+  }
+
+  TiXmlNode* ReadNode()
+  {
+    uint8_t type;
+    std::string value;
+    if (!ReadUInt8(type) || !ReadString(value))
+      return nullptr;
+
+    if (type == NODE_TEXT || type == NODE_CDATA)
+    {
+      TiXmlText *text = new TiXmlText(value);
+      text->SetCDATA(type == NODE_CDATA);
+      return text;
+    }
+    if (type != NODE_ELEMENT)
+      return nullptr;
+
+    std::unique_ptr<TiXmlElement> element(new TiXmlElement(value));
+    uint32_t attributes;
+    if (!ReadUInt32(attributes))
+      return nullptr;
+    for (uint32_t i = 0; i < attributes; i++)
+    {
+      std::string name, attribute;
+      if (!ReadString(name) || !ReadString(attribute))
+        return nullptr;
+      element->SetAttribute(name, attribute);
+    }
+
+    uint32_t children;
+    if (!ReadUInt32(children))
+      return nullptr;
+    for (uint32_t i = 0; i < children; i++)
+    {
+      TiXmlNode *child = ReadNode();
+      if (!child)
+        return nullptr;
+      element->LinkEndChild(child);
+    }
+    return element.release();
+  }
+
+  bool AtEnd() const { return m_position == m_data.size(); }
+
+private:
+  const std::string &m_data;
+  size_t m_position = 0;
+};
+}
+
+CGUIWindowXMLCache& CGUIWindowXMLCache::GetInstance()
+{
+  static CGUIWindowXMLCache windowXMLCache;
+  return windowXMLCache;
+}
+
+std::unique_ptr<TiXmlElement> CGUIWindowXMLCache::Get(const std::string &file, std::map<INFO::InfoPtr, bool> &includeConditions)
+{
+  CSingleLock lock(m_section);
+  m_requests++;
+
+  std::shared_ptr<Entry> entry;
+  auto it = m_entries.find(file);
+  if (it != m_entries.end())
+    entry = it->second;
+  else
+  {
+    // not seen this session, so try what's on disk
+    XFILE::CFile cacheFile;
+    XFILE::auto_buffer buffer;
+    if (cacheFile.LoadFile(GetCacheFile(file), buffer) <= 0)
+      return nullptr;
+
+    entry = std::make_shared<Entry>();
+    if (!Deserialize(file, std::string(buffer.get(), buffer.size()), *entry) || !IsCurrent(*entry))
+      return nullptr;
+    m_entries[file] = entry;
+  }
+
+  if (!IsValid(*entry, includeConditions))
+    return nullptr;
+
+  m_hits++;
+  return std::unique_ptr<TiXmlElement>(static_cast<TiXmlElement*>(entry->root->Clone()));
+}
+
+void CGUIWindowXMLCache::Add(const std::string &file, const TiXmlElement &prepared, const std::map<INFO::InfoPtr, bool> &includeConditions)
+{
+  auto entry = std::make_shared<Entry>();
+  entry->files.push_back(std::make_pair(file, GetModificationTime(file)));
+  for (const auto &includeFile : g_SkinInfo->GetIncludeFiles())
+    entry->files.push_back(std::make_pair(includeFile, GetModificationTime(includeFile)));
+  for (const auto &condition : includeConditions)
+    entry->conditions.push_back(std::make_pair(condition.first->GetExpression(), condition.second));
+  entry->root.reset(static_cast<TiXmlElement*>(prepared.Clone()));
+
+  auto data = std::make_shared<std::string>();
+  Serialize(file, *entry, *data);
+
+  {
+    CSingleLock lock(m_section);
+    m_entries[file] = entry;
+  }
+
+  // write it out in the background, window loading is what we're trying to speed up
+  std::string cacheFile = GetCacheFile(file);
+  CJobManager::GetInstance().Submit([cacheFile, data]() {
+    XFILE::CDirectory::Create(WINDOW_XML_CACHE_PATH);
+    XFILE::CFile file;
+    if (!file.OpenForWrite(cacheFile, true) ||
+        file.Write(data->c_str(), data->size()) != static_cast<ssize_t>(data->size()))
+    {
+      CLog::Log(LOGWARNING, "CGUIWindowXMLCache: unable to write %s", cacheFile.c_str());
+      file.Close();
+      XFILE::CFile::Delete(cacheFile);
+    }
+  }, CJob::PRIORITY_LOW);
+}
+
+void CGUIWindowXMLCache::Clear()
+{
+  CSingleLock lock(m_section);
+  m_entries.clear();
+}
+
+void CGUIWindowXMLCache::GetStats(uint64_t &hits, uint64_t &requests) const
+{
+  CSingleLock lock(m_section);
+  hits = m_hits;
+  requests = m_requests;
+}
+
+bool CGUIWindowXMLCache::IsValid(const Entry &entry, std::map<INFO::InfoPtr, bool> &includeConditions) const
+{
+  std::map<INFO::InfoPtr, bool> conditions;
+  for (const auto &condition : entry.conditions)
+  {
+    INFO::InfoPtr info = CServiceBroker::GetGUI()->GetInfoManager().Register(condition.first);
+    if (!info || info->Get() != condition.second)
+      return false;
+    conditions.insert(std::make_pair(info, condition.second));
+  }
+
+  // the includes the skin has loaded may have changed as well
+  for (const auto &includeFile : g_SkinInfo->GetIncludeFiles())
+  {
+    auto file = std::find_if(entry.files.begin(), entry.files.end(),
+                             [&includeFile](const std::pair<std::string, int64_t> &file) { return file.first == includeFile; });
+    if (file == entry.files.end())
+      return false;
+  }
+
+  includeConditions.swap(conditions);
+  return true;
+}
+
+bool CGUIWindowXMLCache::IsCurrent(const Entry &entry)
+{
+  for (const auto &file : entry.files)
+  {
+    if (GetModificationTime(file.first) != file.second)
+      return false;
+  }
+  return true;
+}
+
+int64_t CGUIWindowXMLCache::GetModificationTime(const std::string &file)
+{
+  struct __stat64 buffer;
+  if (XFILE::CFile::Stat(file, &buffer) != 0)
+    return -1;
+  return static_cast<int64_t>(buffer.st_mtime);
+}
+
+std::string CGUIWindowXMLCache::GetCacheFile(const std::string &file)
+{
+  return StringUtils::Format(WINDOW_XML_CACHE_PATH "%08x.bin", Crc32::ComputeFromLowerCase(file));
+}
+
+std::string CGUIWindowXMLCache::GetVersionKey()
+{
+  // the resolved includes, constants and expressions depend on the skin as well as on the
+  // code resolving them, so a new build (even of the same version) must not use old entries
+  return g_SkinInfo->ID() + " " + g_SkinInfo->Version().asString() + " " +
+         CSysInfo::GetVersion() + " " + CSysInfo::GetBuildDate();
+}
+
+void CGUIWindowXMLCache::Serialize(const std::string &file, const Entry &entry, std::string &data)
+{
+  data.append(WINDOW_XML_CACHE_MAGIC);
+  WriteUInt32(data, WINDOW_XML_CACHE_VERSION);
+  WriteString(data, GetVersionKey());
+  WriteString(data, file);
+
+  WriteUInt32(data, static_cast<uint32_t>(entry.files.size()));
+  for (const auto &dependency : entry.files)
+  {
+    WriteString(data, dependency.first);
+    WriteUInt64(data, static_cast<uint64_t>(dependency.second));
+  }
+
+  WriteUInt32(data, static_cast<uint32_t>(entry.conditions.size()));
+  for (const auto &condition : entry.conditions)
+  {
+    WriteString(data, condition.first);
+    data.push_back(condition.second ? 1 : 0);
+  }
+
+  WriteNode(data, entry.root.get());
+}
+
+bool CGUIWindowXMLCache::Deserialize(const std::string &file, const std::string &data, Entry &entry)
+{
+  if (data.compare(0, 4, WINDOW_XML_CACHE_MAGIC) != 0)
+    return false;
+
+  CReader reader(data);
+  uint32_t magic, version;
+  std::string skin, windowFile;
+  if (!reader.ReadUInt32(magic) || !reader.ReadUInt32(version) || version != WINDOW_XML_CACHE_VERSION ||
+      !reader.ReadString(skin) || skin != GetVersionKey() ||
+      !reader.ReadString(windowFile) || windowFile != file)
+    return false;
+
+  uint32_t files;
+  if (!reader.ReadUInt32(files))
+    return false;
+  for (uint32_t i = 0; i < files; i++)
+  {
+    std::string path;
+    uint64_t time;
+    if (!reader.ReadString(path) || !reader.ReadUInt64(time))
+      return false;
+    entry.files.push_back(std::make_pair(path, static_cast<int64_t>(time)));
+  }
+
+  uint32_t conditions;
+  if (!reader.ReadUInt32(conditions))
+    return false;
+  for (uint32_t i = 0; i < conditions; i++)
+  {
+    std::string expression;
+    uint8_t value;
+    if (!reader.ReadString(expression) || !reader.ReadUInt8(value))
+      return false;
+    entry.conditions.push_back(std::make_pair(expression, value != 0));
+  }
+
+  TiXmlNode *root = reader.ReadNode();
+  if (!root || root->Type() != TiXmlNode::TINYXML_ELEMENT || !reader.AtEnd())
+  {
+    delete root;
+    return false;
+  }
+  entry.root.reset(static_cast<TiXmlElement*>(root));
+  return true;
+}
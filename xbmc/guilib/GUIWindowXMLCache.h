@@ -0,0 +1,104 @@
+/*
+ *      Copyright (C) 2018 Team Kodi
+ *      http://kodi.tv
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this Program; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+
+#pragma once
+
+/*!
+\file GUIWindowXMLCache.h
+\brief
+*/
+
+#include <map>
+#include <memory>
+#include <stdint.h>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "interfaces/info/InfoBool.h"
+#include "threads/CriticalSection.h"
+
+class TiXmlElement;
+
+/*!
+ \ingroup winmsg
+ \brief Cache of window xml with includes, constants and expressions resolved.
+
+ Windows are mostly loaded every time they are opened, and resolving the includes of a
+ large window takes longer than creating its controls. The prepared xml is kept in memory
+ for the lifetime of the skin, and in a compact binary form in special://temp/skincache
+ across restarts.
+
+ An entry is used only if the skin, the modification times of the window file and of the
+ include files it was resolved with, and the values of the include conditions are unchanged.
+ */
+class CGUIWindowXMLCache
+{
+public:
+  static CGUIWindowXMLCache& GetInstance();
+
+  /*! \brief Look up the prepared xml of a window
+   \param file path of the window xml file
+   \param includeConditions [out] the include conditions the xml was prepared with
+   \return a copy of the prepared xml, or nullptr if there's no valid entry
+   */
+  std::unique_ptr<TiXmlElement> Get(const std::string &file, std::map<INFO::InfoPtr, bool> &includeConditions);
+
+  /*! \brief Store the prepared xml of a window
+   \param file path of the window xml file
+   \param prepared the window xml after include resolution
+   \param includeConditions the include conditions it was prepared with
+   */
+  void Add(const std::string &file, const TiXmlElement &prepared, const std::map<INFO::InfoPtr, bool> &includeConditions);
+
+  /*! \brief Forget all windows held in memory, e.g. when the skin's includes are reloaded.
+   Entries on disk are checked against the files again when next read.
+   */
+  void Clear();
+
+  void GetStats(uint64_t &hits, uint64_t &requests) const;
+
+private:
+  CGUIWindowXMLCache() = default;
+  CGUIWindowXMLCache(const CGUIWindowXMLCache&) = delete;
+  CGUIWindowXMLCache& operator=(const CGUIWindowXMLCache&) = delete;
+
+  struct Entry
+  {
+    std::vector<std::pair<std::string, int64_t> > files; ///< window and include files with their modification times
+    std::vector<std::pair<std::string, bool> > conditions;
+    std::unique_ptr<TiXmlElement> root;
+  };
+
+  bool IsValid(const Entry &entry, std::map<INFO::InfoPtr, bool> &includeConditions) const;
+  static bool IsCurrent(const Entry &entry);
+  static int64_t GetModificationTime(const std::string &file);
+  static std::string GetCacheFile(const std::string &file);
+  static std::string GetVersionKey(); // skin and application build an entry was written by
+
+  static void Serialize(const std::string &file, const Entry &entry, std::string &data);
+  static bool Deserialize(const std::string &file, const std::string &data, Entry &entry);
+
+  mutable CCriticalSection m_section;
+  std::map<std::string, std::shared_ptr<Entry> > m_entries; ///< entries checked against the files this session
+  uint64_t m_hits = 0;
+  uint64_t m_requests = 0;
+};
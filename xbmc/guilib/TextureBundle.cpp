@@ -78,6 +78,22 @@ int CTextureBundle::LoadAnim(const std::string& Filename, CBaseTexture*** ppText
   return 0;
 }
 
+void CTextureBundle::PreloadTextures(const std::vector<std::string> &names)
+{
+  if (m_useXBT)
+  {
+    m_tbXBT.PreloadTextures(names);
+  }
+}
+
+void CTextureBundle::ClearPreloaded()
+{
+  if (m_useXBT)
+  {
+    m_tbXBT.ClearPreloaded();
+  }
+}
+
 void CTextureBundle::SetThemeBundle(bool themeBundle)
 {
   m_tbXBT.SetThemeBundle(themeBundle);
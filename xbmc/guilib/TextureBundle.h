@@ -40,6 +40,9 @@ public:
 
   int LoadAnim(const std::string& Filename, CBaseTexture*** ppTextures, int &width, int &height, int& nLoops, int** ppDelays);
 
+  void PreloadTextures(const std::vector<std::string> &names);
+  void ClearPreloaded();
+
 private:
   CTextureBundleXBT m_tbXBT;
 
@@ -22,6 +22,10 @@
 
 #include "ServiceBroker.h"
 #include "Texture.h"
+#include "threads/Event.h"
+#include "threads/SingleLock.h"
+#include "utils/CPUInfo.h"
+#include "utils/JobManager.h"
 #include "windowing/GraphicContext.h"
 #include "utils/log.h"
 #include "settings/Settings.h"
@@ -98,6 +102,9 @@ bool CTextureBundleXBT::OpenBundle()
 
   m_path = CSpecialProtocol::TranslatePathConvertCase(m_path);
 
+  // frames unpacked from a previous bundle are of no use
+  ClearPreloaded();
+
   // Load the texture file
   if (!XFILE::CXbtManager::GetInstance().GetReader(CURL(m_path), m_XBTFReader))
   {
@@ -213,52 +220,102 @@ int CTextureBundleXBT::LoadAnim(const std::string& Filename, CBaseTexture*** ppT
 
 bool CTextureBundleXBT::ConvertFrameToTexture(const std::string& name, CXBTFFrame& frame, CBaseTexture** ppTexture)
 {
-  // found texture - allocate the necessary buffers
-  unsigned char *buffer = new unsigned char [(size_t)frame.GetPackedSize()];
-  if (buffer == NULL)
+  std::shared_ptr<uint8_t> buffer;
+  auto it = m_preloaded.find(frame.GetOffset());
+  if (it != m_preloaded.end())
   {
-    CLog::Log(LOGERROR, "Out of memory loading texture: %s (need %" PRIu64" bytes)", name.c_str(), frame.GetPackedSize());
-    return false;
+    buffer = std::move(it->second);
+    m_preloaded.erase(it);
   }
 
-  // load the compressed texture
-  if (!m_XBTFReader->Load(frame, buffer))
+  if (!buffer)
+    buffer.reset(UnpackFrame(*m_XBTFReader, frame), std::default_delete<uint8_t[]>());
+  if (!buffer)
   {
     CLog::Log(LOGERROR, "Error loading texture: %s", name.c_str());
-    delete[] buffer;
     return false;
   }
 
-  // check if it's packed with lzo
-  if (frame.IsPacked())
-  { // unpack
-    unsigned char *unpacked = new unsigned char[(size_t)frame.GetUnpackedSize()];
-    if (unpacked == NULL)
+  // create an xbmc texture
+  *ppTexture = new CTexture();
+  (*ppTexture)->LoadFromMemory(frame.GetWidth(), frame.GetHeight(), 0, frame.GetFormat(), frame.HasAlpha(), buffer.get());
+
+  return true;
+}
+
+void CTextureBundleXBT::PreloadTextures(const std::vector<std::string> &names)
+{
+  if (m_XBTFReader == nullptr || !m_XBTFReader->IsOpen())
+    return;
+
+  struct PreloadState
+  {
+    explicit PreloadState(const CXBTFReaderPtr &reader) : reader(reader) {}
+
+    CXBTFReaderPtr reader;
+    std::vector<CXBTFFrame> frames;
+    std::vector<std::shared_ptr<uint8_t> > unpacked;
+    CCriticalSection section;
+    size_t next = 0;
+    size_t done = 0;
+    CEvent finished;
+  };
+  auto state = std::make_shared<PreloadState>(m_XBTFReader);
+
+  for (const auto &name : names)
+  {
+    CXBTFFile file;
+    if (!m_XBTFReader->Get(name, file))
+      continue;
+    for (const auto &frame : file.GetFrames())
     {
-      CLog::Log(LOGERROR, "Out of memory unpacking texture: %s (need %" PRIu64" bytes)", name.c_str(), frame.GetUnpackedSize());
-      delete[] buffer;
-      return false;
+      if (m_preloaded.find(frame.GetOffset()) == m_preloaded.end())
+        state->frames.push_back(frame);
     }
-    lzo_uint s = (lzo_uint)frame.GetUnpackedSize();
-    if (lzo1x_decompress_safe(buffer, (lzo_uint)frame.GetPackedSize(), unpacked, &s, NULL) != LZO_E_OK ||
-        s != frame.GetUnpackedSize())
+  }
+  if (state->frames.empty())
+    return;
+  state->unpacked.resize(state->frames.size());
+
+  // workers take the next frame until there are none left. Helpers that start late find nothing
+  // to do, and as they share ownership of the state we needn't wait for them.
+  auto unpack = [state]()
+  {
+    while (true)
     {
-      CLog::Log(LOGERROR, "Error loading texture: %s: Decompression error", name.c_str());
-      delete[] buffer;
-      delete[] unpacked;
-      return false;
+      size_t frame;
+      {
+        CSingleLock lock(state->section);
+        if (state->next == state->frames.size())
+          return;
+        frame = state->next++;
+      }
+      uint8_t *buffer = UnpackFrame(*state->reader, state->frames[frame]);
+      CSingleLock lock(state->section);
+      state->unpacked[frame].reset(buffer, std::default_delete<uint8_t[]>());
+      if (++state->done == state->frames.size())
+        state->finished.Set();
     }
-    delete[] buffer;
-    buffer = unpacked;
-  }
+  };
 
-  // create an xbmc texture
-  *ppTexture = new CTexture();
-  (*ppTexture)->LoadFromMemory(frame.GetWidth(), frame.GetHeight(), 0, frame.GetFormat(), frame.HasAlpha(), buffer);
+  unsigned int helpers = std::min(static_cast<size_t>(std::max(g_cpuInfo.getCPUCount() - 1, 0)), state->frames.size() - 1);
+  for (unsigned int i = 0; i < helpers; i++)
+    CJobManager::GetInstance().Submit(unpack, CJob::PRIORITY_HIGH);
+  unpack();
+  state->finished.Wait();
 
-  delete[] buffer;
+  for (size_t i = 0; i < state->frames.size(); i++)
+  {
+    if (state->unpacked[i])
+      m_preloaded[state->frames[i].GetOffset()] = std::move(state->unpacked[i]);
+  }
+  CLog::Log(LOGDEBUG, "%s - unpacked %u frames using %u threads", __FUNCTION__,
+            static_cast<unsigned int>(state->frames.size()), helpers + 1);
+}
 
-  return true;
+void CTextureBundleXBT::ClearPreloaded()
+{
+  m_preloaded.clear();
 }
 
 void CTextureBundleXBT::SetThemeBundle(bool themeBundle)
@@ -48,6 +48,18 @@ public:
   int LoadAnim(const std::string& Filename, CBaseTexture*** ppTextures,
                 int &width, int &height, int& nLoops, int** ppDelays);
 
+  /*! \brief Unpack the frames of the given textures across all cores
+   The unpacked frames are picked up by LoadTexture and LoadAnim instead of unpacking them again.
+   Like those, must be called with the graphics context locked.
+   \param names normalized names of the textures to unpack
+   \sa ClearPreloaded
+   */
+  void PreloadTextures(const std::vector<std::string> &names);
+
+  /*! \brief Drop any preloaded frames that weren't loaded
+   */
+  void ClearPreloaded();
+
   static uint8_t* UnpackFrame(const CXBTFReader& reader, const CXBTFFrame& frame);
 
 private:
@@ -59,6 +71,8 @@ private:
   bool m_themeBundle;
   std::string m_path;
   std::shared_ptr<CXBTFReader> m_XBTFReader;
+
+  std::map<uint64_t, std::shared_ptr<uint8_t> > m_preloaded; ///< unpacked frames by offset in the bundle
 };
 
 
@@ -19,6 +19,7 @@
  */
 
 #include "TextureDX.h"
+#include "utils/FrameProfiler.h"
 #include "utils/log.h"
 
 /************************************************************************/
@@ -80,6 +81,8 @@ void CDXTexture::LoadToGPU()
     return;
   }
 
+  CFrameProfilerScope profile("texture", "CDXTexture::LoadToGPU");
+
   bool needUpdate = true;
   D3D11_USAGE usage = D3D11_USAGE_DEFAULT;
   if (m_format == XB_FMT_RGB8)
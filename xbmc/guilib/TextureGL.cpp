@@ -23,6 +23,7 @@
 #include "rendering/RenderSystem.h"
 #include "utils/log.h"
 #include "utils/GLUtils.h"
+#include "utils/FrameProfiler.h"
 #include "guilib/TextureManager.h"
 #include "settings/AdvancedSettings.h"
 #ifdef TARGET_POSIX
@@ -65,6 +66,8 @@ void CGLTexture::LoadToGPU()
     // nothing to load - probably same image (no change)
     return;
   }
+
+  CFrameProfilerScope profile("texture", "CGLTexture::LoadToGPU");
   if (m_texture == 0)
   {
     // Have OpenGL generate a texture object handle for us
@@ -20,6 +20,7 @@
 
 #include "TextureManager.h"
 
+#include <algorithm>
 #include <cassert>
 
 #include "addons/Skin.h"
@@ -290,6 +291,51 @@ bool CGUITextureManager::HasTexture(const std::string &textureName, std::string
   return !fullPath.empty();
 }
 
+void CGUITextureManager::PreloadTextures(const std::vector<std::string> &textures)
+{
+  std::vector<std::string> bundled[2];
+  {
+    CSingleLock lock(m_section);
+    for (const auto &texture : textures)
+    {
+      if (texture.empty() || !CanLoad(texture))
+        continue;
+
+      // skip those that are loaded or waiting to be freed
+      auto loaded = std::find_if(m_vecTextures.begin(), m_vecTextures.end(),
+                                 [&texture](const CTextureMap *map) { return map->GetName() == texture; });
+      if (loaded != m_vecTextures.end())
+        continue;
+      auto unused = std::find_if(m_unusedTextures.begin(), m_unusedTextures.end(),
+                                 [&texture](const std::pair<CTextureMap*, unsigned int> &map) { return map.first->GetName() == texture; });
+      if (unused != m_unusedTextures.end())
+        continue;
+
+      std::string bundledName = CTextureBundle::Normalize(texture);
+      for (int i = 0; i < 2; i++)
+      {
+        if (m_TexBundle[i].HasFile(bundledName))
+        {
+          bundled[i].push_back(bundledName);
+          break;
+        }
+      }
+    }
+  }
+
+  for (int i = 0; i < 2; i++)
+  {
+    if (!bundled[i].empty())
+      m_TexBundle[i].PreloadTextures(bundled[i]);
+  }
+}
+
+void CGUITextureManager::ClearPreloadedTextures()
+{
+  for (int i = 0; i < 2; i++)
+    m_TexBundle[i].ClearPreloaded();
+}
+
 const CTextureArray& CGUITextureManager::Load(const std::string& strTextureName, bool checkBundleOnly /*= false */)
 {
   std::string strPath;
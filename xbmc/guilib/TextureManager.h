@@ -117,6 +117,14 @@ public:
   std::string GetTexturePath(const std::string& textureName, bool directory = false);
   void GetBundledTexturesFromPath(const std::string& texturePath, std::vector<std::string> &items);
 
+  /*! \brief Unpack the bundled textures that aren't loaded yet in one parallel batch
+   Use before loading a number of textures at once, and follow with ClearPreloadedTextures
+   once they are loaded.
+   \param textures names of the textures, as they will be passed to Load
+   */
+  void PreloadTextures(const std::vector<std::string> &textures);
+  void ClearPreloadedTextures();
+
   void AddTexturePath(const std::string &texturePath);    ///< Add a new path to the paths to check when loading media
   void SetTexturePath(const std::string &texturePath);    ///< Set a single path as the path to check when loading media (clear then add)
   void RemoveTexturePath(const std::string &texturePath); ///< Remove a path from the paths to check when loading media
@@ -25,6 +25,7 @@
 
 #include "XBTFReader.h"
 #include "guilib/XBTF.h"
+#include "threads/SingleLock.h"
 #include "utils/EndianSwap.h"
 
 #ifdef TARGET_WINDOWS
@@ -186,6 +187,7 @@ bool CXBTFReader::IsOpen() const
 
 void CXBTFReader::Close()
 {
+  CSingleLock lock(m_fileSection);
   if (m_file != nullptr)
   {
     fclose(m_file);
@@ -210,6 +212,7 @@ time_t CXBTFReader::GetLastModificationTimestamp() const
 
 bool CXBTFReader::Load(const CXBTFFrame& frame, unsigned char* buffer) const
 {
+  CSingleLock lock(m_fileSection);
   if (m_file == nullptr)
     return false;
 
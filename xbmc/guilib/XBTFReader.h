@@ -27,6 +27,7 @@
 #include <stdint.h>
 
 #include "XBTF.h"
+#include "threads/CriticalSection.h"
 
 class CXBTFReader : public CXBTFBase
 {
@@ -40,11 +41,14 @@ public:
 
   time_t GetLastModificationTimestamp() const;
 
+  /*! \brief Read the packed data of a frame. Safe to call from several threads at once.
+   */
   bool Load(const CXBTFFrame& frame, unsigned char* buffer) const;
 
 private:
   std::string m_path;
   FILE* m_file = nullptr;
+  mutable CCriticalSection m_fileSection; ///< protects the position of m_file
 };
 
 typedef std::shared_ptr<CXBTFReader> CXBTFReaderPtr;
@@ -39,6 +39,9 @@ public:
   CGUIInfoProvider() = default;
   virtual ~CGUIInfoProvider() = default;
 
+  void GetVersionedLabels(std::vector<int>& labels) const override {}
+  unsigned int GetVersion(const CGUIInfo &info) const override { return 0; }
+
   void UpdateAVInfo(const AudioStreamInfo& audioInfo, const VideoStreamInfo& videoInfo) override
   { m_audioInfo = audioInfo, m_videoInfo = videoInfo; }
 
@@ -20,8 +20,10 @@
 
 #include "guilib/guiinfo/GUIInfoProviders.h"
 #include "guilib/guiinfo/IGUIInfoProvider.h"
+#include "threads/SingleLock.h"
 
 #include <algorithm>
+#include <tuple>
 
 using namespace KODI::GUILIB::GUIINFO;
 
@@ -66,6 +68,8 @@ void CGUIInfoProviders::RegisterProvider(IGUIInfoProvider *provider, bool bAppen
       m_providers.emplace_back(provider);
     else
       m_providers.insert(m_providers.begin(), provider);
+
+    UpdateVersionedLabels();
   }
 }
 
@@ -73,7 +77,10 @@ void CGUIInfoProviders::UnregisterProvider(IGUIInfoProvider *provider)
 {
   auto it = std::find(m_providers.begin(), m_providers.end(), provider);
   if (it != m_providers.end())
+  {
     m_providers.erase(it);
+    UpdateVersionedLabels();
+  }
 }
 
 bool CGUIInfoProviders::InitCurrentItem(CFileItem *item)
@@ -89,10 +96,39 @@ bool CGUIInfoProviders::InitCurrentItem(CFileItem *item)
 
 bool CGUIInfoProviders::GetLabel(std::string& value, const CFileItem *item, int contextWindow, const CGUIInfo &info, std::string *fallback) const
 {
+  // a fallback may be modified by the provider, so only plain requests are cached
+  const IGUIInfoProvider *versionedBy = nullptr;
+  if (!fallback && info.m_info >= 0 && info.m_info < static_cast<int>(m_versionedLabels.size()))
+    versionedBy = m_versionedLabels[info.m_info];
+
+  unsigned int version = 0;
+  if (versionedBy)
+  {
+    // fetch the version before the value, so a concurrent change can only make the cached value look outdated
+    version = versionedBy->GetVersion(info);
+
+    CSingleLock lock(m_cacheSection);
+    ++m_labelRequests;
+    const auto it = m_labelCache.find(info);
+    if (it != m_labelCache.end() && it->second.version == version)
+    {
+      ++m_labelHits;
+      value = it->second.label;
+      return true;
+    }
+  }
+
   for (const auto& provider : m_providers)
   {
     if (provider->GetLabel(value, item, contextWindow, info, fallback))
+    {
+      if (provider == versionedBy)
+      {
+        CSingleLock lock(m_cacheSection);
+        m_labelCache[info] = CachedLabel{version, value};
+      }
       return true;
+    }
   }
   return false;
 }
@@ -124,3 +160,48 @@ void CGUIInfoProviders::UpdateAVInfo(const AudioStreamInfo& audioInfo, const Vid
     provider->UpdateAVInfo(audioInfo, videoInfo);
   }
 }
+
+void CGUIInfoProviders::GetCacheStats(uint64_t& labelHits, uint64_t& labelRequests) const
+{
+  CSingleLock lock(m_cacheSection);
+  labelHits = m_labelHits;
+  labelRequests = m_labelRequests;
+}
+
+void CGUIInfoProviders::UpdateVersionedLabels()
+{
+  // a label goes to the first provider asking for it, as that is the one answering it
+  m_versionedLabels.clear();
+  std::vector<int> labels;
+  for (const auto& provider : m_providers)
+  {
+    labels.clear();
+    provider->GetVersionedLabels(labels);
+    for (int label : labels)
+    {
+      if (label < 0)
+        continue;
+      if (label >= static_cast<int>(m_versionedLabels.size()))
+        m_versionedLabels.resize(label + 1, nullptr);
+      if (!m_versionedLabels[label])
+        m_versionedLabels[label] = provider;
+    }
+  }
+
+  CSingleLock lock(m_cacheSection);
+  m_labelCache.clear();
+}
+
+bool CGUIInfoProviders::InfoLess::operator()(const CGUIInfo &left, const CGUIInfo &right) const
+{
+  const uint32_t leftFlag = left.GetInfoFlag();
+  const uint32_t rightFlag = right.GetInfoFlag();
+  const uint32_t leftData1 = left.GetData1();
+  const uint32_t rightData1 = right.GetData1();
+  const int leftData2 = left.GetData2();
+  const int rightData2 = right.GetData2();
+  const int leftData4 = left.GetData4();
+  const int rightData4 = right.GetData4();
+  return std::tie(left.m_info, leftData1, leftFlag, leftData2, leftData4, left.GetData3()) <
+         std::tie(right.m_info, rightData1, rightFlag, rightData2, rightData4, right.GetData3());
+}
@@ -20,11 +20,13 @@
 
 #pragma once
 
+#include <map>
 #include <string>
 #include <vector>
 
 #include "guilib/guiinfo/AddonsGUIInfo.h"
 #include "guilib/guiinfo/GamesGUIInfo.h"
+#include "guilib/guiinfo/GUIInfo.h"
 #include "guilib/guiinfo/GUIControlsGUIInfo.h"
 #include "guilib/guiinfo/LibraryGUIInfo.h"
 #include "guilib/guiinfo/MusicGUIInfo.h"
@@ -35,6 +37,7 @@
 #include "guilib/guiinfo/VideoGUIInfo.h"
 #include "guilib/guiinfo/VisualisationGUIInfo.h"
 #include "guilib/guiinfo/WeatherGUIInfo.h"
+#include "threads/CriticalSection.h"
 
 class CFileItem;
 class CGUIListItem;
@@ -49,7 +52,6 @@ namespace GUILIB
 namespace GUIINFO
 {
 
-class CGUIInfo;
 class IGUIInfoProvider;
 
 class CGUIInfoProviders
@@ -116,6 +118,14 @@ public:
    */
   void UpdateAVInfo(const AudioStreamInfo& audioInfo, const VideoStreamInfo& videoInfo);
 
+  /*!
+   * @brief Get the counters of the versioned label cache. Labels a provider publishes a version for
+   * (see IGUIInfoProvider::GetVersionedLabels) are served from the cache as long as that version does not change.
+   * @param labelHits Will be filled with the number of versioned label requests served from the cache.
+   * @param labelRequests Will be filled with the total number of versioned label requests.
+   */
+  void GetCacheStats(uint64_t& labelHits, uint64_t& labelRequests) const;
+
   /*!
    * @brief Get the player guiinfo provider.
    * @return The player guiinfo provider.
@@ -147,7 +157,26 @@ public:
   CLibraryGUIInfo& GetLibraryInfoProvider() { return m_libraryGUIInfo; }
 
 private:
+  struct CachedLabel
+  {
+    unsigned int version;
+    std::string label;
+  };
+
+  struct InfoLess
+  {
+    bool operator()(const CGUIInfo &left, const CGUIInfo &right) const;
+  };
+
+  void UpdateVersionedLabels();
+
   std::vector<IGUIInfoProvider *> m_providers;
+  std::vector<const IGUIInfoProvider *> m_versionedLabels; // provider of each versioned label, indexed by label id
+
+  mutable CCriticalSection m_cacheSection;
+  mutable std::map<CGUIInfo, CachedLabel, InfoLess> m_labelCache;
+  mutable uint64_t m_labelHits = 0;
+  mutable uint64_t m_labelRequests = 0;
 
   CAddonsGUIInfo m_addonsGUIInfo;
   CGamesGUIInfo m_gamesGUIInfo;
@@ -21,6 +21,7 @@
 #pragma once
 
 #include <string>
+#include <vector>
 
 class CFileItem;
 class CGUIListItem;
@@ -80,6 +81,22 @@ public:
    */
   virtual bool GetBool(bool& value, const CGUIListItem *item, int contextWindow, const CGUIInfo &info) const = 0;
 
+  /*!
+   * @brief Get the ids of the labels whose value is versioned, see GetVersion. Asked once, when the provider gets
+   * registered. Only labels that are expensive to compute and depend neither on the item nor on the context window
+   * should be versioned.
+   * @param labels Will be filled with the label ids.
+   */
+  virtual void GetVersionedLabels(std::vector<int>& labels) const = 0;
+
+  /*!
+   * @brief Get the version of the data a versioned label is computed from. The label is cached by the caller and only
+   * recomputed once the version changes.
+   * @param info The GUI info (label id + additional data), the label id being one of GetVersionedLabels.
+   * @return The current version.
+   */
+  virtual unsigned int GetVersion(const CGUIInfo &info) const = 0;
+
   /*!
    * @brief Set new audio/video stream info data.
    * @param audioInfo New audio stream info.
@@ -23,6 +23,7 @@
 #include <map>
 
 #include "FileItem.h"
+#include "LangInfo.h"
 #include "ServiceBroker.h"
 #include "URL.h"
 #include "guilib/GUIComponent.h"
@@ -117,6 +118,7 @@ void CPicturesGUIInfo::SetCurrentSlide(CFileItem *item)
   {
     m_currentSlide.reset();
   }
+  ++m_currentSlideVersion;
 }
 
 const CFileItem* CPicturesGUIInfo::GetCurrentSlide() const
@@ -267,3 +269,20 @@ bool CPicturesGUIInfo::GetBool(bool& value, const CGUIListItem *gitem, int conte
 
   return false;
 }
+
+void CPicturesGUIInfo::GetVersionedLabels(std::vector<int>& labels) const
+{
+  // SLIDESHOW_* labels only depend on the current slide and the locale formatting its date and size,
+  // except for the index which tracks the slideshow window
+  for (int label = SLIDESHOW_LABELS_START; label <= SLIDESHOW_LABELS_END; label++)
+  {
+    if (label != SLIDESHOW_INDEX)
+      labels.emplace_back(label);
+  }
+}
+
+unsigned int CPicturesGUIInfo::GetVersion(const CGUIInfo &info) const
+{
+  // both versions only ever grow, so does their sum
+  return m_currentSlideVersion + g_langInfo.GetVersion();
+}
@@ -22,6 +22,7 @@
 
 #include "guilib/guiinfo/GUIInfoProvider.h"
 
+#include <atomic>
 #include <memory>
 
 namespace KODI
@@ -44,12 +45,15 @@ public:
   bool GetLabel(std::string& value, const CFileItem *item, int contextWindow, const CGUIInfo &info, std::string *fallback) const override;
   bool GetInt(int& value, const CGUIListItem *item, int contextWindow, const CGUIInfo &info) const override;
   bool GetBool(bool& value, const CGUIListItem *item, int contextWindow, const CGUIInfo &info) const override;
+  void GetVersionedLabels(std::vector<int>& labels) const override;
+  unsigned int GetVersion(const CGUIInfo &info) const override;
 
   void SetCurrentSlide(CFileItem *item);
   const CFileItem* GetCurrentSlide() const;
 
 private:
   std::unique_ptr<CFileItem> m_currentSlide;
+  std::atomic<unsigned int> m_currentSlideVersion{0};
 };
 
 } // namespace GUIINFO
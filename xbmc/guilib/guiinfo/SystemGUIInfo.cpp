@@ -642,3 +642,9 @@ bool CSystemGUIInfo::GetBool(bool& value, const CGUIListItem *gitem, int context
 
   return false;
 }
+
+void CSystemGUIInfo::GetVersionedLabels(std::vector<int>& labels) const
+{
+  // assembled from the build info on every request, but constant for the lifetime of the application
+  labels.insert(labels.end(), { SYSTEM_BUILD_VERSION_SHORT, SYSTEM_BUILD_VERSION, SYSTEM_BUILD_DATE });
+}
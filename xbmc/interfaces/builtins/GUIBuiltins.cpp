@@ -36,6 +36,7 @@
 #include "input/ButtonTranslator.h"
 #include "settings/AdvancedSettings.h"
 #include "settings/DisplaySettings.h"
+#include "utils/FrameProfiler.h"
 #include "utils/log.h"
 #include "utils/StringUtils.h"
 #include "Util.h"
@@ -406,6 +407,33 @@ static int SetStereoMode(const std::vector<std::string>& params)
   return 0;
 }
 
+/*! \brief Control the frame profiler.
+ *  \param params The parameters.
+ *  \details params[0] = "start", "stop" or "save".
+ *           params[1] = File to save the trace to (optional, save only).
+ */
+static int FrameProfiler(const std::vector<std::string>& params)
+{
+  CFrameProfiler &profiler = CFrameProfiler::GetInstance();
+  if (StringUtils::EqualsNoCase(params[0], "start"))
+    profiler.Start();
+  else if (StringUtils::EqualsNoCase(params[0], "stop"))
+    profiler.Stop();
+  else if (StringUtils::EqualsNoCase(params[0], "save"))
+  {
+    std::string path = params.size() > 1 && !params[1].empty() ? params[1] : "special://home/frameprofile.json";
+    if (!profiler.SaveTrace(path))
+      return -1;
+  }
+  else
+  {
+    CLog::Log(LOGERROR,"Builtin 'FrameProfiler' called with unknown parameter: %s", params[0].c_str());
+    return -2;
+  }
+
+  return 0;
+}
+
 /*! \brief Toggle visualization of dirty regions.
  *  \param params Ignored.
  */
@@ -502,6 +530,15 @@ static int ToggleDirty(const std::vector<std::string>&)
 ///     @param[in] force                 Send "true" to force close (skip animations) (optional).
 ///   }
 ///   \table_row2_l{
+///     <b>`FrameProfiler(command[\,file])`</b>
+///     ,
+///     Controls the frame profiler\, which records GUI\, texture\, font and job
+///     timings of every thread. The trace can be viewed in chrome://tracing.
+///     @param[in] command               "start"\, "stop" or "save".
+///     @param[in] file                  File to save the trace to (optional\, default
+///                                      special://home/frameprofile.json).
+///   }
+///   \table_row2_l{
 ///     <b>`Notification(header\,message[\,time\,image])`</b>
 ///     ,
 ///     Will display a notification dialog with the specified header and message\,
@@ -597,6 +634,7 @@ CBuiltins::CommandMap CGUIBuiltins::GetOperations() const
            {"activatewindowandfocus",         {"Activate the specified window and sets focus to the specified id", 1, ActivateAndFocus<false>}},
            {"clearproperty",                  {"Clears a window property for the current focused window/dialog (key,value)", 1, ClearProperty}},
            {"dialog.close",                   {"Close a dialog", 1, CloseDialog}},
+           {"frameprofiler",                  {"Controls the frame profiler (start, stop, save[,file])", 1, FrameProfiler}},
            {"notification",                   {"Shows a notification on screen, specify header, then message, and optionally time in milliseconds and a icon.", 2, Notification}},
            {"refreshrss",                     {"Reload RSS feeds from RSSFeeds.xml", 0, RefreshRSS}},
            {"replacewindow",                  {"Replaces the current window with the new one", 1, ActivateWindow<true>}},
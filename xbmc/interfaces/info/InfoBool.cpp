@@ -27,6 +27,7 @@ namespace INFO
     : m_value(false),
       m_context(context),
       m_listItemDependent(false),
+      m_constant(false),
       m_expression(expression),
       m_refreshCounter(0),
       m_parentRefreshCounter(refreshCounter)
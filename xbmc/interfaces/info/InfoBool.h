@@ -78,11 +78,13 @@ public:
 
   const std::string &GetExpression() const { return m_expression; }
   bool ListItemDependent() const { return m_listItemDependent; }
+  bool IsConstant() const { return m_constant; }
 protected:
 
   bool m_value;                ///< current value
   int m_context;               ///< contextual information to go with the condition
   bool m_listItemDependent;    ///< do not cache if a listitem pointer is given
+  bool m_constant;             ///< value never changes, expressions may fold it at compile time
   std::string  m_expression;   ///< original expression
 
 private:
@@ -24,6 +24,8 @@
 #include "GUIInfoManager.h"
 #include "guilib/GUIComponent.h"
 #include "ServiceBroker.h"
+#include <algorithm>
+#include <iterator>
 #include <list>
 #include <memory>
 
@@ -31,7 +33,9 @@ using namespace INFO;
 
 void InfoSingle::Initialize()
 {
-  m_condition = CServiceBroker::GetGUI()->GetInfoManager().TranslateSingleString(m_expression, m_listItemDependent);
+  CGUIInfoManager& infoMgr = CServiceBroker::GetGUI()->GetInfoManager();
+  m_condition = infoMgr.TranslateSingleString(m_expression, m_listItemDependent);
+  m_constant = infoMgr.IsConstantCondition(m_condition);
 }
 
 void InfoSingle::Update(const CGUIListItem *item)
@@ -50,7 +54,41 @@ void InfoExpression::Initialize()
 
 void InfoExpression::Update(const CGUIListItem *item)
 {
-  m_value = m_expression_tree->Evaluate(item);
+  if (!m_compiled)
+    Compile();
+
+  bool result = false;
+  const uint32_t size = static_cast<uint32_t>(m_program.size());
+  for (uint32_t pc = 0; pc < size; )
+  {
+    const Instruction &instruction = m_program[pc];
+    switch (instruction.op)
+    {
+    case OP_LEAF:
+      result = instruction.value ^ m_leaves[instruction.arg]->Get(item);
+      pc++;
+      break;
+    case OP_CONST:
+      result = instruction.value;
+      pc++;
+      break;
+    default:
+      if (result == (instruction.op == OP_JUMP_IF_TRUE))
+      {
+        /* Move this child to the head of its group so we evaluate faster next time.
+         * The group is done at this point and its end doesn't move. */
+        const uint32_t end = instruction.arg;
+        if (instruction.child > 0)
+          Promote(pc);
+        pc = end;
+      }
+      else
+        pc++;
+      break;
+    }
+  }
+
+  m_value = result;
 }
 
 /* Expressions are rewritten at parse time into a form which favours the
@@ -71,11 +109,6 @@ void InfoExpression::Update(const CGUIListItem *item)
  *    operations. So [A|B]|[C|D+[[E|F]|G] becomes A|B|C|[D+[E|F|G]].
  */
 
-bool InfoExpression::InfoLeaf::Evaluate(const CGUIListItem *item)
-{
-  return m_invert ^ m_info->Get(item);
-}
-
 InfoExpression::InfoAssociativeGroup::InfoAssociativeGroup(
     node_type_t type,
     const InfoSubexpressionPtr &left,
@@ -96,27 +129,159 @@ void InfoExpression::InfoAssociativeGroup::Merge(std::shared_ptr<InfoAssociative
   m_children.splice(m_children.end(), other->m_children);
 }
 
-bool InfoExpression::InfoAssociativeGroup::Evaluate(const CGUIListItem *item)
+void InfoExpression::InfoAssociativeGroup::Promote(unsigned int child)
 {
-  /* Handle either AND or OR by using the relation
-   * A AND B == !(!A OR !B)
-   * to convert ANDs into ORs
-   */
-  std::list<InfoSubexpressionPtr>::iterator last = m_children.end();
   std::list<InfoSubexpressionPtr>::iterator it = m_children.begin();
-  bool use_and = (m_type == NODE_AND);
-  bool result = use_and ^ (*it)->Evaluate(item);
-  while (!result && ++it != last)
+  std::advance(it, child);
+  m_children.push_front(*it);
+  m_children.erase(it);
+}
+
+/* For evaluation the tree is compiled into a flat program working on a single
+ * boolean accumulator. Each child of a group is followed by a conditional jump
+ * to the end of the group, so OR groups stop at the first true child and AND
+ * groups at the first false one, just like walking the tree. Leaves whose value
+ * is fixed for the lifetime of the application (see CGUIInfoManager::IsConstantCondition)
+ * are folded away: they either decide their group at compile time or drop out of it.
+ * When a child other than the first decides its group, it is moved to the head
+ * of the group as before, and its instructions are moved to the head of the
+ * group's instructions in the program.
+ */
+
+InfoExpression::fold_t InfoExpression::Fold(const InfoSubexpressionPtr &node)
+{
+  if (node->Type() == NODE_LEAF)
+  {
+    const InfoLeaf *leaf = static_cast<const InfoLeaf*>(node.get());
+    if (!leaf->Info()->IsConstant())
+      return FOLD_NONE;
+    return (leaf->Inverted() ^ leaf->Info()->Get()) ? FOLD_TRUE : FOLD_FALSE;
+  }
+
+  // a group is decided by any child having its short-circuit value, and constant if all children are
+  const InfoAssociativeGroup *group = static_cast<const InfoAssociativeGroup*>(node.get());
+  const fold_t decisive = group->Type() == NODE_OR ? FOLD_TRUE : FOLD_FALSE;
+  bool constant = true;
+  for (const auto &child : group->Children())
+  {
+    fold_t value = Fold(child);
+    if (value == decisive)
+      return decisive;
+    if (value == FOLD_NONE)
+      constant = false;
+  }
+
+  if (!constant)
+    return FOLD_NONE;
+  return decisive == FOLD_TRUE ? FOLD_FALSE : FOLD_TRUE;
+}
+
+void InfoExpression::Emit(const InfoSubexpressionPtr &node)
+{
+  if (node->Type() == NODE_LEAF)
+  {
+    const InfoLeaf *leaf = static_cast<const InfoLeaf*>(node.get());
+    InfoBool *info = leaf->Info().get();
+
+    uint32_t index = 0;
+    while (index < m_leaves.size() && m_leaves[index] != info)
+      index++;
+    if (index == m_leaves.size())
+      m_leaves.push_back(info);
+
+    m_program.push_back({ OP_LEAF, leaf->Inverted(), 0, index, nullptr, 0 });
+    return;
+  }
+
+  InfoAssociativeGroup *group = static_cast<InfoAssociativeGroup*>(node.get());
+  const opcode_t jump = group->Type() == NODE_OR ? OP_JUMP_IF_TRUE : OP_JUMP_IF_FALSE;
+  const size_t first = m_program.size();
+
+  uint16_t position = 0;
+  for (const auto &child : group->Children())
   {
-    result = use_and ^ (*it)->Evaluate(item);
-    if (result)
+    // constant children left here can't decide the group, so they are skipped
+    if (Fold(child) == FOLD_NONE)
     {
-      /* Move this child to the head of the list so we evaluate faster next time */
-      m_children.push_front(*it);
-      m_children.erase(it);
+      const uint32_t begin = static_cast<uint32_t>(m_program.size());
+      Emit(child);
+      m_program.push_back({ jump, false, position, 0, group, begin });
     }
+    position++;
   }
-  return use_and ^ result;
+
+  const uint32_t end = static_cast<uint32_t>(m_program.size());
+  for (size_t i = first; i < m_program.size(); i++)
+  {
+    if (m_program[i].group == group)
+      m_program[i].arg = end;
+  }
+}
+
+void InfoExpression::Promote(uint32_t jump)
+{
+  InfoAssociativeGroup *group = m_program[jump].group;
+  const uint16_t child = m_program[jump].child;
+  group->Promote(child);
+
+  // the children were pushed back by one, the promoted one is the first now
+  uint32_t first = jump;
+  for (uint32_t i = 0; i < m_program.size(); i++)
+  {
+    Instruction &instruction = m_program[i];
+    if (instruction.group != group)
+      continue;
+    first = std::min(first, instruction.begin);
+    if (instruction.child == child)
+      instruction.child = 0;
+    else if (instruction.child < child)
+      instruction.child++;
+  }
+
+  // move the instructions of the child in front of those of the children before it,
+  // the jumps within the moved instructions move along with them
+  const uint32_t begin = m_program[jump].begin;
+  const uint32_t end = jump + 1;
+  if (begin == first)
+    return;
+
+  const uint32_t moved = end - begin;
+  const uint32_t before = begin - first;
+  for (uint32_t i = first; i < end; i++)
+  {
+    Instruction &instruction = m_program[i];
+    if (instruction.op != OP_JUMP_IF_TRUE && instruction.op != OP_JUMP_IF_FALSE)
+      continue;
+
+    const bool promoted = i >= begin;
+    if (instruction.group == group)
+      instruction.begin = promoted ? first : instruction.begin + moved;
+    else if (promoted)
+    {
+      instruction.begin -= before;
+      instruction.arg -= before;
+    }
+    else
+    {
+      instruction.begin += moved;
+      instruction.arg += moved;
+    }
+  }
+  std::rotate(m_program.begin() + first, m_program.begin() + begin, m_program.begin() + end);
+}
+
+void InfoExpression::Compile()
+{
+  m_program.clear();
+  m_leaves.clear();
+
+  fold_t value = Fold(m_expression_tree);
+  if (value != FOLD_NONE)
+    m_program.push_back({ OP_CONST, value == FOLD_TRUE, 0, 0, nullptr, 0 });
+  else
+    Emit(m_expression_tree);
+
+  m_compiled = true;
 }
 
 /* Expressions are parsed using the shunting-yard algorithm. Binary operators
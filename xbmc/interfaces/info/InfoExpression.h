@@ -20,6 +20,7 @@
 
 #pragma once
 
+#include <stdint.h>
 #include <vector>
 #include <list>
 #include <stack>
@@ -73,12 +74,26 @@ private:
     NODE_OR,
   } node_type_t;
 
+  typedef enum
+  {
+    FOLD_NONE = -1, // value depends on the leaves at runtime
+    FOLD_FALSE,
+    FOLD_TRUE,
+  } fold_t;
+
+  typedef enum : uint8_t
+  {
+    OP_LEAF,          // acc = info ^ invert
+    OP_CONST,         // acc = value
+    OP_JUMP_IF_TRUE,  // short-circuit an OR group
+    OP_JUMP_IF_FALSE, // short-circuit an AND group
+  } opcode_t;
+
   // An abstract base class for nodes in the expression tree
   class InfoSubexpression
   {
   public:
     virtual ~InfoSubexpression(void) = default; // so we can destruct derived classes using a pointer to their base class
-    virtual bool Evaluate(const CGUIListItem *item) = 0;
     virtual node_type_t Type() const=0;
   };
 
@@ -89,8 +104,9 @@ private:
   {
   public:
     InfoLeaf(InfoPtr info, bool invert) : m_info(info), m_invert(invert) {};
-    bool Evaluate(const CGUIListItem *item) override;
     node_type_t Type() const override { return NODE_LEAF; };
+    const InfoPtr &Info() const { return m_info; }
+    bool Inverted() const { return m_invert; }
   private:
     InfoPtr m_info;
     bool m_invert;
@@ -103,17 +119,37 @@ private:
     InfoAssociativeGroup(node_type_t type, const InfoSubexpressionPtr &left, const InfoSubexpressionPtr &right);
     void AddChild(const InfoSubexpressionPtr &child);
     void Merge(std::shared_ptr<InfoAssociativeGroup> other);
-    bool Evaluate(const CGUIListItem *item) override;
+    void Promote(unsigned int child);
+    const std::list<InfoSubexpressionPtr> &Children() const { return m_children; }
     node_type_t Type() const override { return m_type; };
   private:
     node_type_t m_type;
     std::list<InfoSubexpressionPtr> m_children;
   };
 
+  // A single step of the compiled expression
+  struct Instruction
+  {
+    opcode_t op;
+    bool value;                   ///< OP_LEAF: invert the leaf, OP_CONST: the constant
+    uint16_t child;               ///< jumps: position of the child just evaluated within its group
+    uint32_t arg;                 ///< OP_LEAF: index into m_leaves, jumps: target
+    InfoAssociativeGroup *group;  ///< jumps: the group being short-circuited
+    uint32_t begin;               ///< jumps: first instruction of the child just evaluated
+  };
+
   static operator_t GetOperator(char ch);
   static void OperatorPop(std::stack<operator_t> &operator_stack, bool &invert, std::stack<InfoSubexpressionPtr> &nodes);
   bool Parse(const std::string &expression);
+  static fold_t Fold(const InfoSubexpressionPtr &node);
+  void Compile();
+  void Emit(const InfoSubexpressionPtr &node);
+  void Promote(uint32_t jump);
   InfoSubexpressionPtr m_expression_tree;
+
+  std::vector<Instruction> m_program;   ///< m_expression_tree flattened with short-circuit jumps
+  std::vector<InfoBool*> m_leaves;      ///< distinct leaves of m_program, owned by the tree
+  bool m_compiled = false;              ///< false until m_program was built
 };
 
 };
@@ -31,6 +31,7 @@
 #include "dialogs/GUIDialogKaiToast.h"
 #include "addons/AddonManager.h"
 #include "settings/Settings.h"
+#include "utils/FrameProfiler.h"
 #include "utils/Variant.h"
 #include "guilib/StereoscopicsManager.h"
 #include "rendering/RenderSystem.h"
@@ -134,6 +135,23 @@ JSONRPC_STATUS CGUIOperations::GetStereoscopicModes(const std::string &method, I
   return OK;
 }
 
+JSONRPC_STATUS CGUIOperations::SetFrameProfiler(const std::string &method, ITransportLayer *transport, IClient *client, const CVariant &parameterObject, CVariant &result)
+{
+  if (parameterObject["enabled"].asBoolean())
+    CFrameProfiler::GetInstance().Start(static_cast<unsigned int>(parameterObject["spans"].asUnsignedInteger()));
+  else
+    CFrameProfiler::GetInstance().Stop();
+
+  result = CFrameProfiler::IsRunning();
+  return OK;
+}
+
+JSONRPC_STATUS CGUIOperations::GetFrameProfile(const std::string &method, ITransportLayer *transport, IClient *client, const CVariant &parameterObject, CVariant &result)
+{
+  CFrameProfiler::GetInstance().GetTrace(result);
+  return OK;
+}
+
 JSONRPC_STATUS CGUIOperations::GetPropertyValue(const std::string &property, CVariant &result)
 {
   if (property == "currentwindow")
@@ -162,6 +180,18 @@ JSONRPC_STATUS CGUIOperations::GetPropertyValue(const std::string &property, CVa
 
     result = GetStereoModeObjectFromGuiMode(stereoscopicsManager.GetStereoMode());
   }
+  else if (property == "renderstats")
+  {
+    DirtyRegionStats stats = CServiceBroker::GetGUI()->GetWindowManager().GetDirtyRegionStats();
+
+    result = CVariant(CVariant::VariantTypeObject);
+    result["regions"] = stats.regions;
+    result["pixels"] = stats.pixels;
+    result["controls"] = stats.controls;
+    result["culledcontrols"] = stats.culledControls;
+    result["frames"] = stats.frames;
+    result["idleframes"] = stats.idleFrames;
+  }
   else
     return InvalidParams;
 
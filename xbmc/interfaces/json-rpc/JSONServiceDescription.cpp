@@ -172,6 +172,8 @@ JsonRpcMethodMap CJSONServiceDescription::m_methodMaps[] = {
   { "GUI.SetFullscreen",                            CGUIOperations::SetFullscreen },
   { "GUI.SetStereoscopicMode",                      CGUIOperations::SetStereoscopicMode },
   { "GUI.GetStereoscopicModes",                     CGUIOperations::GetStereoscopicModes },
+  { "GUI.SetFrameProfiler",                         CGUIOperations::SetFrameProfiler },
+  { "GUI.GetFrameProfile",                          CGUIOperations::GetFrameProfile },
 
 // PVR operations
   { "PVR.GetProperties",                            CPVROperations::GetProperties },
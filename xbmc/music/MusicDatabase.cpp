@@ -43,6 +43,7 @@
 #include "guilib/GUIWindowManager.h"
 #include "guilib/LocalizeStrings.h"
 #include "interfaces/AnnouncementManager.h"
+#include "LangInfo.h"
 #include "messaging/helpers/DialogHelper.h"
 #include "messaging/helpers/DialogOKHelper.h"
 #include "music/tags/MusicInfoTag.h"
@@ -4467,6 +4468,107 @@ bool CMusicDatabase::GetAlbumsByWhere(const std::string &baseDir, const Filter &
   return false;
 }
 
+bool CMusicDatabase::GetSongsOrderFields(const SortDescription &sortDescription, std::vector<std::string> &orderFields, const std::string &table /* = "" */)
+{
+  orderFields.clear();
+
+  // Sorting by the sort names of artists is left to SortUtils
+  if (sortDescription.sortAttributes & SortAttributeUseArtistSortName)
+    return false;
+
+  // Text is compared ignoring case like SortUtils does, and with leading articles
+  // stripped when asked to. Numbers within text are still compared as text.
+  auto text = [&](const std::string &field)
+  {
+    std::string column = table + field;
+    if (sortDescription.sortAttributes & SortAttributeIgnoreArticle)
+    {
+      std::string expression = "CASE";
+      for (const auto &token : g_langInfo.GetSortTokens())
+      {
+        std::string pattern = token;
+        StringUtils::Replace(pattern, "!", "!!");
+        StringUtils::Replace(pattern, "%", "!%");
+        StringUtils::Replace(pattern, "_", "!_");
+        expression += PrepareSQL(" WHEN %s LIKE '%s%%' ESCAPE '!' THEN SUBSTR(%s, %i)",
+                                 column.c_str(), pattern.c_str(), column.c_str(), static_cast<int>(token.size()) + 1);
+      }
+      column = expression == "CASE" ? column : expression + " ELSE " + column + " END";
+    }
+    if (m_sqlite)
+      column += " COLLATE NOCASE";
+    return column;
+  };
+
+  switch (sortDescription.sortBy)
+  {
+  case SortByTrackNumber:
+    orderFields.emplace_back(table + "iTrack");
+    break;
+  case SortByTitle:
+    orderFields.emplace_back(text("strTitle"));
+    break;
+  case SortByAlbum:
+    orderFields.emplace_back(text("strAlbum"));
+    orderFields.emplace_back(text("strArtists"));
+    orderFields.emplace_back(table + "iTrack");
+    break;
+  case SortByArtist:
+    orderFields.emplace_back(text("strArtists"));
+    orderFields.emplace_back(text("strAlbum"));
+    orderFields.emplace_back(table + "iTrack");
+    break;
+  case SortByArtistThenYear:
+    orderFields.emplace_back(text("strArtists"));
+    orderFields.emplace_back(table + "iYear");
+    orderFields.emplace_back(text("strAlbum"));
+    orderFields.emplace_back(table + "iTrack");
+    break;
+  case SortByGenre:
+    orderFields.emplace_back(text("strGenres"));
+    orderFields.emplace_back(text("strTitle"));
+    break;
+  case SortByYear:
+    orderFields.emplace_back(table + "iYear");
+    orderFields.emplace_back(text("strAlbum"));
+    orderFields.emplace_back(table + "iTrack");
+    break;
+  case SortByDateAdded:
+    orderFields.emplace_back(table + "dateAdded");
+    break;
+  case SortByPlaycount:
+    orderFields.emplace_back(table + "iTimesPlayed");
+    orderFields.emplace_back(text("strTitle"));
+    break;
+  case SortByLastPlayed:
+    orderFields.emplace_back(table + "lastplayed");
+    orderFields.emplace_back(text("strTitle"));
+    break;
+  case SortByRating:
+    orderFields.emplace_back(table + "rating");
+    orderFields.emplace_back(text("strTitle"));
+    break;
+  case SortByUserRating:
+    orderFields.emplace_back(table + "userrating");
+    orderFields.emplace_back(text("strTitle"));
+    break;
+  case SortByTime:
+    orderFields.emplace_back(table + "iDuration");
+    break;
+  default:
+    return false;
+  }
+
+  if (sortDescription.sortOrder == SortOrderDescending)
+  {
+    for (auto &field : orderFields)
+      field += " DESC";
+  }
+  // Always sort by id to define the order when the other fields are the same
+  orderFields.emplace_back(table + "idSong");
+  return true;
+}
+
 bool CMusicDatabase::GetSongsFullByWhere(const std::string &baseDir, const Filter &filter, CFileItemList &items, const SortDescription &sortDescription /* = SortDescription() */, bool artistData /* = false*/)
 {
   if (m_pDB.get() == NULL || m_pDS.get() == NULL)
@@ -4498,15 +4600,20 @@ bool CMusicDatabase::GetSongsFullByWhere(const std::string &baseDir, const Filte
     // Count number of songs that satisfy selection criteria
     total = (int)strtol(GetSingleValue("SELECT COUNT(1) FROM songview " + strSQLExtra, m_pDS).c_str(), NULL, 10);
 
-    // Apply any limiting directly in SQL if there is either no special sorting or random sort
-    // When limited, random sort is also applied in SQL
-    bool limitedInSQL = extFilter.limit.empty() &&
-      (sortDescription.sortBy == SortByNone || sortDescription.sortBy == SortByRandom) &&
-      (sortDescription.limitStart > 0 || sortDescription.limitEnd > 0);
+    // Apply any limiting directly in SQL if there is either no special sorting, random sort
+    // or a sort that SQL can do. When limited, the sort is also applied in SQL so that
+    // a page of a large listing can be fetched without reading all the songs before it
+    std::vector<std::string> orderFields;
+    bool limited = extFilter.limit.empty() && (sortDescription.limitStart > 0 || sortDescription.limitEnd > 0);
+    bool sortedInSQL = limited && GetSongsOrderFields(sortDescription, orderFields);
+    bool limitedInSQL = limited &&
+      (sortDescription.sortBy == SortByNone || sortDescription.sortBy == SortByRandom || sortedInSQL);
     if (limitedInSQL)
     {
       if (sortDescription.sortBy == SortByRandom)
         strSQLExtra += PrepareSQL(" ORDER BY RANDOM()");
+      else if (sortedInSQL)
+        strSQLExtra += " ORDER BY " + StringUtils::Join(orderFields, ", ");
       strSQLExtra += DatabaseUtils::BuildLimitClause(sortDescription.limitEnd, sortDescription.limitStart);
     }
 
@@ -4523,18 +4630,35 @@ bool CMusicDatabase::GetSongsFullByWhere(const std::string &baseDir, const Filte
       else
         strSQL = "SELECT songview.*, songartistview.* "
           "FROM songview JOIN songartistview ON songartistview.idsong = songview.idsong " + strSQLExtra;
-      strSQL += " ORDER BY songartistview.idsong, songartistview.idRole, songartistview.iOrder";
+      if (sortedInSQL)
+      { // Keep the sorted order, the trailing song id keeps the records of a song together
+        GetSongsOrderFields(sortDescription, orderFields, "sv.");
+        strSQL += " ORDER BY " + StringUtils::Join(orderFields, ", ") + ", songartistview.idRole, songartistview.iOrder";
+      }
+      else
+        strSQL += " ORDER BY songartistview.idsong, songartistview.idRole, songartistview.iOrder";
     }
     else
       strSQL = "SELECT songview.* FROM songview " + strSQLExtra;
 
     CLog::Log(LOGDEBUG, "%s query = %s", __FUNCTION__, strSQL.c_str());
+
+    // Avoid sorting with limits when have join with songartistview
+    // Limit when SortByNone already applied in SQL,
+    // apply sort later to fileitems list rather than dataset
+    sorting = sortDescription;
+    if ((artistData || sortedInSQL) && sortDescription.sortBy != SortByNone)
+      sorting.sortBy = SortByNone;
+
+    // Without sorting the rows are used in the order they are returned,
+    // so stream them rather than holding the whole result in memory
+    bool streaming = sorting.sortBy == SortByNone;
+
     // run query
-    if (!m_pDS->query(strSQL))
+    if (!(streaming ? m_pDS->query_stream(strSQL) : m_pDS->query(strSQL)))
       return false;
 
-    int iRowsFound = m_pDS->num_rows();
-    if (iRowsFound == 0)
+    if (m_pDS->eof())
     {
       m_pDS->close();
       return true;
@@ -4544,15 +4668,12 @@ bool CMusicDatabase::GetSongsFullByWhere(const std::string &baseDir, const Filte
     items.SetProperty("total", total);
 
     DatabaseResults results;
-    results.reserve(iRowsFound);
-    // Avoid sorting with limits when have join with songartistview
-    // Limit when SortByNone already applied in SQL,
-    // apply sort later to fileitems list rather than dataset
-    sorting = sortDescription;
-    if (artistData && sortDescription.sortBy != SortByNone)
-      sorting.sortBy = SortByNone;
-    if (!SortUtils::SortFromDataset(sorting, MediaTypeSong, m_pDS, results))
-      return false;
+    if (!streaming)
+    {
+      results.reserve(m_pDS->num_rows());
+      if (!SortUtils::SortFromDataset(sorting, MediaTypeSong, m_pDS, results))
+        return false;
+    }
 
     // Get songs from returned rows. If join songartistview then there is a row for every artist
     items.Reserve(total);
@@ -4561,10 +4682,14 @@ bool CMusicDatabase::GetSongsFullByWhere(const std::string &baseDir, const Filte
     VECARTISTCREDITS artistCredits;
     const dbiplus::query_data &data = m_pDS->get_result_set().records;
     int count = 0;
-    for (const auto &i : results)
+    auto i = results.begin();
+    while (streaming ? !m_pDS->eof() : i != results.end())
     {
-      unsigned int targetRow = (unsigned int)i.at(FieldRow).asInteger();
-      const dbiplus::sql_record* const record = data.at(targetRow);
+      const dbiplus::sql_record* record;
+      if (streaming)
+        record = m_pDS->get_sql_record();
+      else
+        record = data.at(static_cast<unsigned int>((i++)->at(FieldRow).asInteger()));
 
       try
       {
@@ -4599,6 +4724,8 @@ bool CMusicDatabase::GetSongsFullByWhere(const std::string &baseDir, const Filte
         CLog::Log(LOGERROR, "%s: out of memory loading query: %s", __FUNCTION__, filter.where.c_str());
         return (items.Size() > 0);
       }
+      if (streaming)
+        m_pDS->next();
     }
     if (!artistCredits.empty())
     {
@@ -4610,8 +4737,9 @@ bool CMusicDatabase::GetSongsFullByWhere(const std::string &baseDir, const Filte
     m_pDS->close();
 
     // Finally do any sorting in items list we have not been able to do before in SQL or dataset,
-    // that is when have join with songartistview and sorting other than random with limit
-    if (artistData && sortDescription.sortBy != SortByNone && !(limitedInSQL && sortDescription.sortBy == SortByRandom))
+    // that is when have join with songartistview and sorting other than random or SQL sort with limit
+    if (artistData && sortDescription.sortBy != SortByNone &&
+        !(limitedInSQL && (sortDescription.sortBy == SortByRandom || sortedInSQL)))
       items.Sort(sortDescription);
 
     CLog::Log(LOGDEBUG, "%s(%s) - took %d ms", __FUNCTION__, filter.where.c_str(), XbmcThreads::SystemClockMillis() - time);
@@ -4667,6 +4795,35 @@ bool CMusicDatabase::GetSongsByWhere(const std::string &baseDir, const Filter &f
     strSQL = PrepareSQL(strSQL, !filter.fields.empty() && filter.fields.compare("*") != 0 ? filter.fields.c_str() : "songview.*") + strSQLExtra;
 
     CLog::Log(LOGDEBUG, "%s query = %s", __FUNCTION__, strSQL.c_str());
+
+    // without sorting the rows are used in the order they are returned,
+    // so stream them rather than holding the whole result in memory
+    if (sortDescription.sortBy == SortByNone)
+    {
+      if (!m_pDS->query_stream(strSQL))
+        return false;
+
+      int count = 0;
+      for (; !m_pDS->eof(); m_pDS->next())
+      {
+        CFileItemPtr item(new CFileItem);
+        GetFileItemFromDataset(m_pDS->get_sql_record(), item.get(), musicUrl);
+        // HACK for sorting by database returned order
+        item->m_iprogramCount = ++count;
+        items.Add(item);
+      }
+      m_pDS->close();
+
+      // store the total value of items as a property
+      if (count > 0)
+      {
+        if (total < count)
+          total = count;
+        items.SetProperty("total", total);
+      }
+      return true;
+    }
+
     // run query
     if (!m_pDS->query(strSQL))
       return false;
@@ -42,7 +42,7 @@ class CFileItem;
 namespace dbiplus
 {
   class field_value;
-  typedef std::vector<field_value> sql_record;
+  class sql_record;
 }
 
 #include <set>
@@ -459,6 +459,13 @@ public:
   bool GetSongsByYear(const std::string& baseDir, CFileItemList& items, int year);
   bool GetSongsByWhere(const std::string &baseDir, const Filter &filter, CFileItemList& items, const SortDescription &sortDescription = SortDescription());
   bool GetSongsFullByWhere(const std::string &baseDir, const Filter &filter, CFileItemList& items, const SortDescription &sortDescription = SortDescription(), bool artistData = false);
+  /*! \brief Get the songview columns to sort songs by in SQL
+   \param sortDescription the sort method, order and attributes to apply
+   \param orderFields [out] the ORDER BY terms, ending with the song id so the order is total
+   \param table the prefix to qualify the columns with, e.g. "sv."
+   \return false if the sort method can't be applied in SQL
+   */
+  bool GetSongsOrderFields(const SortDescription &sortDescription, std::vector<std::string> &orderFields, const std::string &table = "");
   bool GetAlbumsByWhere(const std::string &baseDir, const Filter &filter, CFileItemList &items, const SortDescription &sortDescription = SortDescription(), bool countOnly = false);
   bool GetArtistsByWhere(const std::string& strBaseDir, const Filter &filter, CFileItemList& items, const SortDescription &sortDescription = SortDescription(), bool countOnly = false);
   bool GetRandomSong(CFileItem* item, int& idSong, const Filter &filter);
@@ -49,6 +49,7 @@
 #include "Application.h"
 #include "messaging/helpers/DialogOKHelper.h"
 #include "messaging/ApplicationMessenger.h"
+#include "settings/AdvancedSettings.h"
 #include "settings/Settings.h"
 #include "guilib/LocalizeStrings.h"
 #include "utils/LegacyPathTranslation.h"
@@ -496,6 +497,30 @@ bool CGUIWindowMusicNav::GetDirectory(const std::string &strDirectory, CFileItem
   return bResult;
 }
 
+std::string CGUIWindowMusicNav::GetPagedPath(const std::string &strDirectory)
+{
+  // song listings can be long enough to be worth fetching a page at a time
+  if (g_advancedSettings.m_iMusicLibraryPageSize <= 0 ||
+      !StringUtils::StartsWithNoCase(strDirectory, "musicdb://") ||
+      CMusicDatabaseDirectory::GetDirectoryChildType(strDirectory) != NODE_TYPE_SONG)
+    return "";
+
+  // the database sorts the pages, so it needs the sort order of the view
+  CFileItemList items(strDirectory);
+  std::unique_ptr<CGUIViewState> viewState(CGUIViewState::GetViewState(GetID(), items));
+  if (!viewState)
+    return "";
+
+  SortDescription sorting = viewState->GetSortMethod();
+  CURL url(strDirectory);
+  url.SetOption("pagesize", StringUtils::Format("%i", g_advancedSettings.m_iMusicLibraryPageSize));
+  url.SetOption("sortby", SortUtils::SortMethodToString(sorting.sortBy));
+  url.SetOption("sortorder", SortUtils::SortOrderToString(viewState->GetSortOrder()));
+  if (sorting.sortAttributes & SortAttributeIgnoreArticle)
+    url.SetOption("ignorearticle", "true");
+  return url.Get();
+}
+
 void CGUIWindowMusicNav::UpdateButtons()
 {
   CGUIWindowMusicBase::UpdateButtons();
@@ -517,6 +542,9 @@ void CGUIWindowMusicNav::UpdateButtons()
       StringUtils::StartsWith(m_vecItems->Get(m_vecItems->Size()-1)->GetPath(), "/-1/"))
       iItems--;
   }
+  // a paged listing counts the songs still to be fetched too
+  if (!m_pagedPath.empty())
+    iItems = static_cast<int>(m_vecItems->GetProperty("total").asInteger());
   std::string items = StringUtils::Format("%i %s", iItems, g_localizeStrings.Get(127).c_str());
   SET_CONTROL_LABEL(CONTROL_LABELFILES, items);
 
@@ -41,6 +41,7 @@ protected:
   // override base class methods
   bool Update(const std::string &strDirectory, bool updateFilterPath = true) override;
   bool GetDirectory(const std::string &strDirectory, CFileItemList &items) override;
+  std::string GetPagedPath(const std::string &strDirectory) override;
   void UpdateButtons() override;
   void PlayItem(int iItem) override;
   void OnWindowLoaded() override;
@@ -25,6 +25,7 @@
 #include <vector>
 
 #include "SmartPlayList.h"
+#include "SmartPlaylistCache.h"
 #include "Util.h"
 #include "dbwrappers/Database.h"
 #include "filesystem/File.h"
@@ -1074,6 +1075,37 @@ void CSmartPlaylistRuleCombination::GetVirtualFolders(const std::string& strType
   }
 }
 
+bool CSmartPlaylistRuleCombination::IsTimeRelative(const std::string& strType, std::set<std::string> &referencedPlaylists) const
+{
+  for (CDatabaseQueryRuleCombinations::const_iterator it = m_combinations.begin(); it != m_combinations.end(); ++it)
+  {
+    std::shared_ptr<CSmartPlaylistRuleCombination> combo = std::static_pointer_cast<CSmartPlaylistRuleCombination>(*it);
+    if (combo && combo->IsTimeRelative(strType, referencedPlaylists))
+      return true;
+  }
+
+  for (CDatabaseQueryRules::const_iterator it = m_rules.begin(); it != m_rules.end(); ++it)
+  {
+    if ((*it)->m_operator == CDatabaseQueryRule::OPERATOR_IN_THE_LAST ||
+        (*it)->m_operator == CDatabaseQueryRule::OPERATOR_NOT_IN_THE_LAST)
+      return true;
+
+    if ((*it)->m_field != FieldPlaylist)
+      continue;
+
+    std::string playlistFile = CSmartPlaylistDirectory::GetPlaylistByName((*it)->m_parameter.at(0), strType);
+    if (playlistFile.empty() || referencedPlaylists.find(playlistFile) != referencedPlaylists.end())
+      continue;
+
+    referencedPlaylists.insert(playlistFile);
+    CSmartPlaylist playlist;
+    if (playlist.Load(playlistFile) && playlist.IsTimeRelative(referencedPlaylists))
+      return true;
+  }
+
+  return false;
+}
+
 void CSmartPlaylistRuleCombination::AddRule(const CSmartPlaylistRule &rule)
 {
   std::shared_ptr<CSmartPlaylistRule> ptr(new CSmartPlaylistRule(rule));
@@ -1349,7 +1381,12 @@ bool CSmartPlaylist::Save(const std::string &path) const
     nodeOrder.InsertEndChild(order);
     pRoot->InsertEndChild(nodeOrder);
   }
-  return doc.SaveFile(path);
+  if (!doc.SaveFile(path))
+    return false;
+
+  // other playlists may include this one
+  CSmartPlaylistCache::GetInstance().Clear();
+  return true;
 }
 
 bool CSmartPlaylist::Save(CVariant &obj, bool full /* = true */) const
@@ -1452,6 +1489,11 @@ void CSmartPlaylist::GetVirtualFolders(std::vector<std::string> &virtualFolders)
   m_ruleCombination.GetVirtualFolders(GetType(), virtualFolders);
 }
 
+bool CSmartPlaylist::IsTimeRelative(std::set<std::string> &referencedPlaylists) const
+{
+  return m_ruleCombination.IsTimeRelative(GetType(), referencedPlaylists);
+}
+
 std::string CSmartPlaylist::GetSaveLocation() const
 {
   if (m_playlistType == "mixed")
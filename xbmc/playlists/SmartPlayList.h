@@ -92,6 +92,8 @@ public:
                              std::set<std::string> &referencedPlaylists) const;
   void GetVirtualFolders(const std::string& strType,
                          std::vector<std::string> &virtualFolders) const;
+  bool IsTimeRelative(const std::string& strType,
+                      std::set<std::string> &referencedPlaylists) const;
 
   void AddRule(const CSmartPlaylistRule &rule);
 };
@@ -153,6 +155,13 @@ public:
   std::string GetWhereClause(const CDatabase &db, std::set<std::string> &referencedPlaylists) const;
   void GetVirtualFolders(std::vector<std::string> &virtualFolders) const;
 
+  /*! \brief whether the items matching the playlist change as time goes by, i.e. when it or a playlist it
+   includes has a rule relative to the current date ("in the last")
+
+   \param referencedPlaylists a set of playlists to know when we reach a cycle
+   */
+  bool IsTimeRelative(std::set<std::string> &referencedPlaylists) const;
+
   std::string GetSaveLocation() const;
 
   static void GetAvailableFields(const std::string &type, std::vector<std::string> &fieldList);
@@ -0,0 +1,118 @@
+/*
+ *      Copyright (C) 2018 Team Kodi
+ *      http://kodi.tv
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this Program; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "SmartPlaylistCache.h"
+
+#include "FileItem.h"
+#include "threads/SingleLock.h"
+#include "threads/SystemClock.h"
+
+// enough for the widgets of a home screen and the playlists browsed lately
+#define SMARTPLAYLIST_CACHE_ENTRIES 32
+// larger listings aren't worth holding on to a second copy of
+#define SMARTPLAYLIST_CACHE_MAX_ITEMS 2000
+// how long the items of a playlist with rules relative to the current date are kept (in ms)
+#define SMARTPLAYLIST_CACHE_TIME_RELATIVE 60000
+
+CSmartPlaylistCache& CSmartPlaylistCache::GetInstance()
+{
+  static CSmartPlaylistCache cache;
+  return cache;
+}
+
+bool CSmartPlaylistCache::Get(const std::string &key, uint64_t version, CFileItemList &items)
+{
+  std::shared_ptr<const CFileItemList> cached;
+  {
+    CSingleLock lock(m_section);
+    m_requests++;
+
+    std::map<std::string, Entry>::iterator it = m_entries.find(key);
+    if (it == m_entries.end())
+      return false;
+
+    unsigned int now = XbmcThreads::SystemClockMillis();
+    if (it->second.version != version ||
+       (it->second.timeRelative && now - it->second.added > SMARTPLAYLIST_CACHE_TIME_RELATIVE))
+    {
+      m_entries.erase(it);
+      return false;
+    }
+
+    m_hits++;
+    it->second.lastUsed = now;
+    cached = it->second.items;
+  }
+
+  // the caller may change the items, so they are copied (outside the lock)
+  items.Copy(*cached);
+  return true;
+}
+
+void CSmartPlaylistCache::Add(const std::string &key, uint64_t version, const CFileItemList &items, bool timeRelative)
+{
+  if (items.Size() > SMARTPLAYLIST_CACHE_MAX_ITEMS)
+    return;
+
+  std::shared_ptr<CFileItemList> copy(new CFileItemList);
+  copy->Copy(items);
+
+  CSingleLock lock(m_section);
+  if (m_entries.find(key) == m_entries.end() && m_entries.size() >= SMARTPLAYLIST_CACHE_ENTRIES)
+  {
+    // make room by dropping the entry used longest ago
+    unsigned int now = XbmcThreads::SystemClockMillis();
+    std::map<std::string, Entry>::iterator oldest = m_entries.begin();
+    for (std::map<std::string, Entry>::iterator it = m_entries.begin(); it != m_entries.end(); ++it)
+    {
+      if (now - it->second.lastUsed > now - oldest->second.lastUsed)
+        oldest = it;
+    }
+    m_entries.erase(oldest);
+  }
+
+  Entry &entry = m_entries[key];
+  entry.version = version;
+  entry.timeRelative = timeRelative;
+  entry.added = entry.lastUsed = XbmcThreads::SystemClockMillis();
+  entry.items = copy;
+}
+
+void CSmartPlaylistCache::AddQuery(unsigned int time)
+{
+  CSingleLock lock(m_section);
+  m_queries++;
+  m_queryTime += time;
+}
+
+void CSmartPlaylistCache::Clear()
+{
+  CSingleLock lock(m_section);
+  m_entries.clear();
+}
+
+void CSmartPlaylistCache::GetStats(uint64_t &hits, uint64_t &requests, uint64_t &queries, uint64_t &queryTime) const
+{
+  CSingleLock lock(m_section);
+  hits = m_hits;
+  requests = m_requests;
+  queries = m_queries;
+  queryTime = m_queryTime;
+}
@@ -0,0 +1,93 @@
+/*
+ *      Copyright (C) 2018 Team Kodi
+ *      http://kodi.tv
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this Program; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#pragma once
+
+#include <map>
+#include <memory>
+#include <stdint.h>
+#include <string>
+
+#include "threads/CriticalSection.h"
+
+class CFileItemList;
+
+/*!
+ \brief Cache of the items of smart playlists.
+
+ The rules of a smart playlist are turned into a query that is run every time the playlist
+ is listed, e.g. by a widget on the home screen. The items are kept in memory along with the
+ version of the library tables they were read from, and are used again until one of those
+ tables is written to.
+
+ Entries of playlists with rules relative to the current date expire after a minute, and all
+ entries are dropped when a playlist is saved, as playlists may include each other.
+ */
+class CSmartPlaylistCache
+{
+public:
+  static CSmartPlaylistCache& GetInstance();
+
+  /*! \brief Look up the items of a smart playlist
+   \param key describes the playlist and how it is listed
+   \param version version of the library tables the playlist is read from
+   \param items [out] list to copy the cached items into
+   \return true if the items were cached for this version, false otherwise
+   */
+  bool Get(const std::string &key, uint64_t version, CFileItemList &items);
+
+  /*! \brief Store the items of a smart playlist
+   \param key describes the playlist and how it is listed
+   \param version version of the library tables the items were read from, taken before reading them
+   \param items the items of the playlist
+   \param timeRelative whether the playlist has rules relative to the current date
+   */
+  void Add(const std::string &key, uint64_t version, const CFileItemList &items, bool timeRelative);
+
+  /*! \brief Count a query run to list a smart playlist
+   \param time time the query took in ms
+   */
+  void AddQuery(unsigned int time);
+
+  void Clear();
+
+  void GetStats(uint64_t &hits, uint64_t &requests, uint64_t &queries, uint64_t &queryTime) const;
+
+private:
+  CSmartPlaylistCache() = default;
+  CSmartPlaylistCache(const CSmartPlaylistCache&) = delete;
+  CSmartPlaylistCache& operator=(const CSmartPlaylistCache&) = delete;
+
+  struct Entry
+  {
+    uint64_t version;
+    bool timeRelative;
+    unsigned int added; ///< system time in ms
+    unsigned int lastUsed; ///< system time in ms
+    std::shared_ptr<const CFileItemList> items;
+  };
+
+  mutable CCriticalSection m_section;
+  std::map<std::string, Entry> m_entries;
+  uint64_t m_hits = 0;
+  uint64_t m_requests = 0;
+  uint64_t m_queries = 0;
+  uint64_t m_queryTime = 0; ///< total time of the queries in ms
+};
@@ -76,6 +76,7 @@ CPVREpg &CPVREpg::operator =(const CPVREpg &right)
 
   for (std::map<CDateTime, CPVREpgInfoTagPtr>::const_iterator it = right.m_tags.begin(); it != right.m_tags.end(); ++it)
     m_tags.insert(make_pair(it->first, it->second));
+  m_bIndexDirty = true;
 
   return *this;
 }
@@ -123,6 +124,7 @@ void CPVREpg::Clear(void)
 {
   CSingleLock lock(m_critSection);
   m_tags.clear();
+  m_bIndexDirty = true;
 }
 
 void CPVREpg::Cleanup(void)
@@ -145,6 +147,7 @@ void CPVREpg::Cleanup(const CDateTime &Time)
       it->second->ClearTimer();
       it->second->ClearRecording();
       it = m_tags.erase(it);
+      m_bIndexDirty = true;
     }
     else
     {
@@ -242,11 +245,15 @@ CPVREpgInfoTagPtr CPVREpg::GetTagByBroadcastId(unsigned int iUniqueBroadcastId)
 
 CPVREpgInfoTagPtr CPVREpg::GetTagBetween(const CDateTime &beginTime, const CDateTime &endTime) const
 {
+  const time_t begin = CPVREpgIndex::ToTime(beginTime);
+  const time_t end = CPVREpgIndex::ToTime(endTime);
+
   CSingleLock lock(m_critSection);
-  for (std::map<CDateTime, CPVREpgInfoTagPtr>::const_iterator it = m_tags.begin(); it != m_tags.end(); ++it)
+  const CPVREpgIndex &index = GetIndex();
+  for (size_t iRow = index.LowerBound(begin); iRow < index.Size() && index.Start(iRow) <= end; ++iRow)
   {
-    if (it->second->StartAsUTC() >= beginTime && it->second->EndAsUTC() <= endTime)
-      return it->second;
+    if (index.End(iRow) <= end)
+      return index.Tag(iRow);
   }
 
   return CPVREpgInfoTagPtr();
@@ -255,17 +262,17 @@ CPVREpgInfoTagPtr CPVREpg::GetTagBetween(const CDateTime &beginTime, const CDate
 std::vector<CPVREpgInfoTagPtr> CPVREpg::GetTagsBetween(const CDateTime &beginTime, const CDateTime &endTime) const
 {
   std::vector<CPVREpgInfoTagPtr> epgTags;
+  const time_t begin = CPVREpgIndex::ToTime(beginTime);
+  const time_t end = CPVREpgIndex::ToTime(endTime);
 
   CSingleLock lock(m_critSection);
-  for (const auto &infoTag : m_tags)
+  const CPVREpgIndex &index = GetIndex();
+  for (size_t iRow = index.LowerBound(begin); iRow < index.Size(); ++iRow)
   {
-    if (infoTag.second->StartAsUTC() >= beginTime)
-    {
-      if (infoTag.second->EndAsUTC() <= endTime)
-        epgTags.emplace_back(infoTag.second);
-      else
-        break; // done.
-    }
+    if (index.End(iRow) <= end)
+      epgTags.emplace_back(index.Tag(iRow));
+    else
+      break; // done.
   }
 
   return epgTags;
@@ -292,6 +299,10 @@ void CPVREpg::AddEntry(const CPVREpgInfoTag &tag)
   if (newTag)
   {
     newTag->Update(tag);
+    {
+      CSingleLock lock(m_critSection);
+      m_bIndexDirty = true;
+    }
     newTag->SetChannel(channel);
     newTag->SetEpg(this);
     newTag->SetTimer(CServiceBroker::GetPVRManager().Timers()->GetTimerForEpgTag(newTag));
@@ -404,11 +415,15 @@ bool CPVREpg::UpdateEntry(const CPVREpgInfoTagPtr &tag, bool bUpdateDatabase)
       bNewTag = true;
     }
 
-    infoTag->Update(*tag, bNewTag);
+    bool bChanged = infoTag->Update(*tag, bNewTag);
+    if (bNewTag || bChanged)
+      m_bIndexDirty = true;
+
     infoTag->SetEpg(this);
     infoTag->SetChannel(m_pvrChannel);
 
-    if (bUpdateDatabase)
+    // unchanged broadcasts are already in the database as they are
+    if (bUpdateDatabase && (bNewTag || bChanged))
       m_changedTags.insert(std::make_pair(infoTag->UniqueBroadcastID(), infoTag));
   }
 
@@ -455,6 +470,7 @@ bool CPVREpg::UpdateEntry(const CPVREpgInfoTagPtr &tag, EPG_EVENT_STATE newState
         it->second->ClearTimer();
         it->second->ClearRecording();
         m_tags.erase(it);
+        m_bIndexDirty = true;
       }
       else
       {
@@ -548,12 +564,28 @@ int CPVREpg::Get(CFileItemList &results, const CPVREpgSearchFilter &filter) cons
   if (!HasValidEntries())
     return -1;
 
+  /* the filter matches local times, so only narrow down by start time here, with a day of slack
+   * for the utc offset. FilterEntry does the exact check on the remaining rows. */
+  static const time_t slack = 24 * 60 * 60;
+  const CDateTime &startTime = filter.GetStartDateTime();
+  const CDateTime &endTime = filter.GetEndDateTime();
+
   CSingleLock lock(m_critSection);
+  const CPVREpgIndex &index = GetIndex();
 
-  for (std::map<CDateTime, CPVREpgInfoTagPtr>::const_iterator it = m_tags.begin(); it != m_tags.end(); ++it)
+  size_t iFirst = 0;
+  size_t iLast = index.Size();
+  if (startTime.IsValid())
+    iFirst = index.LowerBound(CPVREpgIndex::ToTime(startTime.GetAsUTCDateTime()) - slack);
+  if (endTime.IsValid())
+    iLast = index.LowerBound(CPVREpgIndex::ToTime(endTime.GetAsUTCDateTime()) + slack);
+
+  /* titles repeat a lot within a table, so the title search runs once per distinct title */
+  std::vector<int> titleMatches(index.TitleCount(), -1);
+  for (size_t iRow = iFirst; iRow < iLast; ++iRow)
   {
-    if (filter.FilterEntry(it->second))
-      results.Add(CFileItemPtr(new CFileItem(it->second)));
+    if (filter.FilterEntry(index.Tag(iRow), titleMatches[index.TitleId(iRow)]))
+      results.Add(CFileItemPtr(new CFileItem(index.Tag(iRow))));
   }
 
   return results.Size() - iInitialSize;
@@ -572,36 +604,41 @@ bool CPVREpg::Persist(void)
   }
 
   database->Lock();
+  bool bRet = QueuePersistQuery(database) && database->CommitPersistQueries();
+  database->Unlock();
 
-  {
-    CSingleLock lock(m_critSection);
-    if (m_iEpgID <= 0 || m_bChanged)
-    {
-      int iId = database->Persist(*this, m_iEpgID > 0);
-      if (iId > 0)
-        m_iEpgID = iId;
-    }
+  return bRet;
+}
 
-    for (std::map<int, CPVREpgInfoTagPtr>::iterator it = m_deletedTags.begin(); it != m_deletedTags.end(); ++it)
-      database->Delete(*it->second);
+bool CPVREpg::QueuePersistQuery(const CPVREpgDatabasePtr &database)
+{
+  if (CServiceBroker::GetSettings().GetBool(CSettings::SETTING_EPG_IGNOREDBFORCLIENT) || !NeedsSave())
+    return true;
 
-    for (std::map<int, CPVREpgInfoTagPtr>::iterator it = m_changedTags.begin(); it != m_changedTags.end(); ++it)
-      it->second->Persist(false);
+  CSingleLock lock(m_critSection);
+  if (m_iEpgID <= 0 || m_bChanged)
+  {
+    int iId = database->Persist(*this, m_iEpgID > 0);
+    if (iId > 0)
+      m_iEpgID = iId;
+  }
 
-    if (m_bUpdateLastScanTime)
-      database->PersistLastEpgScanTime(m_iEpgID, true);
+  for (std::map<int, CPVREpgInfoTagPtr>::iterator it = m_deletedTags.begin(); it != m_deletedTags.end(); ++it)
+    database->QueueDeleteQuery(*it->second);
 
-    m_deletedTags.clear();
-    m_changedTags.clear();
-    m_bChanged            = false;
-    m_bTagsChanged        = false;
-    m_bUpdateLastScanTime = false;
-  }
+  for (std::map<int, CPVREpgInfoTagPtr>::iterator it = m_changedTags.begin(); it != m_changedTags.end(); ++it)
+    database->QueuePersistQuery(*it->second);
 
-  bool bRet = database->CommitInsertQueries();
+  if (m_bUpdateLastScanTime)
+    database->PersistLastEpgScanTime(m_iEpgID, true);
 
-  database->Unlock();
-  return bRet;
+  m_deletedTags.clear();
+  m_changedTags.clear();
+  m_bChanged            = false;
+  m_bTagsChanged        = false;
+  m_bUpdateLastScanTime = false;
+
+  return true;
 }
 
 CDateTime CPVREpg::GetFirstDate(void) const
@@ -631,6 +668,17 @@ CDateTime CPVREpg::GetLastDate(void) const
 /** @name Private methods */
 //@{
 
+const CPVREpgIndex &CPVREpg::GetIndex(void) const
+{
+  if (m_bIndexDirty)
+  {
+    m_index.Rebuild(m_tags);
+    m_bIndexDirty = false;
+  }
+
+  return m_index;
+}
+
 bool CPVREpg::FixOverlappingEvents(bool bUpdateDb /* = false */)
 {
   bool bReturn(true);
@@ -657,10 +705,12 @@ bool CPVREpg::FixOverlappingEvents(bool bUpdateDb /* = false */)
       it->second->ClearTimer();
       it->second->ClearRecording();
       m_tags.erase(it++);
+      m_bIndexDirty = true;
     }
     else if (previousTag->EndAsUTC() > currentTag->StartAsUTC())
     {
       previousTag->SetEndFromUTC(currentTag->StartAsUTC());
+      m_bIndexDirty = true;
       if (bUpdateDb)
         m_changedTags.insert(make_pair(previousTag->UniqueBroadcastID(), previousTag));
 
@@ -30,6 +30,7 @@
 
 #include "pvr/PVRTypes.h"
 #include "pvr/channels/PVRChannel.h"
+#include "pvr/epg/EpgIndex.h"
 #include "pvr/epg/EpgInfoTag.h"
 #include "pvr/epg/EpgSearchFilter.h"
 
@@ -243,6 +244,14 @@ namespace PVR
      */
     bool Persist(void);
 
+    /*!
+     * @brief Queue the changes of this table to be written by CPVREpgDatabase::CommitPersistQueries().
+     * Only tags that were added, changed or removed since the last call are written.
+     * @param database The database to queue the changes with. Must be locked by the caller.
+     * @return True if the changes were queued, false otherwise.
+     */
+    bool QueuePersistQuery(const CPVREpgDatabasePtr &database);
+
     /*!
      * @brief Get the start time of the first entry in this table.
      * @return The first date in UTC.
@@ -303,6 +312,13 @@ namespace PVR
      */
     bool FixOverlappingEvents(bool bUpdateDb = false);
 
+    /*!
+     * @brief Get the index of this table, rebuilding it if the tags changed since the last call.
+     * @note m_critSection must be held by the caller.
+     * @return The index.
+     */
+    const CPVREpgIndex &GetIndex(void) const;
+
     /*!
      * @brief Add an infotag to this container.
      * @param tag The tag to add.
@@ -342,6 +358,8 @@ namespace PVR
     PVR::CPVRChannelPtr                 m_pvrChannel;      /*!< the channel this EPG belongs to */
 
     mutable CCriticalSection            m_critSection;     /*!< critical section for changes in this table */
+    mutable CPVREpgIndex                m_index;           /*!< columnar view of m_tags, rebuilt on demand */
+    mutable bool                        m_bIndexDirty = true; /*!< true if m_tags changed since m_index was built */
     bool                                m_bUpdateLastScanTime = false;
   };
 }
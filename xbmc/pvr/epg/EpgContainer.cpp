@@ -345,14 +345,31 @@ bool CPVREpgContainer::PersistAll(void)
   auto copy = m_epgs;
   m_critSection.unlock();
 
+  const CPVREpgDatabasePtr database = GetEpgDatabase();
+  if (!database)
+  {
+    CLog::LogF(LOGERROR, "Could not open the EPG database");
+    return false;
+  }
+
+  unsigned int iStart = XbmcThreads::SystemClockMillis();
+
+  // queue the changes of all tables and write them in one go
+  database->Lock();
   for (EPGMAP::const_iterator it = copy.begin(); it != copy.end() && !m_bStop; ++it)
   {
     CPVREpgPtr epg = it->second;
     if (epg && epg->NeedsSave())
     {
-      bReturn &= epg->Persist();
+      bReturn &= epg->QueuePersistQuery(database);
     }
   }
+  bReturn &= database->CommitPersistQueries();
+  unsigned int iRows = database->ResetRowsWritten();
+  database->Unlock();
+
+  if (iRows > 0)
+    CLog::Log(LOGDEBUG, "EPG - %s - wrote %u rows in %u ms", __FUNCTION__, iRows, XbmcThreads::SystemClockMillis() - iStart);
 
   return bReturn;
 }
@@ -33,6 +33,18 @@
 using namespace dbiplus;
 using namespace PVR;
 
+namespace
+{
+  const char *EPGTAG_COLUMNS = "idEpg, iStartTime, iEndTime, sTitle, sPlotOutline, sPlot, sOriginalTitle, sCast, "
+      "sDirector, sWriter, iYear, sIMDBNumber, sIconPath, iGenreType, iGenreSubType, sGenre, iFirstAired, "
+      "iParentalRating, iStarRating, bNotify, iSeriesId, iEpisodeId, iEpisodePart, sEpisodeName, iFlags, "
+      "iBroadcastUid";
+
+  // flush a multi row statement once it holds this many rows or bytes, well below sqlite's and mysql's limits
+  const size_t MAX_ROWS_PER_STATEMENT = 200;
+  const size_t MAX_STATEMENT_LENGTH = 512 * 1024;
+}
+
 bool CPVREpgDatabase::Open()
 {
   CSingleLock lock(m_critSection);
@@ -366,51 +378,13 @@ int CPVREpgDatabase::Persist(const CPVREpgInfoTag &tag, bool bSingleUpdate /* =
     return iReturn;
   }
 
-  time_t iStartTime, iEndTime, iFirstAired;
-  tag.StartAsUTC().GetAsTime(iStartTime);
-  tag.EndAsUTC().GetAsTime(iEndTime);
-  tag.FirstAiredAsUTC().GetAsTime(iFirstAired);
-
   int iBroadcastId = tag.BroadcastId();
   std::string strQuery;
 
-  /* Only store the genre string when needed */
-  std::string strGenre = (tag.GenreType() == EPG_GENRE_USE_STRING) ? tag.DeTokenize(tag.Genre()) : "";
-
   CSingleLock lock(m_critSection);
-
-  if (iBroadcastId < 0)
-  {
-    strQuery = PrepareSQL("REPLACE INTO epgtags (idEpg, iStartTime, "
-        "iEndTime, sTitle, sPlotOutline, sPlot, sOriginalTitle, sCast, sDirector, sWriter, iYear, sIMDBNumber, "
-        "sIconPath, iGenreType, iGenreSubType, sGenre, iFirstAired, iParentalRating, iStarRating, bNotify, iSeriesId, "
-        "iEpisodeId, iEpisodePart, sEpisodeName, iFlags, iBroadcastUid) "
-        "VALUES (%u, %u, %u, '%s', '%s', '%s', '%s', '%s', '%s', '%s', %i, '%s', '%s', %i, %i, '%s', %u, %i, %i, %i, %i, %i, %i, '%s', %i, %i);",
-        tag.EpgID(), static_cast<unsigned int>(iStartTime), static_cast<unsigned int>(iEndTime),
-        tag.Title(true).c_str(), tag.PlotOutline(true).c_str(), tag.Plot(true).c_str(),
-        tag.OriginalTitle(true).c_str(), tag.DeTokenize(tag.Cast()).c_str(), tag.DeTokenize(tag.Directors()).c_str(),
-        tag.DeTokenize(tag.Writers()).c_str(), tag.Year(), tag.IMDBNumber().c_str(),
-        tag.Icon().c_str(), tag.GenreType(), tag.GenreSubType(), strGenre.c_str(),
-        static_cast<unsigned int>(iFirstAired), tag.ParentalRating(), tag.StarRating(), tag.Notify(),
-        tag.SeriesNumber(), tag.EpisodeNumber(), tag.EpisodePart(), tag.EpisodeName(true).c_str(), tag.Flags(),
-        tag.UniqueBroadcastID());
-  }
-  else
-  {
-    strQuery = PrepareSQL("REPLACE INTO epgtags (idEpg, iStartTime, "
-        "iEndTime, sTitle, sPlotOutline, sPlot, sOriginalTitle, sCast, sDirector, sWriter, iYear, sIMDBNumber, "
-        "sIconPath, iGenreType, iGenreSubType, sGenre, iFirstAired, iParentalRating, iStarRating, bNotify, iSeriesId, "
-        "iEpisodeId, iEpisodePart, sEpisodeName, iFlags, iBroadcastUid, idBroadcast) "
-        "VALUES (%u, %u, %u, '%s', '%s', '%s', '%s', '%s', '%s', '%s', %i, '%s', '%s', %i, %i, '%s', %u, %i, %i, %i, %i, %i, %i, '%s', %i, %i, %i);",
-        tag.EpgID(), static_cast<unsigned int>(iStartTime), static_cast<unsigned int>(iEndTime),
-        tag.Title(true).c_str(), tag.PlotOutline(true).c_str(), tag.Plot(true).c_str(),
-        tag.OriginalTitle(true).c_str(), tag.DeTokenize(tag.Cast()).c_str(), tag.DeTokenize(tag.Directors()).c_str(),
-        tag.DeTokenize(tag.Writers()).c_str(), tag.Year(), tag.IMDBNumber().c_str(),
-        tag.Icon().c_str(), tag.GenreType(), tag.GenreSubType(), strGenre.c_str(),
-        static_cast<unsigned int>(iFirstAired), tag.ParentalRating(), tag.StarRating(), tag.Notify(),
-        tag.SeriesNumber(), tag.EpisodeNumber(), tag.EpisodePart(), tag.EpisodeName(true).c_str(), tag.Flags(),
-        tag.UniqueBroadcastID(), iBroadcastId);
-  }
+  strQuery = StringUtils::Format("REPLACE INTO epgtags (%s%s) VALUES %s;",
+      EPGTAG_COLUMNS, iBroadcastId < 0 ? "" : ", idBroadcast", GetTagValues(tag).c_str());
+  m_iRowsWritten++;
 
   if (bSingleUpdate)
   {
@@ -426,6 +400,120 @@ int CPVREpgDatabase::Persist(const CPVREpgInfoTag &tag, bool bSingleUpdate /* =
   return iReturn;
 }
 
+std::string CPVREpgDatabase::GetTagValues(const CPVREpgInfoTag &tag)
+{
+  time_t iStartTime, iEndTime, iFirstAired;
+  tag.StartAsUTC().GetAsTime(iStartTime);
+  tag.EndAsUTC().GetAsTime(iEndTime);
+  tag.FirstAiredAsUTC().GetAsTime(iFirstAired);
+
+  /* Only store the genre string when needed */
+  std::string strGenre = (tag.GenreType() == EPG_GENRE_USE_STRING) ? tag.DeTokenize(tag.Genre()) : "";
+
+  std::string strValues = PrepareSQL("(%u, %u, %u, '%s', '%s', '%s', '%s', '%s', '%s', '%s', %i, '%s', '%s', %i, %i, '%s', %u, %i, %i, %i, %i, %i, %i, '%s', %i, %i",
+      tag.EpgID(), static_cast<unsigned int>(iStartTime), static_cast<unsigned int>(iEndTime),
+      tag.Title(true).c_str(), tag.PlotOutline(true).c_str(), tag.Plot(true).c_str(),
+      tag.OriginalTitle(true).c_str(), tag.DeTokenize(tag.Cast()).c_str(), tag.DeTokenize(tag.Directors()).c_str(),
+      tag.DeTokenize(tag.Writers()).c_str(), tag.Year(), tag.IMDBNumber().c_str(),
+      tag.Icon().c_str(), tag.GenreType(), tag.GenreSubType(), strGenre.c_str(),
+      static_cast<unsigned int>(iFirstAired), tag.ParentalRating(), tag.StarRating(), tag.Notify(),
+      tag.SeriesNumber(), tag.EpisodeNumber(), tag.EpisodePart(), tag.EpisodeName(true).c_str(), tag.Flags(),
+      tag.UniqueBroadcastID());
+
+  if (tag.BroadcastId() >= 0)
+    strValues += PrepareSQL(", %i", tag.BroadcastId());
+
+  return strValues + ")";
+}
+
+bool CPVREpgDatabase::QueuePersistQuery(const CPVREpgInfoTag &tag)
+{
+  if (tag.EpgID() <= 0)
+  {
+    CLog::LogF(LOGERROR, "Tag '%s' does not have a valid table", tag.Title(true).c_str());
+    return false;
+  }
+
+  CSingleLock lock(m_critSection);
+  const bool bWithBroadcastId = tag.BroadcastId() >= 0;
+  std::string strValues = GetTagValues(tag);
+
+  m_pendingTagsLength[bWithBroadcastId] += strValues.size();
+  m_pendingTags[bWithBroadcastId].emplace_back(std::move(strValues));
+  m_iRowsWritten++;
+
+  if (m_pendingTags[bWithBroadcastId].size() >= MAX_ROWS_PER_STATEMENT ||
+      m_pendingTagsLength[bWithBroadcastId] >= MAX_STATEMENT_LENGTH)
+    FlushTagValues(bWithBroadcastId);
+
+  return true;
+}
+
+bool CPVREpgDatabase::QueueDeleteQuery(const CPVREpgInfoTag &tag)
+{
+  /* tag without a database ID was not persisted */
+  if (tag.BroadcastId() <= 0)
+    return false;
+
+  CSingleLock lock(m_critSection);
+  m_pendingDeletes.emplace_back(std::to_string(tag.BroadcastId()));
+  m_iRowsWritten++;
+
+  if (m_pendingDeletes.size() >= MAX_ROWS_PER_STATEMENT)
+    FlushDeletes();
+
+  return true;
+}
+
+void CPVREpgDatabase::FlushTagValues(bool bWithBroadcastId)
+{
+  if (m_pendingTags[bWithBroadcastId].empty())
+    return;
+
+  m_pendingTagStatements.emplace_back(StringUtils::Format("REPLACE INTO epgtags (%s%s) VALUES ",
+      EPGTAG_COLUMNS, bWithBroadcastId ? ", idBroadcast" : "") + StringUtils::Join(m_pendingTags[bWithBroadcastId], ",") + ";");
+
+  m_pendingTags[bWithBroadcastId].clear();
+  m_pendingTagsLength[bWithBroadcastId] = 0;
+}
+
+void CPVREpgDatabase::FlushDeletes()
+{
+  if (m_pendingDeletes.empty())
+    return;
+
+  m_pendingDeleteStatements.emplace_back("DELETE FROM epgtags WHERE idBroadcast IN (" + StringUtils::Join(m_pendingDeletes, ",") + ");");
+  m_pendingDeletes.clear();
+}
+
+bool CPVREpgDatabase::CommitPersistQueries()
+{
+  CSingleLock lock(m_critSection);
+
+  // removals go first, a tag may be removed and another one stored in its place. statements
+  // of full batches are held back until now, so this holds no matter when a batch filled up
+  FlushDeletes();
+  FlushTagValues(true);
+  FlushTagValues(false);
+
+  for (const auto& statement : m_pendingDeleteStatements)
+    QueueInsertQuery(statement);
+  for (const auto& statement : m_pendingTagStatements)
+    QueueInsertQuery(statement);
+  m_pendingDeleteStatements.clear();
+  m_pendingTagStatements.clear();
+
+  return CommitInsertQueries();
+}
+
+unsigned int CPVREpgDatabase::ResetRowsWritten()
+{
+  CSingleLock lock(m_critSection);
+  unsigned int iRows = m_iRowsWritten;
+  m_iRowsWritten = 0;
+  return iRows;
+}
+
 int CPVREpgDatabase::GetLastEPGId(void)
 {
   CSingleLock lock(m_critSection);
@@ -20,6 +20,9 @@
 
 #pragma once
 
+#include <string>
+#include <vector>
+
 #include "XBDateTime.h"
 #include "dbwrappers/Database.h"
 #include "threads/CriticalSection.h"
@@ -155,6 +158,33 @@ namespace PVR
      */
     int Persist(const CPVREpgInfoTag &tag, bool bSingleUpdate = true);
 
+    /*!
+     * @brief Queue an infotag to be persisted by the next call to CommitPersistQueries().
+     * Queued tags are written with multi row statements, many tags per statement.
+     * @param tag The tag to persist.
+     * @return True if the tag was queued, false otherwise.
+     */
+    bool QueuePersistQuery(const CPVREpgInfoTag &tag);
+
+    /*!
+     * @brief Queue the removal of an infotag until the next call to CommitPersistQueries().
+     * @param tag The tag to remove.
+     * @return True if the removal was queued, false if the tag was never persisted.
+     */
+    bool QueueDeleteQuery(const CPVREpgInfoTag &tag);
+
+    /*!
+     * @brief Write all queued tags, removals and other queued queries in a single transaction.
+     * @return True if the queries were executed successfully, false otherwise.
+     */
+    bool CommitPersistQueries();
+
+    /*!
+     * @brief Get the number of rows written or removed since the last call to this method.
+     * @return The number of rows.
+     */
+    unsigned int ResetRowsWritten();
+
     /*!
      * @return Last EPG id in the database
      */
@@ -181,6 +211,30 @@ namespace PVR
 
     int GetMinSchemaVersion() const override { return 4; }
 
+    /*!
+     * @brief Get the values of a tag for a REPLACE INTO epgtags statement.
+     * @param tag The tag.
+     * @return The values, in braces.
+     */
+    std::string GetTagValues(const CPVREpgInfoTag &tag);
+
+    /*!
+     * @brief Turn the pending tag values into a statement, queued by the next call to CommitPersistQueries().
+     * @param bWithBroadcastId Flush the tags which have (true) or don't have (false) a database ID yet.
+     */
+    void FlushTagValues(bool bWithBroadcastId);
+
+    /*!
+     * @brief Turn the pending removals into a statement, queued by the next call to CommitPersistQueries().
+     */
+    void FlushDeletes();
+
     CCriticalSection m_critSection;
+    std::vector<std::string> m_pendingTags[2]; //!< queued tag values, without and with a broadcast id
+    size_t m_pendingTagsLength[2] = {};
+    std::vector<std::string> m_pendingDeletes;
+    std::vector<std::string> m_pendingTagStatements; //!< full batches of tag values
+    std::vector<std::string> m_pendingDeleteStatements; //!< full batches of removals
+    unsigned int m_iRowsWritten = 0;
   };
 }
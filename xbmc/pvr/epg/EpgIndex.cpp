@@ -0,0 +1,123 @@
+/*
+ *      Copyright (C) 2018 Team Kodi
+ *      http://kodi.tv
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this Program; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+
+#include "EpgIndex.h"
+
+#include <algorithm>
+#include <string>
+#include <unordered_map>
+
+#include "pvr/epg/EpgInfoTag.h"
+
+using namespace PVR;
+
+namespace
+{
+  unsigned int Intern(const std::string &str, std::unordered_map<std::string, unsigned int> &ids)
+  {
+    return ids.insert(std::make_pair(str, static_cast<unsigned int>(ids.size()))).first->second;
+  }
+}
+
+time_t CPVREpgIndex::ToTime(const CDateTime &dateTime)
+{
+  time_t time = 0;
+  if (dateTime.IsValid())
+    dateTime.GetAsTime(time);
+  return time;
+}
+
+void CPVREpgIndex::Clear()
+{
+  m_firstBucket = 0;
+  m_bucketDuration = BUCKET_DURATION;
+  m_buckets.clear();
+  m_starts.clear();
+  m_ends.clear();
+  m_titles.clear();
+  m_tags.clear();
+  m_titleCount = 0;
+}
+
+void CPVREpgIndex::Rebuild(const std::map<CDateTime, CPVREpgInfoTagPtr> &tags)
+{
+  Clear();
+  if (tags.empty())
+    return;
+
+  m_starts.reserve(tags.size());
+  m_ends.reserve(tags.size());
+  m_titles.reserve(tags.size());
+  m_tags.reserve(tags.size());
+
+  std::unordered_map<std::string, unsigned int> titleIds;
+  for (const auto &it : tags)
+  {
+    const CPVREpgInfoTagPtr &tag = it.second;
+    time_t start = ToTime(tag->StartAsUTC());
+    time_t end = ToTime(tag->EndAsUTC());
+    if (start <= 0 || end <= 0)
+      continue;
+
+    m_starts.push_back(start);
+    m_ends.push_back(end);
+    m_titles.push_back(Intern(tag->Title(true), titleIds));
+    m_tags.push_back(tag);
+  }
+  m_titleCount = static_cast<unsigned int>(titleIds.size());
+
+  if (m_starts.empty())
+    return;
+
+  /* the map is ordered by CDateTime, which matches the order of the converted times. a bogus
+   * date far in the future must not blow up the bucket table, so long tables get longer buckets */
+  time_t span = m_starts.back() - m_starts.front();
+  m_bucketDuration = BUCKET_DURATION;
+  if (static_cast<size_t>(span / m_bucketDuration) >= MAX_BUCKETS)
+    m_bucketDuration = (span / (MAX_BUCKETS - 1) / BUCKET_DURATION + 1) * BUCKET_DURATION;
+
+  m_firstBucket = m_starts.front() - (m_starts.front() % m_bucketDuration);
+  size_t iBuckets = static_cast<size_t>((m_starts.back() - m_firstBucket) / m_bucketDuration) + 1;
+  m_buckets.resize(iBuckets + 1);
+
+  size_t iRow = 0;
+  for (size_t iBucket = 0; iBucket < iBuckets; ++iBucket)
+  {
+    time_t bucketStart = m_firstBucket + static_cast<time_t>(iBucket) * m_bucketDuration;
+    while (iRow < m_starts.size() && m_starts[iRow] < bucketStart)
+      ++iRow;
+    m_buckets[iBucket] = static_cast<unsigned int>(iRow);
+  }
+  m_buckets[iBuckets] = static_cast<unsigned int>(m_starts.size());
+}
+
+size_t CPVREpgIndex::LowerBound(time_t time) const
+{
+  if (m_starts.empty() || time <= m_starts.front())
+    return 0;
+  if (time > m_starts.back())
+    return m_starts.size();
+
+  size_t iBucket = static_cast<size_t>((time - m_firstBucket) / m_bucketDuration);
+  auto begin = m_starts.begin() + m_buckets[iBucket];
+  auto end = m_starts.begin() + m_buckets[iBucket + 1];
+  return std::lower_bound(begin, end, time) - m_starts.begin();
+}
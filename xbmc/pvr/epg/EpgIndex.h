@@ -0,0 +1,95 @@
+/*
+ *      Copyright (C) 2018 Team Kodi
+ *      http://kodi.tv
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this Program; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+
+#pragma once
+
+#include <ctime>
+#include <map>
+#include <vector>
+
+#include "XBDateTime.h"
+
+#include "pvr/PVRTypes.h"
+
+namespace PVR
+{
+  /*!
+   * @brief Columnar view of the tags of one EPG table, sorted by start time.
+   * Start and end times are stored as UTC time_t, titles are interned once per table and an
+   * hourly bucket table bounds the binary search for a start time to a single hour.
+   */
+  class CPVREpgIndex
+  {
+  public:
+    static const time_t BUCKET_DURATION = 60 * 60;
+    static const size_t MAX_BUCKETS = 24 * 7 * 8; /*!< tables spanning more than 8 weeks get longer buckets */
+
+    /*!
+     * @brief Rebuild this index from the tags of a table. Tags without a valid start or end time are left out.
+     * @param tags The tags, ordered by start time.
+     */
+    void Rebuild(const std::map<CDateTime, CPVREpgInfoTagPtr> &tags);
+
+    /*!
+     * @brief Drop all rows.
+     */
+    void Clear();
+
+    /*!
+     * @return The number of rows in this index.
+     */
+    size_t Size() const { return m_starts.size(); }
+
+    /*!
+     * @brief Get the first row starting at or after the given time.
+     * @param time The time, UTC.
+     * @return The row, or Size() if no tag starts at or after time.
+     */
+    size_t LowerBound(time_t time) const;
+
+    time_t Start(size_t row) const { return m_starts[row]; }
+    time_t End(size_t row) const { return m_ends[row]; }
+    unsigned int TitleId(size_t row) const { return m_titles[row]; }
+    const CPVREpgInfoTagPtr &Tag(size_t row) const { return m_tags[row]; }
+
+    /*!
+     * @return The number of distinct titles in this index. All title ids are lower than this.
+     */
+    unsigned int TitleCount() const { return m_titleCount; }
+
+    /*!
+     * @brief Convert a date to UTC time_t.
+     * @param dateTime The date, UTC.
+     * @return The time, or 0 if the date is invalid.
+     */
+    static time_t ToTime(const CDateTime &dateTime);
+
+  private:
+    time_t m_firstBucket = 0;                 /*!< start of the first bucket */
+    time_t m_bucketDuration = BUCKET_DURATION;
+    std::vector<unsigned int> m_buckets;      /*!< first row starting in each bucket, plus a terminating Size() */
+    std::vector<time_t> m_starts;
+    std::vector<time_t> m_ends;
+    std::vector<unsigned int> m_titles;
+    std::vector<CPVREpgInfoTagPtr> m_tags;
+    unsigned int m_titleCount = 0;
+  };
+}
@@ -44,6 +44,7 @@ void CPVREpgSearchFilter::Reset()
 {
   m_strSearchTerm.clear();
   m_bIsCaseSensitive         = false;
+  UpdateTextSearch();
   m_bSearchInDescription     = false;
   m_iGenreType               = EPG_SEARCH_UNSET;
   m_iGenreSubType            = EPG_SEARCH_UNSET;
@@ -114,18 +115,30 @@ void CPVREpgSearchFilter::SetSearchPhrase(const std::string &strSearchPhrase)
   m_strSearchTerm = "\"";
   m_strSearchTerm.append(strSearchPhrase);
   m_strSearchTerm.append("\"");
+  UpdateTextSearch();
 }
 
-bool CPVREpgSearchFilter::MatchSearchTerm(const CPVREpgInfoTagPtr &tag) const
+void CPVREpgSearchFilter::UpdateTextSearch()
+{
+  // parsed here rather than on first use, searches of several tables may share this filter
+  if (m_strSearchTerm.empty())
+    m_textSearch.reset();
+  else
+    m_textSearch = std::make_shared<const CTextSearch>(m_strSearchTerm, m_bIsCaseSensitive, SEARCH_DEFAULT_OR);
+}
+
+bool CPVREpgSearchFilter::MatchSearchTerm(const CPVREpgInfoTagPtr &tag, int &iTitleMatch) const
 {
   bool bReturn(true);
 
-  if (!m_strSearchTerm.empty())
+  if (m_textSearch)
   {
-    CTextSearch search(m_strSearchTerm, m_bIsCaseSensitive, SEARCH_DEFAULT_OR);
-    bReturn = search.Search(tag->Title()) ||
-              search.Search(tag->PlotOutline()) ||
-              (m_bSearchInDescription && search.Search(tag->Plot()));
+    if (iTitleMatch < 0)
+      iTitleMatch = m_textSearch->Search(tag->Title()) ? 1 : 0;
+
+    bReturn = iTitleMatch > 0 ||
+              m_textSearch->Search(tag->PlotOutline()) ||
+              (m_bSearchInDescription && m_textSearch->Search(tag->Plot()));
   }
 
   return bReturn;
@@ -140,12 +153,18 @@ bool CPVREpgSearchFilter::MatchBroadcastId(const CPVREpgInfoTagPtr &tag) const
 }
 
 bool CPVREpgSearchFilter::FilterEntry(const CPVREpgInfoTagPtr &tag) const
+{
+  int iTitleMatch(-1);
+  return FilterEntry(tag, iTitleMatch);
+}
+
+bool CPVREpgSearchFilter::FilterEntry(const CPVREpgInfoTagPtr &tag, int &iTitleMatch) const
 {
   return (MatchGenre(tag) &&
       MatchBroadcastId(tag) &&
       MatchDuration(tag) &&
       MatchStartAndEndTimes(tag) &&
-      MatchSearchTerm(tag) &&
+      MatchSearchTerm(tag, iTitleMatch) &&
       MatchTimers(tag) &&
       MatchRecordings(tag)) &&
       (!tag->HasChannel() ||
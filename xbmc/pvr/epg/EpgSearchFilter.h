@@ -20,12 +20,15 @@
 
 #pragma once
 
+#include <memory>
+
 #include "XBDateTime.h"
 
 #include "pvr/PVRTypes.h"
 #include "pvr/channels/PVRChannelNumber.h"
 
 class CFileItemList;
+class CTextSearch;
 
 namespace PVR
 {
@@ -56,6 +59,14 @@ namespace PVR
      */
     bool FilterEntry(const CPVREpgInfoTagPtr &tag) const;
 
+    /*!
+     * @brief Check if a tag will be filtered or not, reusing the title match of an earlier tag with the same title.
+     * @param tag The tag to check.
+     * @param iTitleMatch -1 if the title was not matched yet, 0 or 1 otherwise. Updated if the title had to be matched.
+     * @return True if this tag matches the filter, false if not.
+     */
+    bool FilterEntry(const CPVREpgInfoTagPtr &tag, int &iTitleMatch) const;
+
     /*!
      * @brief remove duplicates from a list of epg tags.
      * @param results the list of epg tags.
@@ -70,11 +81,11 @@ namespace PVR
     bool IsRadio() const { return m_bIsRadio; }
 
     const std::string &GetSearchTerm() const { return m_strSearchTerm; }
-    void SetSearchTerm(const std::string &strSearchTerm) { m_strSearchTerm = strSearchTerm; }
+    void SetSearchTerm(const std::string &strSearchTerm) { m_strSearchTerm = strSearchTerm; UpdateTextSearch(); }
     void SetSearchPhrase(const std::string &strSearchPhrase);
 
     bool IsCaseSensitive() const { return m_bIsCaseSensitive; }
-    void SetCaseSensitive(bool bIsCaseSensitive) { m_bIsCaseSensitive = bIsCaseSensitive; }
+    void SetCaseSensitive(bool bIsCaseSensitive) { m_bIsCaseSensitive = bIsCaseSensitive; UpdateTextSearch(); }
 
     bool ShouldSearchInDescription() const { return m_bSearchInDescription; }
     void SetSearchInDescription(bool bSearchInDescription) {m_bSearchInDescription = bSearchInDescription; }
@@ -122,10 +133,11 @@ namespace PVR
     void SetUniqueBroadcastId(unsigned int iUniqueBroadcastId) { m_iUniqueBroadcastId = iUniqueBroadcastId; }
 
   private:
+    void UpdateTextSearch();
     bool MatchGenre(const CPVREpgInfoTagPtr &tag) const;
     bool MatchDuration(const CPVREpgInfoTagPtr &tag) const;
     bool MatchStartAndEndTimes(const CPVREpgInfoTagPtr &tag) const;
-    bool MatchSearchTerm(const CPVREpgInfoTagPtr &tag) const;
+    bool MatchSearchTerm(const CPVREpgInfoTagPtr &tag, int &iTitleMatch) const;
     bool MatchChannelNumber(const CPVREpgInfoTagPtr &tag) const;
     bool MatchChannelGroup(const CPVREpgInfoTagPtr &tag) const;
     bool MatchBroadcastId(const CPVREpgInfoTagPtr &tag) const;
@@ -154,5 +166,7 @@ namespace PVR
     bool          m_bIgnorePresentTimers;     /*!< True to ignore currently present timers (future recordings), false if not */
     bool          m_bIgnorePresentRecordings; /*!< True to ignore currently active recordings, false if not */
     unsigned int  m_iUniqueBroadcastId;       /*!< The broadcastid to search for */
+
+    std::shared_ptr<const CTextSearch> m_textSearch; /*!< Parsed m_strSearchTerm, null if there is none */
   };
 }
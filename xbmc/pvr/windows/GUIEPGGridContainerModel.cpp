@@ -20,6 +20,7 @@
 
 #include "GUIEPGGridContainerModel.h"
 
+#include <algorithm>
 #include <cmath>
 
 #include "FileItem.h"
@@ -38,6 +39,28 @@ using namespace PVR;
 
 static const unsigned int GRID_START_PADDING = 30; // minutes
 
+namespace
+{
+  time_t GetAsTime(const CDateTime &dateTime)
+  {
+    time_t time = 0;
+    dateTime.GetAsTime(time);
+    return time;
+  }
+
+  // index of the first block whose start is at or after the given time, clamped to iBlocks
+  int GetFirstBlockAtOrAfter(time_t gridStart, time_t time, int iBlocks)
+  {
+    static const time_t blockDuration = CGUIEPGGridContainerModel::MINSPERBLOCK * 60;
+
+    if (time <= gridStart)
+      return 0;
+
+    time_t block = (time - gridStart + blockDuration - 1) / blockDuration;
+    return block < iBlocks ? static_cast<int>(block) : iBlocks;
+  }
+}
+
 void CGUIEPGGridContainerModel::SetInvalid()
 {
   for (const auto &programme : m_programmeItems)
@@ -157,7 +180,6 @@ void CGUIEPGGridContainerModel::Refresh(const std::unique_ptr<CFileItemList> &it
 
   ////////////////////////////////////////////////////////////////////////
   // Create epg grid
-  const CDateTimeSpan blockDuration(0, 0, MINSPERBLOCK, 0);
   const CDateTimeSpan gridDuration(m_gridEnd - m_gridStart);
   m_blocks = (gridDuration.GetDays() * 24 * 60 + gridDuration.GetHours() * 60 + gridDuration.GetMinutes()) / MINSPERBLOCK;
   if (m_blocks >= MAXBLOCKS)
@@ -167,48 +189,45 @@ void CGUIEPGGridContainerModel::Refresh(const std::unique_ptr<CFileItemList> &it
 
   m_gridIndex.reserve(m_channelItems.size());
   const std::vector<GridItem> blocks(m_blocks);
+  const time_t gridStartTime = GetAsTime(m_gridStart);
+  const time_t gridEndTime = GetAsTime(m_gridEnd);
 
   for (size_t channel = 0; channel < m_channelItems.size(); ++channel)
   {
     m_gridIndex.emplace_back(blocks);
 
-    CDateTime gridCursor(m_gridStart); //reset cursor for new channel
     unsigned long progIdx = m_epgItemsPtr[channel].start;
     unsigned long lastIdx = m_epgItemsPtr[channel].stop;
     int iEpgId            = m_programmeItems[progIdx]->GetEPGInfoTag()->EpgID();
     int itemSize          = 1; // size of the programme in blocks
     int savedBlock        = 0;
-    CFileItemPtr item;
+    int nextBlock         = 0; // first block not covered by an earlier programme
     CPVREpgInfoTagPtr tag;
 
-    for (int block = 0; block < m_blocks; ++block)
+    // Programmes are sorted by start time, so each one covers the blocks starting within
+    // [start, end) that no earlier programme covered already.
+    // Note: Start block of an event is start-time-based calculated block + 1,
+    //       unless start times matches exactly the begin of a block.
+    for (; progIdx <= lastIdx && nextBlock < m_blocks; ++progIdx)
     {
-      while (progIdx <= lastIdx)
-      {
-        item = m_programmeItems[progIdx];
-        tag = item->GetEPGInfoTag();
+      tag = m_programmeItems[progIdx]->GetEPGInfoTag();
 
-        // Note: Start block of an event is start-time-based calculated block + 1,
-        //       unless start times matches exactly the begin of a block.
-
-        if (tag->EpgID() != iEpgId || gridCursor < tag->StartAsUTC() || m_gridEnd <= tag->StartAsUTC())
-          break;
-
-        if (gridCursor < tag->EndAsUTC())
-        {
-          m_gridIndex[channel][block].item = item;
-          m_gridIndex[channel][block].progIndex = progIdx;
-          break;
-        }
+      const time_t start = GetAsTime(tag->StartAsUTC());
+      if (tag->EpgID() != iEpgId || gridEndTime <= start)
+        break;
 
-        progIdx++;
+      const int endBlock = GetFirstBlockAtOrAfter(gridStartTime, GetAsTime(tag->EndAsUTC()), m_blocks);
+      for (int block = std::max(nextBlock, GetFirstBlockAtOrAfter(gridStartTime, start, m_blocks)); block < endBlock; ++block)
+      {
+        m_gridIndex[channel][block].item = m_programmeItems[progIdx];
+        m_gridIndex[channel][block].progIndex = progIdx;
       }
 
-      gridCursor += blockDuration;
-
-      if (block == 0)
-        continue;
+      nextBlock = std::max(nextBlock, endBlock);
+    }
 
+    for (int block = 1; block < m_blocks; ++block)
+    {
       const CFileItemPtr prevItem(m_gridIndex[channel][block - 1].item);
       const CFileItemPtr currItem(m_gridIndex[channel][block].item);
 
@@ -275,8 +294,6 @@ void CGUIEPGGridContainerModel::Refresh(const std::unique_ptr<CFileItemList> &it
 
 void CGUIEPGGridContainerModel::FindChannelAndBlockIndex(int channelUid, unsigned int broadcastUid, int eventOffset, int &newChannelIndex, int &newBlockIndex) const
 {
-  const CDateTimeSpan blockDuration(0, 0, MINSPERBLOCK, 0);
-
   newChannelIndex = INVALID_INDEX;
   newBlockIndex = INVALID_INDEX;
 
@@ -295,32 +312,30 @@ void CGUIEPGGridContainerModel::FindChannelAndBlockIndex(int channelUid, unsigne
   if (newChannelIndex != INVALID_INDEX)
   {
     // find the block
-    CDateTime gridCursor(m_gridStart); //reset cursor for new channel
+    const time_t gridStart = GetAsTime(m_gridStart);
+    const time_t gridEnd = GetAsTime(m_gridEnd);
     unsigned long progIdx = m_epgItemsPtr[newChannelIndex].start;
     unsigned long lastIdx = m_epgItemsPtr[newChannelIndex].stop;
     int iEpgId = m_programmeItems[progIdx]->GetEPGInfoTag()->EpgID();
+    int nextBlock = 0;
     CPVREpgInfoTagPtr tag;
-    for (int block = 0; block < m_blocks; ++block)
+    for (; progIdx <= lastIdx && nextBlock < m_blocks; ++progIdx)
     {
-      while (progIdx <= lastIdx)
-      {
-        tag = m_programmeItems[progIdx]->GetEPGInfoTag();
+      tag = m_programmeItems[progIdx]->GetEPGInfoTag();
 
-        if (tag->EpgID() != iEpgId || gridCursor < tag->StartAsUTC() || m_gridEnd <= tag->StartAsUTC())
-          break; // next block
+      const time_t start = GetAsTime(tag->StartAsUTC());
+      if (tag->EpgID() != iEpgId || gridEnd <= start)
+        break;
 
-        if (gridCursor < tag->EndAsUTC())
-        {
-          if (broadcastUid > 0 && tag->UniqueBroadcastID() == broadcastUid)
-          {
-            newBlockIndex = block + eventOffset;
-            return; // done.
-          }
-          break; // next block
-        }
-        progIdx++;
+      const int startBlock = std::max(nextBlock, GetFirstBlockAtOrAfter(gridStart, start, m_blocks));
+      const int endBlock = GetFirstBlockAtOrAfter(gridStart, GetAsTime(tag->EndAsUTC()), m_blocks);
+      if (startBlock < endBlock && broadcastUid > 0 && tag->UniqueBroadcastID() == broadcastUid)
+      {
+        newBlockIndex = startBlock + eventOffset;
+        return; // done.
       }
-      gridCursor += blockDuration;
+
+      nextBlock = std::max(nextBlock, endBlock);
     }
   }
 }
@@ -0,0 +1,147 @@
+/*
+ *      Copyright (C) 2018 Team Kodi
+ *      http://kodi.tv
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this Program; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+
+#include "filesystem/File.h"
+#include "guilib/DDSImage.h"
+#include "guilib/FFmpegImage.h"
+#include "guilib/XBTF.h"
+#include "test/TestUtils.h"
+#include "utils/TimeUtils.h"
+
+#include "gtest/gtest.h"
+
+#include <cstring>
+#include <iostream>
+#include <vector>
+
+namespace
+{
+const unsigned int posterWidth = 500;
+const unsigned int posterHeight = 750;
+const unsigned int posterWall = 2000;
+
+std::vector<unsigned char> CreatePoster()
+{
+  std::vector<unsigned char> pixels(posterWidth * posterHeight * 4);
+  for (unsigned int y = 0; y < posterHeight; y++)
+  {
+    for (unsigned int x = 0; x < posterWidth; x++)
+    {
+      unsigned char *pixel = &pixels[(y * posterWidth + x) * 4];
+      pixel[0] = x * 255 / posterWidth;
+      pixel[1] = y * 255 / posterHeight;
+      pixel[2] = (x ^ y) & 0xff;
+      pixel[3] = 0xff;
+    }
+  }
+  return pixels;
+}
+
+double Seconds(int64_t start)
+{
+  return static_cast<double>(CurrentHostCounter() - start) / CurrentHostFrequency();
+}
+}
+
+TEST(TestDDSImage, WriteReadFile)
+{
+  std::vector<unsigned char> pixels = CreatePoster();
+  CDDSImage image(posterWidth, posterHeight, XB_FMT_A8R8G8B8);
+  memcpy(image.GetData(), pixels.data(), pixels.size());
+
+  XFILE::CFile *file = XBMC_CREATETEMPFILE(".dds");
+  ASSERT_NE(nullptr, file);
+  std::string path = XBMC_TEMPFILEPATH(file);
+  file->Close();
+  EXPECT_TRUE(image.WriteFile(path));
+
+  CDDSImage loaded;
+  EXPECT_TRUE(loaded.ReadFile(path));
+  EXPECT_EQ(posterWidth, loaded.GetWidth());
+  EXPECT_EQ(posterHeight, loaded.GetHeight());
+  EXPECT_EQ(static_cast<unsigned int>(XB_FMT_A8R8G8B8), loaded.GetFormat());
+  ASSERT_EQ(pixels.size(), loaded.GetSize());
+  EXPECT_EQ(0, memcmp(pixels.data(), loaded.GetData(), pixels.size()));
+
+  EXPECT_TRUE(XBMC_DELETETEMPFILE(file));
+}
+
+/* Reload latency of a poster wall: decoding the cached jpeg of every poster
+ * vs reading back its decoded copy. Run with --gtest_also_run_disabled_tests.
+ */
+TEST(TestDDSImage, DISABLED_PosterWallReload)
+{
+  std::vector<unsigned char> pixels = CreatePoster();
+
+  XFILE::CFile *jpegFile = XBMC_CREATETEMPFILE(".jpg");
+  XFILE::CFile *ddsFile = XBMC_CREATETEMPFILE(".dds");
+  ASSERT_NE(nullptr, jpegFile);
+  ASSERT_NE(nullptr, ddsFile);
+  std::string jpegPath = XBMC_TEMPFILEPATH(jpegFile);
+  std::string ddsPath = XBMC_TEMPFILEPATH(ddsFile);
+  jpegFile->Close();
+  ddsFile->Close();
+
+  {
+    CFFmpegImage encoder("image/jpeg");
+    unsigned char *buffer = nullptr;
+    unsigned int bufferSize = 0;
+    ASSERT_TRUE(encoder.CreateThumbnailFromSurface(pixels.data(), posterWidth, posterHeight, XB_FMT_A8R8G8B8,
+                                                   posterWidth * 4, jpegPath, buffer, bufferSize));
+    XFILE::CFile file;
+    ASSERT_TRUE(file.OpenForWrite(jpegPath, true));
+    EXPECT_EQ(static_cast<ssize_t>(bufferSize), file.Write(buffer, bufferSize));
+    file.Close();
+    encoder.ReleaseThumbnailBuffer();
+
+    CDDSImage image(posterWidth, posterHeight, XB_FMT_A8R8G8B8);
+    memcpy(image.GetData(), pixels.data(), pixels.size());
+    ASSERT_TRUE(image.WriteFile(ddsPath));
+  }
+
+  int64_t start = CurrentHostCounter();
+  for (unsigned int i = 0; i < posterWall; i++)
+  {
+    XFILE::CFile file;
+    XFILE::auto_buffer buffer;
+    ASSERT_LT(0, file.LoadFile(jpegPath, buffer));
+    CFFmpegImage decoder("image/jpeg");
+    ASSERT_TRUE(decoder.LoadImageFromMemory(reinterpret_cast<unsigned char*>(buffer.get()), buffer.size(),
+                                            posterWidth, posterHeight));
+    ASSERT_TRUE(decoder.Decode(pixels.data(), decoder.Width(), decoder.Height(), posterWidth * 4, XB_FMT_A8R8G8B8));
+  }
+  double decodeTime = Seconds(start);
+
+  start = CurrentHostCounter();
+  for (unsigned int i = 0; i < posterWall; i++)
+  {
+    CDDSImage image;
+    ASSERT_TRUE(image.ReadFile(ddsPath));
+  }
+  double readTime = Seconds(start);
+
+  std::cout << posterWall << " posters: decoding " << decodeTime * 1000 / posterWall << " ms per poster, "
+            << "decoded copy " << readTime * 1000 / posterWall << " ms per poster" << std::endl;
+  EXPECT_LT(readTime, decodeTime);
+
+  EXPECT_TRUE(XBMC_DELETETEMPFILE(jpegFile));
+  EXPECT_TRUE(XBMC_DELETETEMPFILE(ddsFile));
+}
@@ -0,0 +1,98 @@
+/*
+ *      Copyright (C) 2018 Team Kodi
+ *      http://kodi.tv
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this Program; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "DatabaseManager.h"
+#include "ServiceBroker.h"
+#include "dbwrappers/sqlitedataset.h"
+
+#include <atomic>
+#include <thread>
+
+#include "gtest/gtest.h"
+
+TEST(TestDatabaseManager, ReuseConnection)
+{
+  CDatabaseManager &manager = CServiceBroker::GetDatabaseManager();
+  const std::string key = "sqlite3://@test:/ReuseConnection";
+
+  EXPECT_EQ(nullptr, manager.AcquireConnection(key));
+
+  std::unique_ptr<dbiplus::Database> connection(new dbiplus::SqliteDatabase());
+  dbiplus::Database *released = connection.get();
+  manager.ReleaseConnection(key, std::move(connection));
+
+  // an idle connection is handed out once, and only for its own database
+  EXPECT_EQ(nullptr, manager.AcquireConnection(key + "2"));
+  connection = manager.AcquireConnection(key);
+  EXPECT_EQ(released, connection.get());
+  EXPECT_EQ(nullptr, manager.AcquireConnection(key));
+
+  // and is taken again once it's released again
+  manager.ReleaseConnection(key, std::move(connection));
+  connection = manager.AcquireConnection(key);
+  EXPECT_EQ(released, connection.get());
+}
+
+TEST(TestDatabaseManager, KeepFewIdleConnections)
+{
+  CDatabaseManager &manager = CServiceBroker::GetDatabaseManager();
+  const std::string key = "sqlite3://@test:/KeepFewIdleConnections";
+
+  for (int i = 0; i < 10; i++)
+    manager.ReleaseConnection(key, std::unique_ptr<dbiplus::Database>(new dbiplus::SqliteDatabase()));
+
+  int idle = 0;
+  while (manager.AcquireConnection(key))
+    idle++;
+  EXPECT_EQ(4, idle);
+}
+
+TEST(TestDatabaseManager, ClearConnections)
+{
+  CDatabaseManager &manager = CServiceBroker::GetDatabaseManager();
+  const std::string key = "sqlite3://@test:/ClearConnections";
+
+  manager.ReleaseConnection(key, std::unique_ptr<dbiplus::Database>(new dbiplus::SqliteDatabase()));
+  manager.ClearConnections();
+  EXPECT_EQ(nullptr, manager.AcquireConnection(key));
+}
+
+TEST(TestDatabaseManager, WriteLockReleasedByOtherThread)
+{
+  CDatabaseWriteLock &writeLock = CServiceBroker::GetDatabaseManager().GetWriteLock("sqlite3://@test:/WriteLock");
+
+  // the thread holding the lock may take it again
+  writeLock.Lock();
+  writeLock.Lock();
+  writeLock.Unlock();
+
+  std::atomic<bool> locked(false);
+  std::thread writer([&]()
+  {
+    writeLock.Lock();
+    locked = true;
+    writeLock.Unlock();
+  });
+
+  // a transaction may end on another thread than the one that began it
+  std::thread([&]() { writeLock.Unlock(); }).join();
+  writer.join();
+  EXPECT_TRUE(locked);
+}
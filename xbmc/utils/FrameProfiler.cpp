@@ -0,0 +1,229 @@
+/*
+ *      Copyright (C) 2018 Team Kodi
+ *      http://kodi.tv
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this Program; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+
+#include "FrameProfiler.h"
+
+#include "filesystem/File.h"
+#include "threads/SingleLock.h"
+#include "threads/Thread.h"
+#include "utils/JSONVariantWriter.h"
+#include "utils/log.h"
+#include "utils/StringUtils.h"
+#include "utils/Variant.h"
+
+#include <algorithm>
+#include <cinttypes>
+
+namespace
+{
+struct Span
+{
+  const char *category;
+  const char *name;
+  int id;
+  int64_t start;
+  int64_t end;
+};
+}
+
+struct CFrameProfiler::ThreadBuffer
+{
+  ThreadBuffer(unsigned int generation, unsigned int size) : generation(generation), mask(size - 1), spans(size) {}
+
+  const unsigned int generation;
+  const uint64_t mask; // the ring size is a power of two
+  unsigned int tid = 0;
+  std::string name;
+  std::vector<Span> spans;
+  std::atomic<uint64_t> head{0}; // number of spans ever written, only advanced by the owning thread
+};
+
+const unsigned int CFrameProfiler::DEFAULT_SPANS;
+const unsigned int CFrameProfiler::MAX_SPANS;
+std::atomic<bool> CFrameProfiler::m_running{false};
+thread_local std::shared_ptr<CFrameProfiler::ThreadBuffer> CFrameProfiler::m_threadBuffer;
+
+CFrameProfiler& CFrameProfiler::GetInstance()
+{
+  static CFrameProfiler profiler;
+  return profiler;
+}
+
+void CFrameProfiler::Start(unsigned int spans /* = 0 */)
+{
+  if (spans == 0)
+    spans = DEFAULT_SPANS;
+  unsigned int size = 1;
+  while (size < std::min(spans, MAX_SPANS))
+    size <<= 1;
+
+  CSingleLock lock(m_section);
+  // threads still holding a buffer of the previous generation register a new one on their next span
+  m_spans = size;
+  ++m_generation;
+  m_buffers.clear();
+  m_startCounter = CurrentHostCounter();
+  m_running = true;
+
+  CLog::Log(LOGNOTICE, "CFrameProfiler: started, keeping %u spans per thread", size);
+}
+
+void CFrameProfiler::Stop()
+{
+  m_running = false;
+
+  const uint64_t dropped = GetDroppedSpans();
+  if (dropped > 0)
+    CLog::Log(LOGWARNING, "CFrameProfiler: stopped, %" PRIu64" spans were overwritten - start with more spans per thread to keep them", dropped);
+  else
+    CLog::Log(LOGNOTICE, "CFrameProfiler: stopped");
+}
+
+uint64_t CFrameProfiler::GetDroppedSpans() const
+{
+  CSingleLock lock(m_section);
+  uint64_t dropped = 0;
+  for (const auto &buffer : m_buffers)
+  {
+    const uint64_t head = buffer->head.load(std::memory_order_acquire);
+    if (head > buffer->spans.size())
+      dropped += head - buffer->spans.size();
+  }
+  return dropped;
+}
+
+CFrameProfiler::ThreadBuffer* CFrameProfiler::GetThreadBuffer()
+{
+  const unsigned int generation = m_generation.load(std::memory_order_acquire);
+  if (m_threadBuffer && m_threadBuffer->generation == generation)
+    return m_threadBuffer.get();
+
+  CThread *thread = CThread::GetCurrentThread();
+
+  CSingleLock lock(m_section);
+  if (generation != m_generation)
+    return nullptr; // restarted in the meantime, the span belongs to the previous run
+
+  std::shared_ptr<ThreadBuffer> buffer = std::make_shared<ThreadBuffer>(generation, m_spans);
+  buffer->tid = static_cast<unsigned int>(m_buffers.size()) + 1;
+  buffer->name = thread ? thread->GetName() : StringUtils::Format("Thread %u", buffer->tid);
+  m_buffers.push_back(buffer);
+  m_threadBuffer = buffer;
+  return buffer.get();
+}
+
+void CFrameProfiler::Record(const char *category, const char *name, int id, int64_t start, int64_t end)
+{
+  ThreadBuffer *buffer = GetThreadBuffer();
+  if (!buffer)
+    return;
+
+  const uint64_t head = buffer->head.load(std::memory_order_relaxed);
+  Span &span = buffer->spans[head & buffer->mask];
+  span.category = category;
+  span.name = name;
+  span.id = id;
+  span.start = start;
+  span.end = end;
+  buffer->head.store(head + 1, std::memory_order_release);
+}
+
+void CFrameProfiler::GetTrace(CVariant &trace) const
+{
+  std::vector<std::shared_ptr<ThreadBuffer>> buffers;
+  int64_t startCounter;
+  {
+    CSingleLock lock(m_section);
+    buffers = m_buffers;
+    startCounter = m_startCounter;
+  }
+
+  const double usPerTick = 1000000.0 / CurrentHostFrequency();
+
+  trace = CVariant(CVariant::VariantTypeObject);
+  trace["displayTimeUnit"] = "ms";
+  trace["traceEvents"] = CVariant(CVariant::VariantTypeArray);
+  CVariant &events = trace["traceEvents"];
+  uint64_t dropped = 0;
+
+  std::vector<Span> spans;
+  for (const auto &buffer : buffers)
+  {
+    CVariant threadName(CVariant::VariantTypeObject);
+    threadName["name"] = "thread_name";
+    threadName["ph"] = "M";
+    threadName["pid"] = 1;
+    threadName["tid"] = buffer->tid;
+    threadName["args"]["name"] = buffer->name;
+    events.push_back(threadName);
+
+    // copy the ring while its thread may still be writing to it, then drop
+    // everything that could have been overwritten during the copy
+    const uint64_t size = buffer->spans.size();
+    const uint64_t head = buffer->head.load(std::memory_order_acquire);
+    const uint64_t first = head > size ? head - size : 0;
+    spans.clear();
+    for (uint64_t i = first; i < head; ++i)
+      spans.push_back(buffer->spans[i & buffer->mask]);
+
+    const uint64_t headAfter = buffer->head.load(std::memory_order_acquire);
+    const uint64_t valid = headAfter >= size ? headAfter - size + 1 : 0;
+    dropped += std::max(first, valid);
+
+    for (uint64_t i = std::max(first, valid); i < head; ++i)
+    {
+      const Span &span = spans[i - first];
+      CVariant event(CVariant::VariantTypeObject);
+      event["name"] = *span.name ? span.name : "unnamed";
+      event["cat"] = span.category;
+      event["ph"] = "X";
+      event["pid"] = 1;
+      event["tid"] = buffer->tid;
+      event["ts"] = (span.start - startCounter) * usPerTick;
+      event["dur"] = (span.end - span.start) * usPerTick;
+      if (span.id >= 0)
+        event["args"]["id"] = span.id;
+      events.push_back(event);
+    }
+  }
+
+  trace["otherData"]["droppedSpans"] = dropped;
+}
+
+bool CFrameProfiler::SaveTrace(const std::string &path) const
+{
+  CVariant trace;
+  GetTrace(trace);
+
+  std::string json;
+  if (!CJSONVariantWriter::Write(trace, json, true))
+    return false;
+
+  XFILE::CFile file;
+  if (!file.OpenForWrite(path, true) || file.Write(json.c_str(), json.size()) != static_cast<ssize_t>(json.size()))
+  {
+    CLog::Log(LOGERROR, "CFrameProfiler: unable to write trace to %s", path.c_str());
+    return false;
+  }
+
+  CLog::Log(LOGNOTICE, "CFrameProfiler: saved %u events to %s", static_cast<unsigned int>(trace["traceEvents"].size()), path.c_str());
+  return true;
+}
@@ -0,0 +1,140 @@
+/*
+ *      Copyright (C) 2018 Team Kodi
+ *      http://kodi.tv
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this Program; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+
+#pragma once
+
+#include <atomic>
+#include <memory>
+#include <stdint.h>
+#include <string>
+#include <vector>
+
+#include "threads/CriticalSection.h"
+#include "utils/TimeUtils.h"
+
+class CVariant;
+
+/*!
+ \brief Continuous frame profiler.
+
+ Records scoped spans (GUI processing/rendering, texture uploads, font cache misses,
+ job callbacks, ...) into a fixed size ring buffer per thread. Recording does not
+ take any lock once a thread has registered its buffer. The recorded spans can be
+ exported in the Chrome trace event format (chrome://tracing, Perfetto).
+ */
+class CFrameProfiler
+{
+public:
+  static CFrameProfiler& GetInstance();
+  static bool IsRunning() { return m_running.load(std::memory_order_relaxed); }
+
+  /*!
+   \brief Discard all recorded spans and start recording.
+   \param spans number of spans kept per thread, rounded up to a power of two. 0 uses
+   DEFAULT_SPANS. The GUI thread records two spans per control each frame, so a window
+   of a few hundred controls needs about 40000 for a second at 60 fps
+   */
+  void Start(unsigned int spans = 0);
+
+  /*!
+   \brief Stop recording. Recorded spans are kept until the next Start().
+   */
+  void Stop();
+
+  /*!
+   \brief Get the number of spans overwritten by newer ones since the last Start().
+   */
+  uint64_t GetDroppedSpans() const;
+
+  static const unsigned int DEFAULT_SPANS = 1 << 16;
+  static const unsigned int MAX_SPANS = 1 << 22;
+
+  /*!
+   \brief Record a span on the calling thread.
+   \param category the span category, must be a string literal
+   \param name the span name, must be a string literal
+   \param id optional id of the profiled object (window, control, ...), -1 if none
+   \param start the host counter at the beginning of the span
+   \param end the host counter at the end of the span
+   */
+  void Record(const char *category, const char *name, int id, int64_t start, int64_t end);
+
+  /*!
+   \brief Get the recorded spans as Chrome trace object.
+   \param trace the object to fill with "traceEvents", "displayTimeUnit" and the
+   number of spans dropped as "otherData.droppedSpans"
+   */
+  void GetTrace(CVariant &trace) const;
+
+  /*!
+   \brief Save the recorded spans as Chrome trace JSON file.
+   \param path the file to write
+   \return true if the file was written, false otherwise
+   */
+  bool SaveTrace(const std::string &path) const;
+
+private:
+  CFrameProfiler() = default;
+  CFrameProfiler(const CFrameProfiler&) = delete;
+  CFrameProfiler& operator=(const CFrameProfiler&) = delete;
+
+  struct ThreadBuffer;
+  ThreadBuffer* GetThreadBuffer();
+
+  static std::atomic<bool> m_running;
+  static thread_local std::shared_ptr<ThreadBuffer> m_threadBuffer;
+
+  mutable CCriticalSection m_section;
+  std::vector<std::shared_ptr<ThreadBuffer>> m_buffers;
+  std::atomic<unsigned int> m_generation{0};
+  int64_t m_startCounter = 0;
+  unsigned int m_spans = DEFAULT_SPANS; ///< ring size of the buffers registered in this run
+};
+
+/*!
+ \brief Records a span for the lifetime of the object while the frame profiler is running.
+ */
+class CFrameProfilerScope
+{
+public:
+  CFrameProfilerScope(const char *category, const char *name, int id = -1)
+    : m_category(category),
+      m_name(name),
+      m_id(id),
+      m_start(CFrameProfiler::IsRunning() ? CurrentHostCounter() : 0)
+  {
+  }
+
+  ~CFrameProfilerScope()
+  {
+    if (m_start)
+      CFrameProfiler::GetInstance().Record(m_category, m_name, m_id, m_start, CurrentHostCounter());
+  }
+
+private:
+  CFrameProfilerScope(const CFrameProfilerScope&) = delete;
+  CFrameProfilerScope& operator=(const CFrameProfilerScope&) = delete;
+
+  const char *m_category;
+  const char *m_name;
+  int m_id;
+  int64_t m_start;
+};
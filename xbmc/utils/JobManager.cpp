@@ -23,6 +23,7 @@
 #include <functional>
 #include <stdexcept>
 #include "threads/SingleLock.h"
+#include "utils/FrameProfiler.h"
 #include "utils/log.h"
 #ifdef TARGET_POSIX
 #include "platform/linux/XTimeUtils.h"
@@ -74,6 +75,50 @@ void CJobWorker::Process()
   }
 }
 
+namespace
+{
+  // index of the work stealing worker running on this thread, -1 for any other thread
+  thread_local int stealingWorkerIndex = -1;
+}
+
+CJobStealingWorker::CJobStealingWorker(CJobManager *manager, unsigned int index)
+  : CThread("JobStealingWorker")
+  , m_jobManager(manager)
+  , m_index(index)
+{
+  Create();
+}
+
+CJobStealingWorker::~CJobStealingWorker()
+{
+  StopThread();
+}
+
+void CJobStealingWorker::Process()
+{
+  SetPriority( GetMinPriority() );
+  stealingWorkerIndex = m_index;
+  while (true)
+  {
+    // request an item from our manager (this call is blocking)
+    CJob *job = m_jobManager->GetNextStealingJob(m_index);
+    if (!job)
+      break;
+
+    bool success = false;
+    try
+    {
+      success = job->DoWork();
+    }
+    catch (...)
+    {
+      CLog::Log(LOGERROR, "%s error processing job %s", __FUNCTION__, job->GetType());
+    }
+    m_jobManager->OnStealingJobComplete(m_index, success, job);
+  }
+  stealingWorkerIndex = -1;
+}
+
 void CJobQueue::CJobPointer::CancelJob()
 {
   CJobManager::GetInstance().CancelJob(m_id);
@@ -182,6 +227,22 @@ CJobManager::CJobManager()
   m_jobCounter = 0;
   m_running = true;
   m_pauseJobs = false;
+  m_pausedStealing = false;
+  m_workStealing = false;
+  m_stealingCount = 0;
+  m_stealingStarted = 0;
+  m_stealingRunning = false;
+  m_stealingNext = 0;
+  m_stealingBusy = 0;
+  m_stealingQueued = 0;
+  m_stealingIdle = 0;
+}
+
+void CJobManager::SetWorkStealing(bool enable)
+{
+  if (m_workStealing != enable)
+    CLog::Log(LOGDEBUG, "CJobManager::SetWorkStealing - %s work stealing backend", enable ? "enabling" : "disabling");
+  m_workStealing = enable;
 }
 
 void CJobManager::Restart()
@@ -198,6 +259,21 @@ void CJobManager::CancelJobs()
   CSingleLock lock(m_section);
   m_running = false;
 
+  // clear any jobs pending in the work stealing queues and cancel callbacks of those processing
+  for (unsigned int i = 0; i < m_stealingCount; ++i)
+  {
+    CStealingQueue &queue = *m_stealingQueues[i];
+    CSingleLock queueLock(queue.section);
+    for (unsigned int priority = CJob::PRIORITY_LOW_PAUSABLE; priority <= CJob::PRIORITY_HIGH; ++priority)
+    {
+      m_stealingQueued -= queue.queue[priority].size();
+      for_each(queue.queue[priority].begin(), queue.queue[priority].end(), [](CWorkItem& wi) { wi.FreeJob(); });
+      queue.queue[priority].clear();
+      queue.size[priority] = 0;
+    }
+    for_each(queue.current.begin(), queue.current.end(), [](CWorkItem& wi) { wi.Cancel(); });
+  }
+
   // clear any pending jobs
   for (unsigned int priority = CJob::PRIORITY_LOW_PAUSABLE; priority <= CJob::PRIORITY_DEDICATED; ++priority)
   {
@@ -216,22 +292,33 @@ void CJobManager::CancelJobs()
     Sleep(0); // yield after setting the event to give the workers some time to die
     lock.Enter();
   }
+  lock.Leave();
+
+  StopStealingWorkers();
 }
 
 unsigned int CJobManager::AddJob(CJob *job, IJobCallback *callback, CJob::PRIORITY priority)
 {
-  CSingleLock lock(m_section);
-
   if (!m_running)
     return 0;
 
   // increment the job counter, ensuring 0 (invalid job) is never hit
-  m_jobCounter++;
-  if (m_jobCounter == 0)
-    m_jobCounter++;
+  unsigned int id = ++m_jobCounter;
+  if (id == 0)
+    id = ++m_jobCounter;
 
   // create a work item for this job
-  CWorkItem work(job, m_jobCounter, priority, callback);
+  CWorkItem work(job, id, priority, callback);
+
+  // dedicated jobs may block for as long as they like, so they never take a pool worker
+  if (m_workStealing && priority != CJob::PRIORITY_DEDICATED)
+    return AddStealingJob(work);
+
+  CSingleLock lock(m_section);
+
+  if (!m_running)
+    return 0;
+
   m_jobQueue[priority].push_back(work);
 
   StartWorkers(priority);
@@ -256,7 +343,36 @@ void CJobManager::CancelJob(unsigned int jobID)
   // or if we're processing it
   Processing::iterator it = find(m_processing.begin(), m_processing.end(), jobID);
   if (it != m_processing.end())
+  {
     it->m_callback = NULL; // job is in progress, so only thing to do is to remove callback
+    return;
+  }
+  lock.Leave();
+
+  // finally check the work stealing queues
+  for (unsigned int i = 0; i < m_stealingCount; ++i)
+  {
+    CStealingQueue &queue = *m_stealingQueues[i];
+    CSingleLock queueLock(queue.section);
+    for (unsigned int priority = CJob::PRIORITY_LOW_PAUSABLE; priority <= CJob::PRIORITY_HIGH; ++priority)
+    {
+      JobQueue::iterator job = find(queue.queue[priority].begin(), queue.queue[priority].end(), jobID);
+      if (job != queue.queue[priority].end())
+      {
+        delete job->m_job;
+        queue.queue[priority].erase(job);
+        queue.size[priority]--;
+        m_stealingQueued--;
+        return;
+      }
+    }
+    Processing::iterator it = find(queue.current.begin(), queue.current.end(), jobID);
+    if (it != queue.current.end())
+    {
+      it->m_callback = NULL;
+      return;
+    }
+  }
 }
 
 void CJobManager::StartWorkers(CJob::PRIORITY priority)
@@ -306,12 +422,17 @@ void CJobManager::PauseJobs()
 {
   CSingleLock lock(m_section);
   m_pauseJobs = true;
+  m_pausedStealing = true;
 }
 
 void CJobManager::UnPauseJobs()
 {
   CSingleLock lock(m_section);
   m_pauseJobs = false;
+  m_pausedStealing = false;
+
+  // workers may be idling on pausable jobs
+  NotifyStealingWorkers();
 }
 
 bool CJobManager::IsProcessing(const CJob::PRIORITY &priority) const
@@ -326,6 +447,14 @@ bool CJobManager::IsProcessing(const CJob::PRIORITY &priority) const
     if (priority == it->m_priority)
       return true;
   }
+
+  for (unsigned int i = 0; i < m_stealingCount; ++i)
+  {
+    CStealingQueue &queue = *m_stealingQueues[i];
+    CSingleLock queueLock(queue.section);
+    if (!queue.current.empty() && queue.current.front().m_priority == priority)
+      return true;
+  }
   return false;
 }
 
@@ -342,6 +471,14 @@ int CJobManager::IsProcessing(const std::string &type) const
     if (type == std::string(it->m_job->GetType()))
       jobsMatched++;
   }
+
+  for (unsigned int i = 0; i < m_stealingCount; ++i)
+  {
+    CStealingQueue &queue = *m_stealingQueues[i];
+    CSingleLock queueLock(queue.section);
+    if (!queue.current.empty() && type == std::string(queue.current.front().m_job->GetType()))
+      jobsMatched++;
+  }
   return jobsMatched;
 }
 
@@ -373,6 +510,25 @@ CJob *CJobManager::GetNextJob(const CJobWorker *worker)
 
 bool CJobManager::OnJobProgress(unsigned int progress, unsigned int total, const CJob *job) const
 {
+  // jobs of the work stealing backend can only be found in the queue of the worker running them
+  if (stealingWorkerIndex >= 0 && static_cast<unsigned int>(stealingWorkerIndex) < m_stealingCount)
+  {
+    CStealingQueue &queue = *m_stealingQueues[stealingWorkerIndex];
+    CSingleLock queueLock(queue.section);
+    Processing::const_iterator i = find(queue.current.begin(), queue.current.end(), job);
+    if (i != queue.current.end())
+    {
+      CWorkItem item(*i);
+      queueLock.Leave();
+      if (item.m_callback)
+      {
+        item.m_callback->OnJobProgress(item.m_id, progress, total, job);
+        return false;
+      }
+      return true;
+    }
+  }
+
   CSingleLock lock(m_section);
   // find the job in the processing queue, and check whether it's cancelled (no callback)
   Processing::const_iterator i = find(m_processing.begin(), m_processing.end(), job);
@@ -401,6 +557,7 @@ void CJobManager::OnJobComplete(bool success, CJob *job)
     lock.Leave();
     try
     {
+      CFrameProfilerScope profile("job", item.m_job->GetType());
       if (item.m_callback)
         item.m_callback->OnJobComplete(item.m_id, success, item.m_job);
     }
@@ -433,3 +590,224 @@ unsigned int CJobManager::GetMaxWorkers(CJob::PRIORITY priority)
     return 10000; // A large number..
   return max_workers - (CJob::PRIORITY_HIGH - priority);
 }
+
+void CJobManager::StartStealingWorkers()
+{
+  CSingleLock lock(m_stealingSection);
+  if (m_stealingRunning)
+    return;
+
+  // the queues are created once and outlive the workers, so they can be used without this lock.
+  // there is one per worker the shared queue would run at most, workers are started on demand
+  if (m_stealingCount == 0)
+  {
+    unsigned int count = GetMaxWorkers(CJob::PRIORITY_HIGH);
+    for (unsigned int i = 0; i < count; ++i)
+    {
+      m_stealingQueues.emplace_back(new CStealingQueue);
+      for (unsigned int priority = CJob::PRIORITY_LOW_PAUSABLE; priority <= CJob::PRIORITY_HIGH; ++priority)
+        m_stealingQueues.back()->size[priority] = 0;
+    }
+    m_stealingCount = count;
+  }
+
+  m_stealingRunning = true;
+  m_stealingWorkers.push_back(new CJobStealingWorker(this, 0));
+  m_stealingStarted = 1;
+}
+
+void CJobManager::AddStealingWorker()
+{
+  // enough workers free for the queued jobs, checked again once locked
+  auto needed = [this]()
+  {
+    const unsigned int started = m_stealingStarted;
+    return m_stealingRunning && started < m_stealingCount &&
+           started - std::min(m_stealingBusy.load(), started) < m_stealingQueued;
+  };
+  if (!needed())
+    return;
+
+  CSingleLock lock(m_stealingSection);
+  if (!needed())
+    return;
+
+  // everyone is busy, possibly blocked in a job - we need more workers
+  m_stealingWorkers.push_back(new CJobStealingWorker(this, m_stealingStarted));
+  m_stealingStarted++;
+  CLog::Log(LOGDEBUG, "CJobManager::AddStealingWorker - %u workers", m_stealingStarted.load());
+}
+
+void CJobManager::StopStealingWorkers()
+{
+  std::vector<CJobStealingWorker*> workers;
+  {
+    CSingleLock lock(m_stealingSection);
+    if (!m_stealingRunning)
+      return;
+
+    m_stealingRunning = false;
+    workers.swap(m_stealingWorkers);
+    m_stealingStarted = 0;
+  }
+
+  // not holding the lock, a worker may try to add another one while finishing its job
+  NotifyStealingWorkers();
+  for (auto worker : workers)
+    delete worker; // waits for the job it is processing
+}
+
+void CJobManager::NotifyStealingWorkers()
+{
+  // taken so a worker can't miss this between checking for jobs and waiting
+  CSingleLock lock(m_stealingWaitSection);
+  if (m_stealingIdle > 0)
+    m_stealingCondition.notifyAll();
+}
+
+unsigned int CJobManager::AddStealingJob(const CWorkItem &work)
+{
+  // jobs added by a job stay with its worker, anything else is spread round robin
+  unsigned int index;
+  if (stealingWorkerIndex >= 0)
+    index = stealingWorkerIndex;
+  else
+  {
+    StartStealingWorkers();
+    // the workers may be stopped meanwhile, the job then waits in the first queue for them to start again
+    const unsigned int started = m_stealingStarted;
+    index = started > 0 ? m_stealingNext++ % started : 0;
+  }
+
+  CStealingQueue &queue = *m_stealingQueues[index];
+  {
+    CSingleLock lock(queue.section);
+    queue.queue[work.m_priority].push_back(work);
+    queue.size[work.m_priority]++;
+    m_stealingQueued++;
+  }
+
+  NotifyStealingWorkers();
+  AddStealingWorker();
+  return work.m_id;
+}
+
+bool CJobManager::ReserveStealingSlot(CJob::PRIORITY priority)
+{
+  const unsigned int maxWorkers = GetMaxWorkers(priority);
+  unsigned int busy = m_stealingBusy;
+  while (busy < maxWorkers)
+  {
+    if (m_stealingBusy.compare_exchange_weak(busy, busy + 1))
+      return true;
+  }
+  return false;
+}
+
+CJob *CJobManager::GetNextStealingJob(unsigned int index)
+{
+  CStealingQueue &own = *m_stealingQueues[index];
+
+  // take the oldest job of the highest priority available, from our own queue first and then
+  // the newest one from the other workers, holding both queues (in index order) while moving it
+  auto takeJob = [&]() -> CJob*
+  {
+    if (m_stealingQueued == 0)
+      return NULL;
+
+    for (int priority = CJob::PRIORITY_HIGH; priority >= CJob::PRIORITY_LOW_PAUSABLE; --priority)
+    {
+      if (priority == CJob::PRIORITY_LOW_PAUSABLE && m_pausedStealing)
+        continue;
+
+      bool queued = false;
+      for (unsigned int i = 0; i < m_stealingCount && !queued; ++i)
+        queued = m_stealingQueues[i]->size[priority] > 0;
+      if (!queued || !ReserveStealingSlot(CJob::PRIORITY(priority)))
+        continue;
+
+      for (unsigned int n = 0; n < m_stealingCount; ++n)
+      {
+        const unsigned int victim = (index + n) % m_stealingCount;
+        CStealingQueue &queue = *m_stealingQueues[victim];
+        if (queue.size[priority] == 0)
+          continue;
+
+        CSingleLock firstLock(victim < index ? queue.section : own.section);
+        CSingleLock secondLock(victim < index ? own.section : queue.section);
+        JobQueue &jobs = queue.queue[priority];
+        if (jobs.empty())
+          continue;
+
+        CWorkItem work = victim == index ? jobs.front() : jobs.back();
+        if (victim == index)
+          jobs.pop_front();
+        else
+          jobs.pop_back();
+        queue.size[priority]--;
+        m_stealingQueued--;
+
+        own.current.push_back(work);
+        work.m_job->m_callback = this;
+        return work.m_job;
+      }
+      m_stealingBusy--;
+    }
+    return NULL;
+  };
+
+  while (m_stealingRunning)
+  {
+    CJob *job = takeJob();
+    if (!job)
+    {
+      // anything added before we were counted as idle is picked up by the second attempt,
+      // anything after notifies us
+      CSingleLock lock(m_stealingWaitSection);
+      m_stealingIdle++;
+      job = takeJob();
+      if (!job && m_stealingRunning)
+        m_stealingCondition.wait(lock, 1000);
+      m_stealingIdle--;
+    }
+
+    if (job)
+    {
+      // jobs still queued while every worker is busy, e.g. blocked on one of them
+      AddStealingWorker();
+      return job;
+    }
+  }
+  return NULL;
+}
+
+void CJobManager::OnStealingJobComplete(unsigned int index, bool success, CJob *job)
+{
+  CStealingQueue &queue = *m_stealingQueues[index];
+  CSingleLock lock(queue.section);
+  if (queue.current.empty())
+    return;
+
+  // tell any listeners we're done with the job, then delete it
+  CWorkItem item(queue.current.front());
+  lock.Leave();
+  try
+  {
+    CFrameProfilerScope profile("job", item.m_job->GetType());
+    if (item.m_callback)
+      item.m_callback->OnJobComplete(item.m_id, success, item.m_job);
+  }
+  catch (...)
+  {
+    CLog::Log(LOGERROR, "%s error processing job %s", __FUNCTION__, item.m_job->GetType());
+  }
+  lock.Enter();
+  queue.current.clear();
+  lock.Leave();
+  item.FreeJob();
+
+  // the slot we held may have been all that kept a queued job from running
+  m_stealingBusy--;
+  if (m_stealingQueued > 0)
+    NotifyStealingWorkers();
+}
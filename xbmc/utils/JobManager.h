@@ -20,10 +20,14 @@
 
 #pragma once
 
+#include <atomic>
+#include <memory>
 #include <queue>
 #include <vector>
 #include <string>
+#include "threads/Condition.h"
 #include "threads/CriticalSection.h"
+#include "threads/Event.h"
 #include "threads/Thread.h"
 #include "Job.h"
 
@@ -40,6 +44,25 @@ private:
   CJobManager  *m_jobManager;
 };
 
+/*!
+ \ingroup jobs
+ \brief Worker of the work stealing backend of CJobManager.
+
+ Lives for as long as the backend is running, taking jobs from its own queue first
+ and stealing from the other workers' queues when that is empty.
+ */
+class CJobStealingWorker : public CThread
+{
+public:
+  CJobStealingWorker(CJobManager *manager, unsigned int index);
+  ~CJobStealingWorker() override;
+
+  void Process() override;
+private:
+  CJobManager  *m_jobManager;
+  unsigned int  m_index;
+};
+
 template<typename F>
 class CLambdaJob : public CJob
 {
@@ -320,8 +343,18 @@ public:
    */
   bool IsProcessing(const CJob::PRIORITY &priority) const;
 
+  /*!
+   \brief Route jobs through the work stealing backend instead of the shared queue
+   The backend starts workers on demand, up to the number the shared queue would run at most,
+   each with its own queue per priority. PRIORITY_DEDICATED jobs always get a thread of their own.
+   Jobs already queued are processed by the backend they were added to.
+   \param enable whether new jobs should use the work stealing backend
+   */
+  void SetWorkStealing(bool enable);
+
 protected:
   friend class CJobWorker;
+  friend class CJobStealingWorker;
   friend class CJob;
   friend class CJobQueue;
 
@@ -367,12 +400,42 @@ private:
   void RemoveWorker(const CJobWorker *worker);
   static unsigned int GetMaxWorkers(CJob::PRIORITY priority);
 
-  unsigned int m_jobCounter;
+  void StartStealingWorkers();
+  /*! \brief Start one more worker if all are busy, up to one per queue
+   */
+  void AddStealingWorker();
+  void StopStealingWorkers();
+  /*! \brief Wake all workers waiting for a job
+   */
+  void NotifyStealingWorkers();
+  unsigned int AddStealingJob(const CWorkItem &work);
+  /*! \brief Reserve a worker slot for the given priority, honouring GetMaxWorkers()
+   */
+  bool ReserveStealingSlot(CJob::PRIORITY priority);
+  /*! \brief Pop a job for the given worker, stealing from the others if it has none
+   Blocks until a job is available or the backend is stopped.
+   \return the job to process, NULL if the worker should exit
+   */
+  CJob *GetNextStealingJob(unsigned int index);
+  void OnStealingJobComplete(unsigned int index, bool success, CJob *job);
+
+  std::atomic<unsigned int> m_jobCounter;
 
   typedef std::deque<CWorkItem>    JobQueue;
   typedef std::vector<CWorkItem>   Processing;
   typedef std::vector<CJobWorker*> Workers;
 
+  /*! \brief Per worker state of the work stealing backend
+   The queues are only locked by the owner and thieves, m_section is never taken on this path.
+   */
+  struct CStealingQueue
+  {
+    CCriticalSection section;
+    JobQueue         queue[CJob::PRIORITY_HIGH + 1];
+    std::atomic<unsigned int> size[CJob::PRIORITY_HIGH + 1];
+    Processing       current; //!< the job being processed by the owner, at most one
+  };
+
   JobQueue   m_jobQueue[CJob::PRIORITY_DEDICATED + 1];
   bool       m_pauseJobs;
   Processing m_processing;
@@ -380,5 +443,21 @@ private:
 
   mutable CCriticalSection m_section;
   CEvent           m_jobEvent;
-  bool             m_running;
+  std::atomic<bool> m_running;
+  std::atomic<bool> m_pausedStealing; //!< mirror of m_pauseJobs for the work stealing workers
+
+  // work stealing backend
+  std::atomic<bool> m_workStealing;
+  CCriticalSection m_stealingSection; //!< protects starting and stopping the workers
+  std::vector<std::unique_ptr<CStealingQueue>> m_stealingQueues;
+  std::vector<CJobStealingWorker*> m_stealingWorkers;
+  std::atomic<unsigned int> m_stealingCount; //!< number of queues, set once they exist and never changed after
+  std::atomic<unsigned int> m_stealingStarted; //!< workers started, they own the first queues
+  std::atomic<bool> m_stealingRunning;
+  std::atomic<unsigned int> m_stealingNext;   //!< round robin target for jobs added from outside the pool
+  std::atomic<unsigned int> m_stealingBusy;   //!< workers currently processing a job
+  std::atomic<unsigned int> m_stealingQueued; //!< jobs waiting in any of the queues
+  std::atomic<unsigned int> m_stealingIdle;   //!< workers waiting on m_stealingCondition
+  CCriticalSection m_stealingWaitSection;
+  XbmcThreads::ConditionVariable m_stealingCondition;
 };
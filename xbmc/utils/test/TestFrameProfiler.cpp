@@ -0,0 +1,150 @@
+/*
+ *      Copyright (C) 2018 Team Kodi
+ *      http://kodi.tv
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this Program; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+
+#include "utils/FrameProfiler.h"
+#include "utils/Variant.h"
+
+#include "gtest/gtest.h"
+
+#include <algorithm>
+#include <thread>
+
+namespace
+{
+unsigned int CountSpans(const CVariant &trace, const std::string &name)
+{
+  unsigned int count = 0;
+  for (auto it = trace["traceEvents"].begin_array(); it != trace["traceEvents"].end_array(); ++it)
+  {
+    if ((*it)["ph"].asString() == "X" && (*it)["name"].asString() == name)
+      count++;
+  }
+  return count;
+}
+}
+
+TEST(TestFrameProfiler, RecordsOnlyWhileRunning)
+{
+  CFrameProfiler &profiler = CFrameProfiler::GetInstance();
+  profiler.Start();
+  {
+    CFrameProfilerScope scope("test", "running", 42);
+  }
+  profiler.Stop();
+  {
+    CFrameProfilerScope scope("test", "stopped");
+  }
+
+  CVariant trace;
+  profiler.GetTrace(trace);
+  EXPECT_EQ("ms", trace["displayTimeUnit"].asString());
+  EXPECT_EQ(1u, CountSpans(trace, "running"));
+  EXPECT_EQ(0u, CountSpans(trace, "stopped"));
+
+  for (auto it = trace["traceEvents"].begin_array(); it != trace["traceEvents"].end_array(); ++it)
+  {
+    if ((*it)["name"].asString() == "running")
+    {
+      EXPECT_EQ("test", (*it)["cat"].asString());
+      EXPECT_EQ(42, (*it)["args"]["id"].asInteger());
+      EXPECT_GE((*it)["ts"].asDouble(), 0.0);
+      EXPECT_GE((*it)["dur"].asDouble(), 0.0);
+    }
+  }
+}
+
+TEST(TestFrameProfiler, StartDiscardsPreviousSpans)
+{
+  CFrameProfiler &profiler = CFrameProfiler::GetInstance();
+  profiler.Start();
+  {
+    CFrameProfilerScope scope("test", "first");
+  }
+  profiler.Start();
+  {
+    CFrameProfilerScope scope("test", "second");
+  }
+  profiler.Stop();
+
+  CVariant trace;
+  profiler.GetTrace(trace);
+  EXPECT_EQ(0u, CountSpans(trace, "first"));
+  EXPECT_EQ(1u, CountSpans(trace, "second"));
+}
+
+TEST(TestFrameProfiler, KeepsNewestSpansPerThread)
+{
+  CFrameProfiler &profiler = CFrameProfiler::GetInstance();
+  profiler.Start();
+
+  const unsigned int spans = 100000;
+  auto record = [spans]()
+  {
+    for (unsigned int i = 0; i < spans; ++i)
+      CFrameProfiler::GetInstance().Record("test", "thread", static_cast<int>(i), 1, 2);
+  };
+  std::thread first(record);
+  std::thread second(record);
+  first.join();
+  second.join();
+  profiler.Stop();
+
+  CVariant trace;
+  profiler.GetTrace(trace);
+
+  // every thread gets a name and a bounded number of its newest spans
+  unsigned int threads = 0;
+  unsigned int recorded = 0;
+  int lowestId = spans;
+  for (auto it = trace["traceEvents"].begin_array(); it != trace["traceEvents"].end_array(); ++it)
+  {
+    if ((*it)["ph"].asString() == "M")
+      threads++;
+    else if ((*it)["name"].asString() == "thread")
+    {
+      recorded++;
+      lowestId = std::min(lowestId, static_cast<int>((*it)["args"]["id"].asInteger()));
+    }
+  }
+  EXPECT_EQ(2u, threads);
+  EXPECT_GT(recorded, 0u);
+  EXPECT_LT(recorded, 2 * spans);
+  EXPECT_GT(lowestId, 0);
+  EXPECT_EQ(2 * spans - recorded, trace["otherData"]["droppedSpans"].asUnsignedInteger());
+}
+
+TEST(TestFrameProfiler, KeepsRequestedSpans)
+{
+  CFrameProfiler &profiler = CFrameProfiler::GetInstance();
+  profiler.Start(1000);
+  for (int i = 0; i < 1500; ++i)
+    profiler.Record("test", "sized", i, 1, 2);
+  profiler.Stop();
+
+  // rounded up to a power of two, the oldest slot may be the one being written next
+  CVariant trace;
+  profiler.GetTrace(trace);
+  const unsigned int kept = CountSpans(trace, "sized");
+  EXPECT_GE(kept, 1023u);
+  EXPECT_LE(kept, 1024u);
+  EXPECT_EQ(1500u - 1024u, profiler.GetDroppedSpans());
+  EXPECT_EQ(1500u - kept, trace["otherData"]["droppedSpans"].asUnsignedInteger());
+}
@@ -23,6 +23,8 @@
 
 #include "gtest/gtest.h"
 #include <atomic>
+#include <chrono>
+#include <memory>
 
 #ifdef TARGET_POSIX
 #include "platform/linux/XTimeUtils.h"
@@ -182,3 +184,62 @@ TEST_F(TestJobManager, IsProcessing)
 
   job->FinishAndStopBlocking();
 }
+
+namespace
+{
+/* Submits a large number of jobs doing next to nothing, so the time taken is dominated by
+ * the scheduling overhead of the job manager. Returns the elapsed time in ms, or -1 if the
+ * jobs didn't all complete in time.
+ */
+int RunTinyJobs(unsigned int count)
+{
+  // shared with the jobs, which may outlive this call if they don't complete in time
+  std::shared_ptr<std::atomic<unsigned int>> done = std::make_shared<std::atomic<unsigned int>>(0);
+  std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+
+  for (unsigned int i = 0; i < count; ++i)
+    CJobManager::GetInstance().Submit([done]() { (*done)++; });
+
+  std::chrono::steady_clock::time_point timeout = start + std::chrono::seconds(30);
+  while (*done < count && std::chrono::steady_clock::now() < timeout)
+    Sleep(1);
+
+  if (*done < count)
+    return -1;
+  return std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - start).count();
+}
+}
+
+TEST_F(TestJobManager, StressTinyJobs)
+{
+  int elapsed = RunTinyJobs(10000);
+  EXPECT_GE(elapsed, 0);
+  RecordProperty("SharedQueueMs", elapsed);
+}
+
+TEST_F(TestJobManager, StressTinyJobsWorkStealing)
+{
+  CJobManager::GetInstance().SetWorkStealing(true);
+  int elapsed = RunTinyJobs(10000);
+  CJobManager::GetInstance().SetWorkStealing(false);
+  EXPECT_GE(elapsed, 0);
+  RecordProperty("WorkStealingMs", elapsed);
+}
+
+TEST_F(TestJobManager, PauseLowPriorityJobWorkStealing)
+{
+  CJobManager::GetInstance().SetWorkStealing(true);
+  CJobManager::GetInstance().PauseJobs();
+
+  std::shared_ptr<std::atomic<bool>> ran = std::make_shared<std::atomic<bool>>(false);
+  CJobManager::GetInstance().Submit([ran]() { *ran = true; }, CJob::PRIORITY_LOW_PAUSABLE);
+  Sleep(100);
+  EXPECT_FALSE(*ran);
+
+  CJobManager::GetInstance().UnPauseJobs();
+  for (int i = 0; i < 100 && !*ran; ++i)
+    Sleep(10);
+  EXPECT_TRUE(*ran);
+
+  CJobManager::GetInstance().SetWorkStealing(false);
+}
@@ -668,11 +668,11 @@ bool CVideoDatabase::GetPathsForTvShow(int idShow, std::set<int>& paths)
   return false;
 }
 
-int CVideoDatabase::RunQuery(const std::string &sql)
+int CVideoDatabase::RunQuery(const std::string &sql, bool stream /* = false */)
 {
   unsigned int time = XbmcThreads::SystemClockMillis();
   int rows = -1;
-  if (m_pDS->query(sql))
+  if (stream ? m_pDS->query_stream(sql) : m_pDS->query(sql))
   {
     rows = m_pDS->num_rows();
     if (rows == 0)
@@ -6835,28 +6835,32 @@ bool CVideoDatabase::GetMoviesByWhere(const std::string& strBaseDir, const Filte
 
     strSQL = PrepareSQL(strSQL, !extFilter.fields.empty() ? extFilter.fields.c_str() : "*") + strSQLExtra;
 
-    int iRowsFound = RunQuery(strSQL);
+    // without sorting the rows are used in the order they are returned,
+    // so stream them rather than holding the whole result in memory
+    bool streaming = sortDescription.sortBy == SortByNone;
+    int iRowsFound = RunQuery(strSQL, streaming);
     if (iRowsFound <= 0)
       return iRowsFound == 0;
 
-    // store the total value of items as a property
-    if (total < iRowsFound)
-      total = iRowsFound;
-    items.SetProperty("total", total);
-
     DatabaseResults results;
-    results.reserve(iRowsFound);
-
-    if (!SortUtils::SortFromDataset(sortDescription, MediaTypeMovie, m_pDS, results))
-      return false;
+    if (!streaming)
+    {
+      results.reserve(iRowsFound);
+      if (!SortUtils::SortFromDataset(sortDescription, MediaTypeMovie, m_pDS, results))
+        return false;
+      items.Reserve(results.size());
+    }
 
     // get data from returned rows
-    items.Reserve(results.size());
     const query_data &data = m_pDS->get_result_set().records;
-    for (const auto &i : results)
+    auto i = results.begin();
+    while (streaming ? !m_pDS->eof() : i != results.end())
     {
-      unsigned int targetRow = (unsigned int)i.at(FieldRow).asInteger();
-      const dbiplus::sql_record* const record = data.at(targetRow);
+      const dbiplus::sql_record* record;
+      if (streaming)
+        record = m_pDS->get_sql_record();
+      else
+        record = data.at(static_cast<unsigned int>((i++)->at(FieldRow).asInteger()));
 
       CVideoInfoTag movie = GetDetailsForMovie(record, getDetails);
       if (m_profileManager.GetMasterProfile().getLockMode() == LOCK_MODE_EVERYONE ||
@@ -6873,8 +6877,16 @@ bool CVideoDatabase::GetMoviesByWhere(const std::string& strBaseDir, const Filte
         pItem->SetOverlayImage(CGUIListItem::ICON_OVERLAY_UNWATCHED,movie.GetPlayCount() > 0);
         items.Add(pItem);
       }
+      if (streaming)
+        m_pDS->next();
     }
 
+    // store the total value of items as a property
+    iRowsFound = streaming ? m_pDS->num_rows() : iRowsFound;
+    if (total < iRowsFound)
+      total = iRowsFound;
+    items.SetProperty("total", total);
+
     // cleanup
     m_pDS->close();
     return true;
@@ -7069,29 +7081,34 @@ bool CVideoDatabase::GetEpisodesByWhere(const std::string& strBaseDir, const Fil
 
     strSQL = PrepareSQL(strSQL, !extFilter.fields.empty() ? extFilter.fields.c_str() : "*") + strSQLExtra;
 
-    int iRowsFound = RunQuery(strSQL);
+    // without sorting the rows are used in the order they are returned,
+    // so stream them rather than holding the whole result in memory
+    bool streaming = sorting.sortBy == SortByNone;
+    int iRowsFound = RunQuery(strSQL, streaming);
     if (iRowsFound <= 0)
       return iRowsFound == 0;
 
-    // store the total value of items as a property
-    if (total < iRowsFound)
-      total = iRowsFound;
-    items.SetProperty("total", total);
-
     DatabaseResults results;
-    results.reserve(iRowsFound);
-    if (!SortUtils::SortFromDataset(sorting, MediaTypeEpisode, m_pDS, results))
-      return false;
+    if (!streaming)
+    {
+      results.reserve(iRowsFound);
+      if (!SortUtils::SortFromDataset(sorting, MediaTypeEpisode, m_pDS, results))
+        return false;
+      items.Reserve(results.size());
+    }
 
     // get data from returned rows
-    items.Reserve(results.size());
     CLabelFormatter formatter("%H. %T", "");
 
     const query_data &data = m_pDS->get_result_set().records;
-    for (const auto &i : results)
+    auto i = results.begin();
+    while (streaming ? !m_pDS->eof() : i != results.end())
     {
-      unsigned int targetRow = (unsigned int)i.at(FieldRow).asInteger();
-      const dbiplus::sql_record* const record = data.at(targetRow);
+      const dbiplus::sql_record* record;
+      if (streaming)
+        record = m_pDS->get_sql_record();
+      else
+        record = data.at(static_cast<unsigned int>((i++)->at(FieldRow).asInteger()));
 
       CVideoInfoTag movie = GetDetailsForEpisode(record, getDetails);
       if (m_profileManager.GetMasterProfile().getLockMode() == LOCK_MODE_EVERYONE ||
@@ -7116,8 +7133,16 @@ bool CVideoDatabase::GetEpisodesByWhere(const std::string& strBaseDir, const Fil
         pItem->m_dateTime = movie.m_firstAired;
         items.Add(pItem);
       }
+      if (streaming)
+        m_pDS->next();
     }
 
+    // store the total value of items as a property
+    iRowsFound = streaming ? m_pDS->num_rows() : iRowsFound;
+    if (total < iRowsFound)
+      total = iRowsFound;
+    items.SetProperty("total", total);
+
     // cleanup
     m_pDS->close();
     return true;
@@ -41,7 +41,7 @@ class CGUIDialogProgressBarHandle;
 namespace dbiplus
 {
   class field_value;
-  typedef std::vector<field_value> sql_record;
+  class sql_record;
 }
 
 #ifndef my_offsetof
@@ -969,9 +969,10 @@ private:
   /*! \brief Run a query on the main dataset and return the number of rows
    If no rows are found we close the dataset and return 0.
    \param sql the sql query to run
-   \return the number of rows, -1 for an error.
+   \param stream whether to stream the rows, see dbiplus::Dataset::query_stream. Only the first row is read.
+   \return the number of rows (1 if there are rows when streaming), -1 for an error.
    */
-  int RunQuery(const std::string &sql);
+  int RunQuery(const std::string &sql, bool stream = false);
 
   void AppendIdLinkFilter(const char* field, const char *table, const MediaType& mediaType, const char *view, const char *viewKey, const CUrlOptions::UrlOptions& options, Filter &filter);
   void AppendLinkFilter(const char* field, const char *table, const MediaType& mediaType, const char *view, const char *viewKey, const CUrlOptions::UrlOptions& options, Filter &filter);
@@ -59,6 +59,8 @@
 #include "video/VideoLibraryQueue.h"
 #include "video/VideoThumbLoader.h"
 #include "VideoInfoDownloader.h"
+#include "VideoPathHasher.h"
+#include "threads/SingleLock.h"
 #include "tags/VideoInfoTagLoaderFactory.h"
 
 using namespace XFILE;
@@ -111,6 +113,9 @@ namespace VIDEO
 
       unsigned int tick = XbmcThreads::SystemClockMillis();
 
+      if (!m_pathHasher)
+        m_pathHasher.reset(new CVideoPathHasher(g_advancedSettings.m_videoLibraryHashJobs));
+
       m_database.Open();
 
       m_bCanInterrupt = true;
@@ -147,8 +152,22 @@ namespace VIDEO
           CLog::Log(LOGWARNING, "%s directory '%s' does not exist - skipping scan%s.", __FUNCTION__, CURL::GetRedacted(directory).c_str(), m_bClean ? " and clean" : "");
           m_pathsToScan.erase(m_pathsToScan.begin());
         }
-        else if (!DoScan(directory))
-          bCancelled = true;
+        else
+        {
+          unsigned int scanTick = XbmcThreads::SystemClockMillis();
+          m_pathHasher->ResetStats();
+
+          if (!DoScan(directory))
+            bCancelled = true;
+
+          CLog::Log(LOGDEBUG, "VideoInfoScanner: Hashed %u directories of '%s' in %u ms (scan took %u ms)",
+                    m_pathHasher->GetStatCount(), CURL::GetRedacted(directory).c_str(),
+                    m_pathHasher->GetElapsed(), XbmcThreads::SystemClockMillis() - scanTick);
+        }
+      }
+      {
+        CSingleLock lock(m_prefetchSection);
+        m_prefetchedTimes.clear();
       }
 
       if (!bCancelled)
@@ -384,6 +403,10 @@ namespace VIDEO
     if (m_handle)
       OnDirectoryScanned(strDirectory);
 
+    std::vector<std::string> prefetched;
+    if (settings.recurse > 0 && content != CONTENT_TVSHOWS)
+      prefetched = PrefetchFastHashes(items, regexps);
+
     for (int i = 0; i < items.Size(); ++i)
     {
       CFileItemPtr pItem = items[i];
@@ -401,6 +424,7 @@ namespace VIDEO
         }
       }
     }
+    ForgetFastHashes(prefetched);
     return !m_bStop;
   }
 
@@ -1868,55 +1892,124 @@ namespace VIDEO
   }
 
   std::string CVideoInfoScanner::GetFastHash(const std::string &directory,
-      const std::vector<std::string> &excludes) const
+      const std::vector<std::string> &excludes)
   {
     CDigest digest{CDigest::Type::MD5};
 
     if (excludes.size())
       digest.Update(StringUtils::Join(excludes, "|"));
 
-    struct __stat64 buffer;
-    if (XFILE::CFile::Stat(directory, &buffer) == 0)
+    int64_t time = 0;
     {
-      int64_t time = buffer.st_mtime;
-      if (!time)
-        time = buffer.st_ctime;
-      if (time)
+      CSingleLock lock(m_prefetchSection);
+      auto prefetched = m_prefetchedTimes.find(directory);
+      if (prefetched != m_prefetchedTimes.end())
       {
-        digest.Update((unsigned char *)&time, sizeof(time));
-        return digest.Finalize();
+        time = prefetched->second;
+        m_prefetchedTimes.erase(prefetched);
       }
     }
+    if (!time)
+    {
+      struct __stat64 buffer;
+      if (XFILE::CFile::Stat(directory, &buffer) == 0)
+        time = buffer.st_mtime ? buffer.st_mtime : buffer.st_ctime;
+    }
+
+    if (time)
+    {
+      digest.Update((unsigned char *)&time, sizeof(time));
+      return digest.Finalize();
+    }
     return "";
   }
 
+  std::vector<std::string> CVideoInfoScanner::PrefetchFastHashes(const CFileItemList &items, const std::vector<std::string> &excludes)
+  {
+    std::vector<std::string> folders;
+    if (!g_advancedSettings.m_bVideoLibraryUseFastHash || !m_pathHasher)
+      return folders;
+
+    // the same folders DoScan() returns early for
+    for (int i = 0; i < items.Size(); ++i)
+    {
+      const CFileItemPtr &item = items[i];
+      if (!item->m_bIsFolder || item->IsParentFolder() || item->IsPlayList() || item->IsPlugin())
+        continue;
+      if (CUtil::ExcludeFileOrFolder(item->GetPath(), excludes) || HasNoMedia(item->GetPath()))
+        continue;
+
+      SScanSettings settings;
+      bool foundDirectly = false;
+      ScraperPtr info = m_database.GetScraperForPath(item->GetPath(), settings, foundDirectly);
+      CONTENT_TYPE content = info ? info->Content() : CONTENT_NONE;
+      if ((content != CONTENT_MOVIES && content != CONTENT_MUSICVIDEOS) || (!m_scanAll && settings.noupdate))
+        continue;
+
+      folders.push_back(item->GetPath());
+    }
+
+    // a single folder gains nothing from going through the hasher
+    if (folders.size() < 2)
+    {
+      folders.clear();
+      return folders;
+    }
+
+    std::map<std::string, int64_t> times;
+    if (!m_pathHasher->StatPaths(folders, times, m_bStop))
+    {
+      folders.clear();
+      return folders;
+    }
+
+    CSingleLock lock(m_prefetchSection);
+    m_prefetchedTimes.insert(times.begin(), times.end());
+    return folders;
+  }
+
+  void CVideoInfoScanner::ForgetFastHashes(const std::vector<std::string> &folders)
+  {
+    CSingleLock lock(m_prefetchSection);
+    for (const auto &folder : folders)
+      m_prefetchedTimes.erase(folder);
+  }
+
   std::string CVideoInfoScanner::GetRecursiveFastHash(const std::string &directory,
       const std::vector<std::string> &excludes) const
   {
-    CFileItemList items;
-    items.Add(CFileItemPtr(new CFileItem(directory, true)));
-    CUtil::GetRecursiveDirsListing(directory, items, DIR_FLAG_NO_FILE_DIRS | DIR_FLAG_NO_FILE_INFO);
-
     CDigest digest{CDigest::Type::MD5};
 
     if (excludes.size())
       digest.Update(StringUtils::Join(excludes, "|"));
 
     int64_t time = 0;
-    for (int i=0; i < items.Size(); ++i)
+    if (m_pathHasher)
     {
-      int64_t stat_time = 0;
-      struct __stat64 buffer;
-      if (XFILE::CFile::Stat(items[i]->GetPath(), &buffer) == 0)
+      //! @todo some filesystems may return the mtime/ctime inline, in which case this is
+      //! unnecessarily expensive. Consider supporting Stat() in our directory cache?
+      if (!m_pathHasher->GetRecursiveTime(directory, time, m_bStop))
+        return "";
+    }
+    else
+    {
+      CFileItemList items;
+      items.Add(CFileItemPtr(new CFileItem(directory, true)));
+      CUtil::GetRecursiveDirsListing(directory, items, DIR_FLAG_NO_FILE_DIRS | DIR_FLAG_NO_FILE_INFO);
+
+      for (int i=0; i < items.Size(); ++i)
       {
-        //! @todo some filesystems may return the mtime/ctime inline, in which case this is
-        //! unnecessarily expensive. Consider supporting Stat() in our directory cache?
-        stat_time = buffer.st_mtime ? buffer.st_mtime : buffer.st_ctime;
-        time += stat_time;
-      }
+        int64_t stat_time = 0;
+        struct __stat64 buffer;
+        if (XFILE::CFile::Stat(items[i]->GetPath(), &buffer) == 0)
+        {
+          stat_time = buffer.st_mtime ? buffer.st_mtime : buffer.st_ctime;
+          time += stat_time;
+        }
 
-      if (!stat_time)
-        return "";
+        if (!stat_time)
+          return "";
+      }
     }
 
     if (time)
@@ -20,6 +20,8 @@
 
 #pragma once
 
+#include <map>
+#include <memory>
 #include <set>
 #include <string>
 #include <vector>
@@ -27,6 +29,7 @@
 #include "InfoScanner.h"
 #include "VideoDatabase.h"
 #include "addons/Scraper.h"
+#include "threads/CriticalSection.h"
 
 class CRegExp;
 class CFileItem;
@@ -35,6 +38,7 @@ class CFileItemList;
 namespace VIDEO
 {
   class IVideoInfoTagLoader;
+  class CVideoPathHasher;
 
   typedef struct SScanSettings
   {
@@ -198,7 +202,7 @@ namespace VIDEO
      \param excludes string array of exclude expressions
      \return the md5 hash of the folder"
      */
-    std::string GetFastHash(const std::string &directory, const std::vector<std::string> &excludes) const;
+    std::string GetFastHash(const std::string &directory, const std::vector<std::string> &excludes);
 
     /*! \brief Retrieve a "fast" hash of the given directory recursively (if available)
      Performs a stat() on the directory, and uses modified time to create a "fast"
@@ -212,6 +216,17 @@ namespace VIDEO
      */
     std::string GetRecursiveFastHash(const std::string &directory, const std::vector<std::string> &excludes) const;
 
+    /*! \brief Stat the given folders in parallel ahead of their GetFastHash() calls
+     Folders the scan is going to skip (excluded, .nomedia, no content or no update) are left out.
+     \param items the directory listing whose subfolders are about to be scanned
+     \param excludes string array of exclude expressions
+     \return the folders that were stat'ed, to be passed to ForgetFastHashes() once scanned
+     */
+    std::vector<std::string> PrefetchFastHashes(const CFileItemList &items, const std::vector<std::string> &excludes);
+
+    /*! \brief Drop the prefetched times of the given folders that weren't used */
+    void ForgetFastHashes(const std::vector<std::string> &folders);
+
     /*! \brief Decide whether a folder listing could use the "fast" hash
      Fast hashing can be done whenever the folder contains no scannable subfolders, as the
      fast hash technique uses modified time to determine when folder content changes, which
@@ -240,6 +255,9 @@ namespace VIDEO
 
     bool m_bStop;
     bool m_scanAll;
+    std::unique_ptr<CVideoPathHasher> m_pathHasher;
+    CCriticalSection m_prefetchSection;
+    std::map<std::string, int64_t> m_prefetchedTimes;
     std::string m_strStartDir;
     CVideoDatabase m_database;
     std::set<std::string> m_pathsToCount;
@@ -0,0 +1,232 @@
+/*
+ *      Copyright (C) 2018 Team Kodi
+ *      http://kodi.tv
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this Program; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+
+#include "VideoPathHasher.h"
+
+#include <algorithm>
+
+#include "FileItem.h"
+#include "filesystem/Directory.h"
+#include "filesystem/File.h"
+#include "threads/SingleLock.h"
+#include "threads/SystemClock.h"
+#include "threads/Thread.h"
+#include "utils/log.h"
+
+using namespace XFILE;
+
+namespace VIDEO
+{
+  class CVideoPathHasher::CWorker : public CThread
+  {
+  public:
+    explicit CWorker(CVideoPathHasher &hasher)
+      : CThread("VideoPathHasher"), m_hasher(hasher)
+    {
+      Create();
+    }
+
+    ~CWorker() override
+    {
+      StopThread();
+    }
+
+  protected:
+    void Process() override
+    {
+      Task task;
+      unsigned int generation;
+      while (m_hasher.NextTask(task, generation))
+      {
+        int64_t time = 0;
+        struct __stat64 buffer;
+        if (CFile::Stat(task.path, &buffer) == 0)
+          time = buffer.st_mtime ? buffer.st_mtime : buffer.st_ctime;
+
+        // no point listing the subfolders if the walk is going to fail anyway
+        std::vector<std::string> subFolders;
+        if (task.recurse && time)
+        {
+          CFileItemList items;
+          CDirectory::GetDirectory(task.path, items, "", DIR_FLAG_NO_FILE_DIRS | DIR_FLAG_NO_FILE_INFO);
+          for (const auto &item : items)
+          {
+            if (item->m_bIsFolder && !item->IsPath(".."))
+              subFolders.push_back(item->GetPath());
+          }
+        }
+
+        m_hasher.Complete(task, generation, time, subFolders);
+      }
+    }
+
+  private:
+    CVideoPathHasher &m_hasher;
+  };
+
+  CVideoPathHasher::CVideoPathHasher(unsigned int maxThreads)
+    : m_maxThreads(std::max(maxThreads, 1u))
+  {
+  }
+
+  CVideoPathHasher::~CVideoPathHasher()
+  {
+    {
+      CSingleLock lock(m_resultSection);
+      m_shutdown = true;
+      m_tasks.clear();
+    }
+    m_taskAvailable.notifyAll();
+
+    // waits for directories still being handled
+    m_workers.clear();
+  }
+
+  void CVideoPathHasher::ResetStats()
+  {
+    CSingleLock lock(m_resultSection);
+    m_statCount = 0;
+    m_elapsed = 0;
+  }
+
+  bool CVideoPathHasher::StatPaths(const std::vector<std::string> &paths, std::map<std::string, int64_t> &times, const bool &abort)
+  {
+    if (!Run(paths, false, abort))
+      return false;
+
+    CSingleLock lock(m_resultSection);
+    times.swap(m_times);
+    m_times.clear();
+    return true;
+  }
+
+  bool CVideoPathHasher::GetRecursiveTime(const std::string &directory, int64_t &time, const bool &abort)
+  {
+    std::vector<std::string> root{directory};
+    if (!Run(root, true, abort))
+      return false;
+
+    CSingleLock lock(m_resultSection);
+    time = 0;
+    for (const auto &it : m_times)
+      time += it.second;
+    m_times.clear();
+    return !m_failed && time != 0;
+  }
+
+  bool CVideoPathHasher::Run(const std::vector<std::string> &paths, bool recurse, const bool &abort)
+  {
+    unsigned int start = XbmcThreads::SystemClockMillis();
+    {
+      CSingleLock lock(m_resultSection);
+      ++m_generation;
+      m_pending = 0;
+      m_failed = false;
+      m_times.clear();
+      m_done.Reset();
+
+      for (const auto &path : paths)
+        Queue(path, recurse);
+
+      // threads are only started once there is something to hash
+      while (m_workers.size() < std::min<size_t>(m_maxThreads, m_tasks.size()))
+        m_workers.push_back(std::unique_ptr<CWorker>(new CWorker(*this)));
+
+      if (m_pending == 0)
+        m_done.Set();
+    }
+    m_taskAvailable.notifyAll();
+
+    bool aborted = false;
+    while (!m_done.WaitMSec(100))
+    {
+      if (abort)
+      {
+        aborted = true;
+        break;
+      }
+    }
+
+    CSingleLock lock(m_resultSection);
+    if (aborted)
+    {
+      // anything still in flight belongs to a stale generation and is ignored on completion
+      ++m_generation;
+      m_tasks.clear();
+    }
+    m_elapsed += XbmcThreads::SystemClockMillis() - start;
+    return !aborted;
+  }
+
+  void CVideoPathHasher::Queue(const std::string &path, bool recurse)
+  {
+    // a folder reachable twice (eg. through a link) is only walked once
+    if (!m_times.insert(std::make_pair(path, 0)).second)
+      return;
+
+    m_tasks.push_back(Task{path, recurse});
+    m_pending++;
+  }
+
+  bool CVideoPathHasher::NextTask(Task &task, unsigned int &generation)
+  {
+    CSingleLock lock(m_resultSection);
+    while (!m_shutdown && m_tasks.empty())
+      m_taskAvailable.wait(lock);
+
+    if (m_shutdown)
+      return false;
+
+    task = m_tasks.front();
+    m_tasks.pop_front();
+    generation = m_generation;
+    return true;
+  }
+
+  void CVideoPathHasher::Complete(const Task &task, unsigned int generation, int64_t time, const std::vector<std::string> &subFolders)
+  {
+    bool queued = false;
+    {
+      CSingleLock lock(m_resultSection);
+      if (generation != m_generation)
+        return;
+
+      m_statCount++;
+      m_times[task.path] = time;
+      if (!time && task.recurse)
+        m_failed = true;
+
+      if (!m_failed)
+      {
+        for (const auto &path : subFolders)
+          Queue(path, true);
+        queued = !subFolders.empty();
+      }
+
+      // the children are accounted for before releasing this directory, so we never see a false zero
+      if (--m_pending == 0)
+        m_done.Set();
+    }
+
+    if (queued)
+      m_taskAvailable.notifyAll();
+  }
+}
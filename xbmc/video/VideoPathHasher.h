@@ -0,0 +1,103 @@
+/*
+ *      Copyright (C) 2018 Team Kodi
+ *      http://kodi.tv
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this Program; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+
+#pragma once
+
+#include <deque>
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "threads/Condition.h"
+#include "threads/CriticalSection.h"
+#include "threads/Event.h"
+
+namespace VIDEO
+{
+  /*!
+   \brief Fans directory stat() and traversal for the fast hashes out to a few threads.
+
+   Each directory is handled by one of the hasher's own threads, so the scanner (itself
+   usually running as a job) never waits on work queued behind it in the job manager.
+   Results are combined order independently (summed times, or keyed by path) so the
+   resulting hashes match those of a serial walk.
+   */
+  class CVideoPathHasher
+  {
+  public:
+    explicit CVideoPathHasher(unsigned int maxThreads);
+    ~CVideoPathHasher();
+
+    /*! \brief Stat the given paths in parallel
+     \param paths the directories to stat
+     \param times [out] modified time (or create time if unavailable) per path, 0 if neither is available
+     \param abort flag polled while waiting, aborts the run once set
+     \return false if aborted
+     */
+    bool StatPaths(const std::vector<std::string> &paths, std::map<std::string, int64_t> &times, const bool &abort);
+
+    /*! \brief Sum the modified times of a directory and all its subdirectories
+     \param directory root of the walk
+     \param time [out] sum of the modified (or create) times
+     \param abort flag polled while waiting, aborts the run once set
+     \return false if aborted or any directory had no time available
+     */
+    bool GetRecursiveTime(const std::string &directory, int64_t &time, const bool &abort);
+
+    /*! \brief Number of directories visited since the last call to ResetStats() */
+    unsigned int GetStatCount() const { return m_statCount; }
+    /*! \brief Time in ms spent hashing since the last call to ResetStats() */
+    unsigned int GetElapsed() const { return m_elapsed; }
+    void ResetStats();
+
+  private:
+    class CWorker;
+    struct Task
+    {
+      std::string path;
+      bool recurse;
+    };
+
+    bool Run(const std::vector<std::string> &paths, bool recurse, const bool &abort);
+    void Queue(const std::string &path, bool recurse);
+    /*! \brief Wait for the next directory to handle
+     \return false once the hasher is destroyed
+     */
+    bool NextTask(Task &task, unsigned int &generation);
+    void Complete(const Task &task, unsigned int generation, int64_t time, const std::vector<std::string> &subFolders);
+
+    CCriticalSection m_resultSection;
+    XbmcThreads::ConditionVariable m_taskAvailable;
+    CEvent m_done;
+    std::deque<Task> m_tasks;
+    std::vector<std::unique_ptr<CWorker>> m_workers;
+    unsigned int m_maxThreads;
+    bool m_shutdown = false;
+    unsigned int m_generation = 0;
+    unsigned int m_pending = 0;
+    bool m_failed = false;
+    std::map<std::string, int64_t> m_times;
+
+    unsigned int m_statCount = 0;
+    unsigned int m_elapsed = 0;
+  };
+}
@@ -42,6 +42,7 @@
 #include "dialogs/GUIDialogSmartPlaylistEditor.h"
 #include "favourites/FavouritesService.h"
 #include "filesystem/File.h"
+#include "filesystem/Directory.h"
 #include "filesystem/DirectoryFactory.h"
 #include "filesystem/FileDirectoryFactory.h"
 #include "filesystem/MultiPathDirectory.h"
@@ -64,6 +65,7 @@
 #include "threads/IRunnable.h"
 #include "threads/SystemClock.h"
 #include "utils/FileUtils.h"
+#include "utils/JobManager.h"
 #include "utils/LabelFormatter.h"
 #include "utils/log.h"
 #include "utils/SortUtils.h"
@@ -200,6 +202,13 @@ bool CGUIMediaWindow::OnAction(const CAction &action)
     return true;
   }
 
+  // jumping by letter or to the end needs the whole of a paged listing
+  if (!m_pagedPath.empty() && m_viewControl.HasControl(GetFocusedControlID()) &&
+      (action.GetID() >= KEY_ASCII || action.GetID() == ACTION_LAST_PAGE ||
+       action.GetID() == ACTION_NEXT_LETTER || action.GetID() == ACTION_PREV_LETTER ||
+       (action.GetID() >= ACTION_JUMP_SMS2 && action.GetID() <= ACTION_JUMP_SMS9)))
+    FetchRemainingPages();
+
   if (CGUIWindow::OnAction(action))
     return true;
 
@@ -268,6 +277,7 @@ bool CGUIMediaWindow::OnMessage(CGUIMessage& message)
         m_filter.Reset();
       }
       m_strFilterPath.clear();
+      ClearPaging();
 
       // Call ClearFileItems() after our window has finished doing any WindowClose
       // animations
@@ -332,6 +342,28 @@ bool CGUIMediaWindow::OnMessage(CGUIMessage& message)
     }
     break;
 
+  case GUI_MSG_LOAD_PAGE:
+    {
+      if (m_viewControl.HasControl(message.GetSenderId()))
+      {
+        LoadNextPage();
+        return true;
+      }
+    }
+    break;
+
+  case GUI_MSG_PAGE_LOADED:
+    {
+      // a page fetched for a listing that has been replaced since is dropped
+      if (m_pageLoading && message.GetParam1() == m_pagedGeneration)
+      {
+        m_pageLoading = false;
+        std::shared_ptr<CFileItemList> page = std::static_pointer_cast<CFileItemList>(message.GetItem());
+        AddPage(message.GetParam2() != 0, *page);
+      }
+      return true;
+    }
+
   case GUI_MSG_SETFOCUS:
     {
       if (m_viewControl.HasControl(message.GetControlId()) && m_viewControl.GetCurrentControl() != message.GetControlId())
@@ -727,6 +759,7 @@ bool CGUIMediaWindow::GetDirectory(const std::string &strDirectory, CFileItemLis
   if (!strDirectory.empty() && cachedItems.Load(GetID()))
   {
     items.Assign(cachedItems);
+    ClearPaging();
   }
   else
   {
@@ -735,15 +768,32 @@ bool CGUIMediaWindow::GetDirectory(const std::string &strDirectory, CFileItemLis
     if (strDirectory.empty())
       SetupShares();
 
+    // large listings may be fetched a page at a time
+    std::string pagedPath = GetPagedPath(strDirectory);
+    CURL fetchUrl(pagedPath.empty() ? pathToUrl : CURL(pagedPath));
+
     CFileItemList dirItems;
-    if (!GetDirectoryItems(pathToUrl, dirItems, UseFileDirectories()))
+    if (!GetDirectoryItems(fetchUrl, dirItems, UseFileDirectories()))
       return false;
 
+    ClearPaging();
+    if (!pagedPath.empty())
+    {
+      // keep the paging options out of the path of the listing and the history
+      dirItems.SetPath(strDirectory);
+      if (dirItems.GetProperty("paged").asBoolean())
+      {
+        m_pagedPath = pagedPath;
+        m_pagedCount = dirItems.Size();
+      }
+    }
+
     // assign fetched directory items
     items.Assign(dirItems);
 
     // took over a second, and not normally cached, so cache it
-    if ((XbmcThreads::SystemClockMillis() - time) > 1000  && items.CacheToDiscIfSlow())
+    // (a paged listing is cheap to fetch and incomplete, so it isn't)
+    if ((XbmcThreads::SystemClockMillis() - time) > 1000 && m_pagedPath.empty() && items.CacheToDiscIfSlow())
       items.Save(GetID());
 
     // if these items should replace the current listing, then pop it off the top
@@ -1309,6 +1359,14 @@ void CGUIMediaWindow::RestoreSelectedItemFromHistory()
         return;
       }
     }
+
+    // the item may be further down a paged listing than has been fetched
+    if (!m_pagedPath.empty())
+    {
+      FetchRemainingPages();
+      RestoreSelectedItemFromHistory();
+      return;
+    }
   }
 
   // if we haven't found the selected item, select the first item
@@ -1494,6 +1552,9 @@ bool CGUIMediaWindow::OnPlayAndQueueMedia(const CFileItemPtr &item, std::string
   int iPlaylist = m_guiState->GetPlaylist();
   if (iPlaylist != PLAYLIST_NONE)
   {
+    // queue all of a paged listing, not just the pages fetched so far
+    FetchRemainingPages();
+
     CServiceBroker::GetPlaylistPlayer().ClearPlaylist(iPlaylist);
     CServiceBroker::GetPlaylistPlayer().Reset();
     int mediaToPlay = 0;
@@ -1556,6 +1617,14 @@ bool CGUIMediaWindow::OnPlayAndQueueMedia(const CFileItemPtr &item, std::string
  */
 void CGUIMediaWindow::UpdateFileList()
 {
+  // a paged listing is sorted by its source, so fetch it again in the new order.
+  // Update() keeps the selected item, fetching as much as it takes to find it again
+  if (!m_pagedPath.empty())
+  {
+    Refresh();
+    return;
+  }
+
   int nItem = m_viewControl.GetSelectedItem();
   std::string strSelected;
   if (nItem >= 0)
@@ -1911,8 +1980,100 @@ void CGUIMediaWindow::UpdateFilterPath(const std::string &strDirectory, const CF
   }
 }
 
+void CGUIMediaWindow::ClearPaging()
+{
+  m_pagedPath.clear();
+  m_pageLoading = false;
+  m_pagedGeneration++;
+}
+
+CURL CGUIMediaWindow::GetNextPageUrl(bool remainder) const
+{
+  CURL url(m_pagedPath);
+  url.SetOption("pagestart", StringUtils::Format("%i", m_pagedCount));
+  if (remainder)
+    url.SetOption("pagesize", "0");
+  return url;
+}
+
+bool CGUIMediaWindow::OnPageFetched(bool fetched, CFileItemList &items)
+{
+  if (!fetched || items.IsEmpty())
+  {
+    CLog::Log(LOGDEBUG, "CGUIMediaWindow::OnPageFetched(%s) no more items after %i",
+              CURL::GetRedacted(m_pagedPath).c_str(), m_pagedCount);
+    m_pagedPath.clear();
+    return false;
+  }
+
+  m_pagedCount += items.Size();
+  if (!items.GetProperty("paged").asBoolean())
+    m_pagedPath.clear();
+
+  items.SetPath(m_vecItems->GetPath());
+  OnPrepareFileItems(items);
+  items.FillInDefaultIcons();
+  return true;
+}
+
+void CGUIMediaWindow::LoadNextPage()
+{
+  if (m_pagedPath.empty() || m_pageLoading)
+    return;
+
+  // the query may take a while on a large library, so it doesn't run on the GUI thread
+  m_pageLoading = true;
+  const CURL url(GetNextPageUrl(false));
+  const int windowId = GetID();
+  const int generation = m_pagedGeneration;
+  CJobManager::GetInstance().Submit([url, windowId, generation]()
+  {
+    std::shared_ptr<CFileItemList> page = std::make_shared<CFileItemList>();
+    const bool fetched = XFILE::CDirectory::GetDirectory(url, *page, "", XFILE::DIR_FLAG_DEFAULTS);
+    CGUIMessage msg(GUI_MSG_PAGE_LOADED, windowId, 0, generation, fetched ? 1 : 0, page);
+    CServiceBroker::GetGUI()->GetWindowManager().SendThreadMessage(msg, windowId);
+  }, CJob::PRIORITY_HIGH);
+}
+
+void CGUIMediaWindow::FetchRemainingPages()
+{
+  if (m_pagedPath.empty())
+    return;
+
+  // in one query. a page still being fetched in the background is dropped, as it's part of the rest
+  CFileItemList rest;
+  const bool fetched = m_rootDir.GetDirectory(GetNextPageUrl(true), rest, UseFileDirectories(), false);
+  m_pageLoading = false;
+  m_pagedGeneration++;
+  AddPage(fetched, rest);
+
+  ClearPaging();
+  m_vecItems->SetProperty("paged", false);
+}
+
+void CGUIMediaWindow::AddPage(bool fetched, CFileItemList &page)
+{
+  const bool added = OnPageFetched(fetched, page);
+  m_vecItems->SetProperty("paged", !m_pagedPath.empty());
+  if (!added)
+    return;
+
+  m_unfilteredItems->Append(page);
+
+  // pages arrive in the order of the view, so the list stays sorted by just
+  // adding them at the end, which lets the view keep its place
+  FormatAndSort(page);
+  m_vecItems->Append(page);
+  m_viewControl.SetItems(*m_vecItems);
+  UpdateButtons();
+}
+
 void CGUIMediaWindow::OnFilterItems(const std::string &filter)
 {
+  // filtering needs the whole listing, so fetch the rest of a paged one first
+  if (!filter.empty())
+    FetchRemainingPages();
+
   m_viewControl.Clear();
 
   CFileItemList items;
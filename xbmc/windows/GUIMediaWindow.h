@@ -97,6 +97,37 @@ protected:
   void RestoreControlStates() override;
 
   virtual bool GetDirectory(const std::string &strDirectory, CFileItemList &items);
+  /*! \brief Get the path to fetch a large listing with a page at a time
+   Windows whose directories can return part of a listing override this to add
+   the paging and sorting options of the current view to the path.
+   \param strDirectory Path of the directory to list
+   \return the path to fetch the first page with, or an empty string to fetch the whole listing
+   \sa LoadNextPage
+   */
+  virtual std::string GetPagedPath(const std::string &strDirectory) { return ""; }
+  /*! \brief Get the path fetching the items after the ones fetched so far
+   \param remainder true to fetch all remaining items, false to fetch the next page
+   */
+  CURL GetNextPageUrl(bool remainder) const;
+  /*! \brief Account for and prepare the items fetched from GetNextPageUrl()
+   \param fetched whether fetching the items succeeded
+   \param items [in/out] the fetched items, prepared but not yet formatted or sorted
+   \return true if there were items, false once the whole listing has been fetched
+   \sa GetPagedPath
+   */
+  bool OnPageFetched(bool fetched, CFileItemList &items);
+  /*! \brief Fetch the next page of a paged listing in the background
+   Called when the view control gets close to the end of the items it has. The page
+   is added to the end of the list by AddPage() once it has been fetched.
+   */
+  void LoadNextPage();
+  void AddPage(bool fetched, CFileItemList &page);
+  /*! \brief Fetch all of a paged listing that hasn't been fetched yet, right away
+   For anything that needs the whole listing, like queueing it or jumping by letter.
+   */
+  void FetchRemainingPages();
+  /*! \brief Stop paging the current listing, dropping a page still being fetched */
+  void ClearPaging();
   /*! \brief Retrieves the items from the given path and updates the list
    \param strDirectory The path to the directory to get the items from
    \param updateFilterPath Whether to update the filter path in m_strFilterPath or not
@@ -236,4 +267,9 @@ protected:
    */
   std::string m_strFilterPath;
   bool m_backgroundLoad = false;
+
+  std::string m_pagedPath; ///< path fetching the current listing a page at a time, empty when it has all been fetched
+  int m_pagedCount = 0;    ///< number of items fetched from m_pagedPath so far
+  int m_pagedGeneration = 0; ///< bumped whenever the paged listing is replaced, to drop pages fetched for an old one
+  bool m_pageLoading = false; ///< whether the next page is being fetched in the background
 };
@@ -29,8 +29,13 @@
 #include "guilib/GUIComponent.h"
 #include "guilib/GUIControlFactory.h"
 #include "guilib/GUIFontManager.h"
+#include "GUILargeTextureManager.h"
+#include "TextureCache.h"
 #include "guilib/GUITextLayout.h"
+#include "guilib/GUITextLayoutCache.h"
 #include "guilib/GUIWindowManager.h"
+#include "guilib/GUIWindowXMLCache.h"
+#include "playlists/SmartPlaylistCache.h"
 #include "guilib/GUIControlProfiler.h"
 #include "GUIInfoManager.h"
 #include "ServiceBroker.h"
@@ -124,6 +129,46 @@ void CGUIWindowDebugInfo::Process(unsigned int currentTime, CDirtyRegionList &di
                                 stat.ullAvailPhys/1024, stat.ullTotalPhys/1024, CServiceBroker::GetGUI()->GetInfoManager().GetInfoProviders().GetSystemInfoProvider().GetFPS(),
                                 strCores.c_str(), ucAppName.c_str(), dCPU, profiling.c_str());
 #endif
+
+    uint64_t labelHits, labelRequests;
+    CServiceBroker::GetGUI()->GetInfoManager().GetInfoProviders().GetCacheStats(labelHits, labelRequests);
+    info += StringUtils::Format("\nINFO: versioned labels %2.1f%% of %" PRIu64" cached",
+                                labelRequests ? 100.0 * labelHits / labelRequests : 0.0, labelRequests);
+
+    uint64_t layoutHits, layoutRequests;
+    CGUITextLayoutCache::GetInstance().GetStats(layoutHits, layoutRequests);
+    info += StringUtils::Format("\nTEXT: layouts %2.1f%% of %" PRIu64" cached",
+                                layoutRequests ? 100.0 * layoutHits / layoutRequests : 0.0, layoutRequests);
+
+    uint64_t windowHits, windowRequests;
+    CGUIWindowXMLCache::GetInstance().GetStats(windowHits, windowRequests);
+    info += StringUtils::Format("\nXML: windows %2.1f%% of %" PRIu64" loaded from cache",
+                                windowRequests ? 100.0 * windowHits / windowRequests : 0.0, windowRequests);
+
+    uint64_t playlistHits, playlistRequests, playlistQueries, playlistQueryTime;
+    CSmartPlaylistCache::GetInstance().GetStats(playlistHits, playlistRequests, playlistQueries, playlistQueryTime);
+    info += StringUtils::Format("\nXSP: smart playlists %2.1f%% of %" PRIu64" cached - %" PRIu64" queries %.0f ms avg",
+                                playlistRequests ? 100.0 * playlistHits / playlistRequests : 0.0, playlistRequests,
+                                playlistQueries, playlistQueries ? static_cast<double>(playlistQueryTime) / playlistQueries : 0.0);
+
+    uint64_t frames, missingFrames, missingTiles, prefetched;
+    CServiceBroker::GetGUI()->GetLargeTextureManager().GetPrefetchStats(frames, missingFrames, missingTiles, prefetched);
+    info += StringUtils::Format("\nART: %" PRIu64" of %" PRIu64" list frames showed %" PRIu64" items without artwork - %" PRIu64" images prefetched",
+                                missingFrames, frames, missingTiles, prefetched);
+
+    uint64_t decodedHits, decodedRequests, decodedSize;
+    CTextureCache::GetInstance().GetDecodedStats(decodedHits, decodedRequests, decodedSize);
+    if (decodedRequests)
+      info += StringUtils::Format(" - %2.1f%% of %" PRIu64" loads decoded (%" PRIu64" MB)",
+                                  100.0 * decodedHits / decodedRequests, decodedRequests, decodedSize / (1024 * 1024));
+
+    DirtyRegionStats regionStats = CServiceBroker::GetGUI()->GetWindowManager().GetDirtyRegionStats();
+    uint64_t screenPixels = static_cast<uint64_t>(CServiceBroker::GetWinSystem()->GetGfxContext().GetWidth()) *
+                            CServiceBroker::GetWinSystem()->GetGfxContext().GetHeight();
+    info += StringUtils::Format("\nGUI: %u regions %2.1f%% of screen - %u controls rendered, %u culled - %2.1f%% idle frames",
+                                regionStats.regions, screenPixels ? 100.0 * regionStats.pixels / screenPixels : 0.0,
+                                regionStats.controls, regionStats.culledControls,
+                                regionStats.frames ? 100.0 * regionStats.idleFrames / regionStats.frames : 0.0);
   }
 
   // render the skin debug info